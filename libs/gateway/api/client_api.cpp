@@ -17,6 +17,9 @@
 
 namespace ae::gw {
 ClientApi::ClientApi(ProtocolContext& protocol_context)
-    : ApiClass{protocol_context}, from_server{protocol_context} {}
+    : ApiClass{protocol_context},
+      from_server{protocol_context},
+      from_stream{protocol_context},
+      unknown_stream{protocol_context} {}
 
 }  // namespace ae::gw
@@ -25,6 +25,12 @@ class ClientApi : public ApiClass {
   explicit ClientApi(ProtocolContext& protocol_context);
 
   Method<3, void(ClientId client_id, DataBuffer data)> from_server;
+  Method<4, void(std::uint8_t stream_index, DataBuffer data)> from_stream;
+  /**
+   * \brief The stream index is not bound on the gateway, e.g. it was evicted.
+   * The device binds the index again and resends the data it sent to it.
+   */
+  Method<5, void(std::uint8_t stream_index)> unknown_stream;
 };
 }  // namespace ae::gw
 
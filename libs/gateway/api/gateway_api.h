@@ -31,8 +31,25 @@ class GatewayApi : public ApiClassImpl<GatewayApi> {
   virtual void ToServer(ClientId client_id, ServerEndpoints endpoints,
                         DataBuffer data) = 0;
 
+  /**
+   * \brief Bind device local stream index to client and server.
+   * Bound stream is addressed by ToStream and answered by from_stream, which
+   * saves client and server ids in each frame.
+   */
+  virtual void BindStream(std::uint8_t stream_index, ClientId client_id,
+                          ServerId server_id) = 0;
+
+  virtual void BindStreamEndpoints(std::uint8_t stream_index,
+                                   ClientId client_id,
+                                   ServerEndpoints endpoints) = 0;
+
+  virtual void ToStream(std::uint8_t stream_index, DataBuffer data) = 0;
+
   AE_METHODS(RegMethod<3, &GatewayApi::ToServerId>,
-             RegMethod<4, &GatewayApi::ToServer>);
+             RegMethod<4, &GatewayApi::ToServer>,
+             RegMethod<5, &GatewayApi::BindStream>,
+             RegMethod<6, &GatewayApi::BindStreamEndpoints>,
+             RegMethod<7, &GatewayApi::ToStream>);
 };
 }  // namespace ae::gw
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/arq_link.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace ae::gw {
+ArqLink::DeviceSession::DeviceSession(SelectiveRepeat::Config config)
+    : session{config} {}
+
+ArqLink::ArqLink(ActionContext action_context, ILocalLink& upper,
+                 SelectiveRepeat::Config config)
+    : upper_{&upper},
+      config_{config},
+      retransmit_action_{action_context,
+                         [this](auto now) { return Update(now); }} {
+  upper_output_sub_ = upper_->output_event().Subscribe(
+      [this](auto device_id, auto const& data) { OutData(device_id, data); });
+}
+
+ArqLink::~ArqLink() {
+  for (auto collector : collectors_) {
+    metrics_->RemoveCollector(collector);
+  }
+}
+
+void ArqLink::Input(std::uint8_t device_id, DataBuffer const& data) {
+  Session(device_id).session.Receive(data, Now());
+  // acknowledged frames may free the window for pending data
+  retransmit_action_->Reschedule();
+}
+
+ArqLink::Output::Subscriber ArqLink::output_event() {
+  return EventSubscriber{output_event_};
+}
+
+std::optional<SelectiveRepeat::Stats> ArqLink::stats(
+    std::uint8_t device_id) const {
+  auto it = sessions_.find(device_id);
+  if (it == std::end(sessions_)) {
+    return std::nullopt;
+  }
+  return it->second.session.stats();
+}
+
+ArqLink::DeliveryEvent::Subscriber ArqLink::delivery_event() {
+  return EventSubscriber{delivery_event_};
+}
+
+void ArqLink::SetMetrics(MetricsRegistry& metrics) {
+  metrics_ = &metrics;
+  auto add = [this](auto type, std::string name, std::string const& help,
+                    auto value) {
+    collectors_.push_back(metrics_->AddCollector(
+        type, name, help, [this, name, value](auto& samples) {
+          CollectSessions(samples, name, value);
+        }));
+  };
+  auto to_ms = [](Duration duration) {
+    return static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+            .count());
+  };
+  add(MetricsRegistry::Type::kCounter, "gateway_arq_retransmits_total",
+      "Frames retransmitted to the device", [](auto const& session) {
+        return static_cast<std::int64_t>(session.stats().retransmits);
+      });
+  add(MetricsRegistry::Type::kCounter,
+      "gateway_arq_spurious_retransmits_total",
+      "Retransmissions of frames the device had already received",
+      [](auto const& session) {
+        return static_cast<std::int64_t>(session.stats().spurious_retransmits);
+      });
+  add(MetricsRegistry::Type::kGauge, "gateway_arq_srtt_ms",
+      "Smoothed round trip time to the device", [to_ms](auto const& session) {
+        return to_ms(session.rtt().srtt().value_or(Duration{}));
+      });
+  add(MetricsRegistry::Type::kGauge, "gateway_arq_rto_ms",
+      "Retransmission timeout of the device", [to_ms](auto const& session) {
+        return to_ms(session.rtt().rto());
+      });
+}
+
+template <typename Func>
+void ArqLink::CollectSessions(std::vector<MetricsRegistry::Sample>& samples,
+                              std::string const& name, Func&& value) const {
+  for (auto const& [device_id, device_session] : sessions_) {
+    samples.push_back({name,
+                       Format("device=\"{}\"", static_cast<int>(device_id)),
+                       value(device_session.session)});
+  }
+}
+
+ArqLink::DeviceSession& ArqLink::Session(std::uint8_t device_id) {
+  auto it = sessions_.find(device_id);
+  if (it != std::end(sessions_)) {
+    return it->second;
+  }
+
+  it = sessions_.try_emplace(device_id, config_).first;
+  auto& device_session = it->second;
+  device_session.out_frame_sub =
+      device_session.session.out_frame_event().Subscribe(
+          [this, device_id](auto const& frame) {
+            output_event_.Emit(device_id, frame);
+          });
+  device_session.out_data_sub =
+      device_session.session.out_data_event().Subscribe(
+          [this, device_id](auto const& data) {
+            upper_->Input(device_id, data);
+          });
+  device_session.delivery_sub =
+      device_session.session.delivery_event().Subscribe(
+          [this, device_id](auto delivered) {
+            delivery_event_.Emit(device_id, delivered);
+          });
+  return device_session;
+}
+
+void ArqLink::OutData(std::uint8_t device_id, DataBuffer const& data) {
+  Session(device_id).session.Send(data, Now());
+  retransmit_action_->Reschedule();
+}
+
+TimePoint ArqLink::Update(TimePoint now) {
+  auto next = TimePoint::max();
+  for (auto& [_, device_session] : sessions_) {
+    next = std::min(next, device_session.session.Update(now));
+  }
+  return next;
+}
+}  // namespace ae::gw
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_ARQ_LINK_H_
+#define GATEWAY_ARQ_LINK_H_
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+#include "aether/all.h"
+
+#include "gateway/local_link.h"
+#include "gateway/deadline_action.h"
+#include "gateway/metrics_registry.h"
+#include "gateway/selective_repeat.h"
+
+namespace ae::gw {
+/**
+ * \brief Hop by hop selective repeat ARQ between the gateway and devices.
+ * Radio losses are repaired on the link instead of end to end retransmission
+ * through the cloud.
+ */
+class ArqLink final : public ILocalLink {
+ public:
+  using DeliveryEvent = Event<void(std::uint8_t device_id, bool delivered)>;
+
+  ArqLink(ActionContext action_context, ILocalLink& upper,
+          SelectiveRepeat::Config config);
+  ~ArqLink() override;
+
+  void Input(std::uint8_t device_id, DataBuffer const& data) override;
+  Output::Subscriber output_event() override;
+
+  /**
+   * \brief Retransmission statistics of the session with the device.
+   */
+  std::optional<SelectiveRepeat::Stats> stats(std::uint8_t device_id) const;
+
+  /**
+   * \brief Result of each frame transmission to the device, \see
+   * SelectiveRepeat::delivery_event.
+   */
+  DeliveryEvent::Subscriber delivery_event();
+
+  /**
+   * \brief Report retransmissions and the RTT estimates of each device.
+   */
+  void SetMetrics(MetricsRegistry& metrics);
+
+ private:
+  struct DeviceSession {
+    explicit DeviceSession(SelectiveRepeat::Config config);
+
+    SelectiveRepeat session;
+    Subscription out_frame_sub;
+    Subscription out_data_sub;
+    Subscription delivery_sub;
+  };
+
+  DeviceSession& Session(std::uint8_t device_id);
+  void OutData(std::uint8_t device_id, DataBuffer const& data);
+  TimePoint Update(TimePoint now);
+  template <typename Func>
+  void CollectSessions(std::vector<MetricsRegistry::Sample>& samples,
+                       std::string const& name, Func&& value) const;
+
+  ILocalLink* upper_;
+  SelectiveRepeat::Config config_;
+  Output output_event_;
+  DeliveryEvent delivery_event_;
+  std::map<std::uint8_t, DeviceSession> sessions_;
+  Subscription upper_output_sub_;
+  OwnActionPtr<DeadlineAction> retransmit_action_;
+  MetricsRegistry* metrics_{};
+  std::vector<MetricsRegistry::CollectorId> collectors_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_ARQ_LINK_H_
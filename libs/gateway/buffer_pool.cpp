@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway/buffer_pool.h"
+
+#include <algorithm>
+
+namespace ae::gw {
+BufferPool::BufferPool(Config const& config) : config_{config} {}
+
+BufferPool::OwnerId BufferPool::Open() {
+  auto const owner = next_owner_++;
+  owners_.emplace(owner, Owner{0, false});
+  stats_.owners = owners_.size();
+  return owner;
+}
+
+void BufferPool::Close(OwnerId owner) {
+  auto it = owners_.find(owner);
+  if (it == std::end(owners_)) {
+    return;
+  }
+  if (it->second.used != 0) {
+    // bytes in flight are released later
+    it->second.closed = true;
+    return;
+  }
+  owners_.erase(it);
+  stats_.owners = owners_.size();
+}
+
+bool BufferPool::Acquire(OwnerId owner, std::size_t size) {
+  auto it = owners_.find(owner);
+  if ((it == std::end(owners_)) || it->second.closed) {
+    return false;
+  }
+  auto& entry = it->second;
+  auto const used = stats_.used + size;
+  // the owner becomes active with this charge
+  auto const active = active_owners_ + ((entry.used == 0) ? 1 : 0);
+  auto const share = std::max(config_.min_share, config_.budget / active);
+  auto const within_share = (entry.used + size) <= share;
+  if ((used > config_.budget) || (!within_share && under_pressure_)) {
+    stats_.rejected++;
+    return false;
+  }
+
+  if (entry.used == 0) {
+    active_owners_++;
+  }
+  entry.used += size;
+  stats_.used = used;
+  stats_.peak = std::max(stats_.peak, used);
+  UpdatePressure();
+  return true;
+}
+
+void BufferPool::Release(OwnerId owner, std::size_t size) {
+  auto it = owners_.find(owner);
+  if (it == std::end(owners_)) {
+    return;
+  }
+  auto& entry = it->second;
+  size = std::min(size, entry.used);
+  entry.used -= size;
+  stats_.used -= size;
+  if ((entry.used == 0) && (size != 0)) {
+    active_owners_--;
+    if (entry.closed) {
+      owners_.erase(it);
+      stats_.owners = owners_.size();
+    }
+  }
+  UpdatePressure();
+}
+
+std::size_t BufferPool::fair_share() const {
+  return std::max(config_.min_share,
+                  config_.budget / std::max<std::size_t>(active_owners_, 1));
+}
+
+std::size_t BufferPool::used(OwnerId owner) const {
+  auto it = owners_.find(owner);
+  return (it != std::end(owners_)) ? it->second.used : 0;
+}
+
+bool BufferPool::under_pressure() const { return under_pressure_; }
+
+BufferPool::Stats const& BufferPool::stats() const { return stats_; }
+
+BufferPool::PressureEvent::Subscriber BufferPool::pressure_event() {
+  return EventSubscriber{pressure_event_};
+}
+
+void BufferPool::UpdatePressure() {
+  auto const percent = (stats_.used * 100) / std::max<std::size_t>(
+                                                  config_.budget, 1);
+  if (!under_pressure_ && (percent >= config_.high_watermark)) {
+    under_pressure_ = true;
+    AE_TELED_WARNING("Buffer pool is under pressure, {} of {} bytes used",
+                     stats_.used, config_.budget);
+    pressure_event_.Emit(true);
+  } else if (under_pressure_ && (percent < config_.low_watermark)) {
+    under_pressure_ = false;
+    pressure_event_.Emit(false);
+  }
+}
+}  // namespace ae::gw
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_BUFFER_POOL_H_
+#define GATEWAY_BUFFER_POOL_H_
+
+#include <map>
+#include <cstdint>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief Gateway wide budget of buffered bytes shared by the streams.
+ * Bytes are charged to an owner while they are buffered and released when
+ * they are written out, so memory follows the bytes in flight instead of a
+ * capacity reserved for each stream. An owner may always fill its fair share,
+ * the budget divided by the owners holding bytes, and borrow the free budget
+ * above it while the pool is not under pressure. Pressure starts when the
+ * used bytes reach the high watermark and ends below the low watermark.
+ */
+class BufferPool {
+ public:
+  using OwnerId = std::uint32_t;
+  using PressureEvent = Event<void(bool under_pressure)>;
+
+  struct Config {
+    std::size_t budget;
+    // percents of the budget
+    std::uint8_t high_watermark;
+    std::uint8_t low_watermark;
+    // fair share is never less, so an owner can buffer at least a packet
+    std::size_t min_share;
+  };
+
+#if defined(ESP_PLATFORM)
+  static constexpr Config kDefaultConfig{64 * 1024, 80, 60, 1024};
+#else
+  static constexpr Config kDefaultConfig{16 * 1024 * 1024, 80, 60, 4096};
+#endif
+
+  struct Stats {
+    std::size_t used;
+    std::size_t peak;
+    std::size_t owners;
+    std::size_t rejected;
+  };
+
+  explicit BufferPool(Config const& config = kDefaultConfig);
+
+  OwnerId Open();
+  /**
+   * \brief Owner is forgotten after all its bytes are released.
+   */
+  void Close(OwnerId owner);
+
+  /**
+   * \brief Charge size bytes to the owner, false if it's over the limits.
+   */
+  bool Acquire(OwnerId owner, std::size_t size);
+  void Release(OwnerId owner, std::size_t size);
+
+  /**
+   * \brief Bytes charged to the owner.
+   */
+  std::size_t used(OwnerId owner) const;
+  std::size_t fair_share() const;
+  bool under_pressure() const;
+  Stats const& stats() const;
+  PressureEvent::Subscriber pressure_event();
+
+ private:
+  struct Owner {
+    std::size_t used;
+    bool closed;
+  };
+
+  void UpdatePressure();
+
+  Config config_;
+  OwnerId next_owner_{};
+  std::map<OwnerId, Owner> owners_;
+  // owners holding bytes
+  std::size_t active_owners_{};
+  bool under_pressure_{};
+  Stats stats_{};
+  PressureEvent pressure_event_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_BUFFER_POOL_H_
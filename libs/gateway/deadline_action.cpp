@@ -0,0 +1,34 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/deadline_action.h"
+
+#include <utility>
+
+namespace ae::gw {
+DeadlineAction::DeadlineAction(ActionContext action_context, Handler handler)
+    : Action{action_context}, handler_{std::move(handler)} {}
+
+UpdateStatus DeadlineAction::Update() {
+  auto next = handler_(Now());
+  if (next == TimePoint::max()) {
+    return {};
+  }
+  return UpdateStatus::Delay(next);
+}
+
+void DeadlineAction::Reschedule() { Action::Trigger(); }
+}  // namespace ae::gw
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_DEADLINE_ACTION_H_
+#define GATEWAY_DEADLINE_ACTION_H_
+
+#include <functional>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief Calls handler at the deadline returned by the previous call.
+ * Handler returns TimePoint::max() if there is nothing to wait for, use
+ * Reschedule to call handler again after the state is changed.
+ */
+class DeadlineAction final : public Action<DeadlineAction> {
+ public:
+  using Handler = std::function<TimePoint(TimePoint now)>;
+
+  DeadlineAction(ActionContext action_context, Handler handler);
+
+  UpdateStatus Update();
+  void Reschedule();
+
+ private:
+  Handler handler_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_DEADLINE_ACTION_H_
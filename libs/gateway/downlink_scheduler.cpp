@@ -0,0 +1,151 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/downlink_scheduler.h"
+
+#include <algorithm>
+
+namespace ae::gw {
+DownlinkScheduler::DownlinkScheduler(ActionContext action_context,
+                                     ILocalLink& upper, Config config)
+    : upper_{&upper},
+      config_{config},
+      window_action_{action_context, [this](auto now) { return Update(now); }} {
+  upper_output_sub_ = upper_->output_event().Subscribe(
+      [this](auto device_id, auto const& data) { OutData(device_id, data); });
+}
+
+void DownlinkScheduler::SetAlwaysListening(std::uint8_t device_id,
+                                           bool always_listening) {
+  devices_[device_id].always_listening = always_listening;
+  window_action_->Reschedule();
+}
+
+std::optional<TimePoint> DownlinkScheduler::NextWindow(
+    std::uint8_t device_id) const {
+  auto it = devices_.find(device_id);
+  if ((it == std::end(devices_)) || !it->second.last_uplink ||
+      !it->second.uplink_period) {
+    return std::nullopt;
+  }
+  return *it->second.last_uplink + *it->second.uplink_period +
+         config_.rx_delay;
+}
+
+void DownlinkScheduler::Input(std::uint8_t device_id, DataBuffer const& data) {
+  auto const now = Now();
+  auto& device = devices_[device_id];
+  if (device.last_uplink) {
+    // learn the device uplink period
+    auto period =
+        std::chrono::duration_cast<Duration>(now - *device.last_uplink);
+    if (device.uplink_period) {
+      device.uplink_period = (*device.uplink_period * 7 + period) / 8;
+    } else {
+      device.uplink_period = period;
+    }
+  }
+  device.last_uplink = now;
+  // the window opens after rx_delay
+  window_action_->Reschedule();
+
+  upper_->Input(device_id, data);
+}
+
+DownlinkScheduler::Output::Subscriber DownlinkScheduler::output_event() {
+  return EventSubscriber{output_event_};
+}
+
+void DownlinkScheduler::OutData(std::uint8_t device_id,
+                                DataBuffer const& data) {
+  auto const now = Now();
+  auto& device = devices_[device_id];
+  if (device.always_listening || IsWindowOpen(device, now)) {
+    output_event_.Emit(device_id, data);
+    return;
+  }
+
+  DropExpired(device, now);
+  // the device is not expected to listen before the message expires
+  auto const expires = now + config_.message_ttl;
+  auto const next_window = NextWindow(device_id);
+  if (next_window && (*next_window >= expires)) {
+    AE_TELED_WARNING(
+        "Downlink for device {} expires before its next receive window, drop",
+        static_cast<int>(device_id));
+    return;
+  }
+  if (device.queue.size() >= config_.max_queue_size) {
+    AE_TELED_ERROR("Downlink queue overflow for device {}, drop the oldest",
+                   static_cast<int>(device_id));
+    device.queue.pop_front();
+  }
+  device.queue.push_back(Pending{expires, data});
+}
+
+bool DownlinkScheduler::IsWindowOpen(DeviceState const& device,
+                                     TimePoint now) const {
+  if (!device.last_uplink) {
+    return false;
+  }
+  auto const open = *device.last_uplink + config_.rx_delay;
+  return (open <= now) && (now < (open + config_.rx_window));
+}
+
+void DownlinkScheduler::Flush(std::uint8_t device_id, DeviceState& device,
+                              TimePoint now) {
+  DropExpired(device, now);
+  while (!device.queue.empty()) {
+    auto pending = std::move(device.queue.front());
+    device.queue.pop_front();
+    output_event_.Emit(device_id, pending.data);
+  }
+}
+
+void DownlinkScheduler::DropExpired(DeviceState& device, TimePoint now) {
+  auto const size = device.queue.size();
+  device.queue.erase(
+      std::remove_if(std::begin(device.queue), std::end(device.queue),
+                     [now](auto const& p) { return p.expires <= now; }),
+      std::end(device.queue));
+  if (size != device.queue.size()) {
+    AE_TELED_DEBUG("Dropped {} expired downlink messages",
+                   size - device.queue.size());
+  }
+}
+
+TimePoint DownlinkScheduler::Update(TimePoint now) {
+  auto next = TimePoint::max();
+  for (auto& [device_id, device] : devices_) {
+    if (device.queue.empty()) {
+      continue;
+    }
+    if (device.always_listening || IsWindowOpen(device, now)) {
+      Flush(device_id, device, now);
+      continue;
+    }
+    DropExpired(device, now);
+    if (device.queue.empty() || !device.last_uplink) {
+      continue;
+    }
+    auto const open = *device.last_uplink + config_.rx_delay;
+    if (open > now) {
+      next = std::min(next, open);
+    }
+  }
+  return next;
+}
+}  // namespace ae::gw
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_DOWNLINK_SCHEDULER_H_
+#define GATEWAY_DOWNLINK_SCHEDULER_H_
+
+#include <map>
+#include <deque>
+#include <cstdint>
+#include <optional>
+
+#include "aether/all.h"
+
+#include "gateway/local_link.h"
+#include "gateway/deadline_action.h"
+
+namespace ae::gw {
+/**
+ * \brief Holds downlink to sleeping devices until their receive window.
+ * A device opens the receive window rx_delay after each uplink and listens
+ * for rx_window. All pending messages are sent back to back when the window
+ * opens, messages arrived while the window is open are sent immediately.
+ * The next window is predicted from the learned uplink period, messages
+ * expiring before it are dropped instead of being held.
+ */
+class DownlinkScheduler final : public ILocalLink {
+ public:
+  struct Config {
+    Duration rx_delay;
+    Duration rx_window;
+    Duration message_ttl;
+    std::size_t max_queue_size;
+  };
+
+  DownlinkScheduler(ActionContext action_context, ILocalLink& upper,
+                    Config config);
+
+  /**
+   * \brief Mark device as always listening, its downlink is not scheduled.
+   */
+  void SetAlwaysListening(std::uint8_t device_id, bool always_listening);
+
+  /**
+   * \brief Predicted time of the next receive window based on uplink period.
+   */
+  std::optional<TimePoint> NextWindow(std::uint8_t device_id) const;
+
+  void Input(std::uint8_t device_id, DataBuffer const& data) override;
+  Output::Subscriber output_event() override;
+
+ private:
+  struct Pending {
+    TimePoint expires;
+    DataBuffer data;
+  };
+
+  struct DeviceState {
+    bool always_listening{false};
+    std::optional<TimePoint> last_uplink;
+    std::optional<Duration> uplink_period;
+    std::deque<Pending> queue;
+  };
+
+  void OutData(std::uint8_t device_id, DataBuffer const& data);
+  bool IsWindowOpen(DeviceState const& device, TimePoint now) const;
+  void Flush(std::uint8_t device_id, DeviceState& device, TimePoint now);
+  void DropExpired(DeviceState& device, TimePoint now);
+  TimePoint Update(TimePoint now);
+
+  ILocalLink* upper_;
+  Config config_;
+  Output output_event_;
+  std::map<std::uint8_t, DeviceState> devices_;
+  Subscription upper_output_sub_;
+  OwnActionPtr<DeadlineAction> window_action_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_DOWNLINK_SCHEDULER_H_
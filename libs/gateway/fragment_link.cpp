@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/fragment_link.h"
+
+#include <utility>
+
+namespace ae::gw {
+FragmentLink::FragmentLink(ILocalLink& upper, Config config)
+    : upper_{&upper}, config_{config} {
+  upper_output_sub_ = upper_->output_event().Subscribe(
+      [this](auto device_id, auto const& data) { OutData(device_id, data); });
+}
+
+void FragmentLink::SetMtu(std::uint8_t device_id, std::uint16_t mtu) {
+  Device(device_id).mtu = mtu;
+}
+
+void FragmentLink::Input(std::uint8_t device_id, DataBuffer const& data) {
+  auto frame = Device(device_id).reassembler.Push(data, Now());
+  if (!frame) {
+    return;
+  }
+  upper_->Input(device_id, *frame);
+}
+
+FragmentLink::Output::Subscriber FragmentLink::output_event() {
+  return EventSubscriber{output_event_};
+}
+
+FragmentLink::DeviceState& FragmentLink::Device(std::uint8_t device_id) {
+  auto it = devices_.find(device_id);
+  if (it == std::end(devices_)) {
+    it = devices_
+             .emplace(device_id,
+                      DeviceState{config_.mtu, Fragmenter{},
+                                  Reassembler{config_.reassembly_limits}})
+             .first;
+  }
+  return it->second;
+}
+
+void FragmentLink::OutData(std::uint8_t device_id, DataBuffer const& data) {
+  auto& device = Device(device_id);
+  auto fragments = device.fragmenter.Split(data, device.mtu);
+  if (fragments.empty()) {
+    AE_TELED_ERROR("Unable to fragment data for device {}",
+                   static_cast<int>(device_id));
+    return;
+  }
+  for (auto const& fragment : fragments) {
+    output_event_.Emit(device_id, fragment);
+  }
+}
+}  // namespace ae::gw
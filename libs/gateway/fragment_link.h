@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_FRAGMENT_LINK_H_
+#define GATEWAY_FRAGMENT_LINK_H_
+
+#include <map>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "gateway/local_link.h"
+#include "gateway/fragmentation.h"
+
+namespace ae::gw {
+/**
+ * \brief Link splits frames to the device link MTU and reassembles fragments
+ * received from devices.
+ */
+class FragmentLink final : public ILocalLink {
+ public:
+  struct Config {
+    std::uint16_t mtu;
+    Reassembler::Limits reassembly_limits;
+  };
+
+  FragmentLink(ILocalLink& upper, Config config);
+
+  /**
+   * \brief Set MTU for the link to exact device
+   */
+  void SetMtu(std::uint8_t device_id, std::uint16_t mtu);
+
+  void Input(std::uint8_t device_id, DataBuffer const& data) override;
+  Output::Subscriber output_event() override;
+
+ private:
+  struct DeviceState {
+    std::uint16_t mtu;
+    Fragmenter fragmenter;
+    Reassembler reassembler;
+  };
+
+  DeviceState& Device(std::uint8_t device_id);
+  void OutData(std::uint8_t device_id, DataBuffer const& data);
+
+  ILocalLink* upper_;
+  Config config_;
+  Output output_event_;
+  std::map<std::uint8_t, DeviceState> devices_;
+  Subscription upper_output_sub_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_FRAGMENT_LINK_H_
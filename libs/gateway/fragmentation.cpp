@@ -0,0 +1,203 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/fragmentation.h"
+
+#include <algorithm>
+
+namespace ae::gw {
+static constexpr std::uint8_t kFragmentFlag = 0x80;
+static constexpr std::uint8_t kLastFlag = 0x80;
+static constexpr std::uint8_t kValueMask = 0x7F;
+
+std::vector<DataBuffer> Fragmenter::Split(DataBuffer const& data,
+                                          std::uint16_t mtu) {
+  if ((data.size() + kWholeHeaderSize) <= mtu) {
+    auto frame = DataBuffer{};
+    frame.reserve(data.size() + kWholeHeaderSize);
+    frame.push_back(0);
+    frame.insert(std::end(frame), std::begin(data), std::end(data));
+    return {std::move(frame)};
+  }
+
+  if (mtu <= kFragmentHeaderSize) {
+    AE_TELED_ERROR("MTU {} is too small for fragmentation", mtu);
+    return {};
+  }
+  auto const chunk_size = static_cast<std::size_t>(mtu) - kFragmentHeaderSize;
+  auto const count = (data.size() + chunk_size - 1) / chunk_size;
+  if (count > kMaxFragments) {
+    AE_TELED_ERROR("Data size {} is too big for MTU {}", data.size(), mtu);
+    return {};
+  }
+
+  auto const message_id =
+      static_cast<std::uint8_t>(next_message_id_++ & kValueMask);
+
+  std::vector<DataBuffer> fragments;
+  fragments.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto const begin = i * chunk_size;
+    auto const end = std::min(begin + chunk_size, data.size());
+    auto index = static_cast<std::uint8_t>(i);
+    if (i == (count - 1)) {
+      index |= kLastFlag;
+    }
+
+    auto& fragment = fragments.emplace_back();
+    fragment.reserve(kFragmentHeaderSize + (end - begin));
+    fragment.push_back(kFragmentFlag | message_id);
+    fragment.push_back(index);
+    fragment.insert(std::end(fragment),
+                    std::begin(data) + static_cast<std::ptrdiff_t>(begin),
+                    std::begin(data) + static_cast<std::ptrdiff_t>(end));
+  }
+  return fragments;
+}
+
+Reassembler::Reassembler(Limits limits) : limits_{limits} {}
+
+std::optional<DataBuffer> Reassembler::Push(DataBuffer const& frame,
+                                            TimePoint now) {
+  if (frame.empty()) {
+    return std::nullopt;
+  }
+  if ((frame[0] & kFragmentFlag) == 0) {
+    if (frame[0] != 0) {
+      AE_TELED_ERROR("Unknown frame header {}", static_cast<int>(frame[0]));
+      return std::nullopt;
+    }
+    return DataBuffer{std::begin(frame) + Fragmenter::kWholeHeaderSize,
+                      std::end(frame)};
+  }
+  if (frame.size() <= Fragmenter::kFragmentHeaderSize) {
+    AE_TELED_ERROR("Fragment is too short");
+    return std::nullopt;
+  }
+
+  DropExpired(now);
+
+  auto const message_id = static_cast<std::uint8_t>(frame[0] & kValueMask);
+  auto const index = static_cast<std::size_t>(frame[1] & kValueMask);
+  auto const last = (frame[1] & kLastFlag) != 0;
+  auto const size = frame.size() - Fragmenter::kFragmentHeaderSize;
+
+  if (size > limits_.max_size) {
+    AE_TELED_ERROR("Fragment size {} exceeds reassembly limit", size);
+    return std::nullopt;
+  }
+
+  auto it = partials_.find(message_id);
+  if ((it != std::end(partials_)) && (it->second.total != 0)) {
+    auto const total = it->second.total;
+    if ((index >= total) || (last && ((index + 1) != total))) {
+      // fragment of another message with the reused id
+      Drop(it);
+      it = std::end(partials_);
+    }
+  }
+
+  if (it == std::end(partials_)) {
+    if (partials_.size() >= limits_.max_messages) {
+      DropOldest();
+    }
+    it = partials_.emplace(message_id, Partial{now, {}, 0, 0, 0}).first;
+  }
+
+  auto& partial = it->second;
+  if (partial.fragments.size() <= index) {
+    partial.fragments.resize(index + 1);
+  }
+  if (!partial.fragments[index].empty()) {
+    // duplicate
+    return std::nullopt;
+  }
+
+  while ((size_ + size) > limits_.max_size) {
+    // do not drop the message which is collected now
+    auto oldest = std::min_element(
+        std::begin(partials_), std::end(partials_),
+        [&](auto const& left, auto const& right) {
+          if (left.first == message_id) {
+            return false;
+          }
+          if (right.first == message_id) {
+            return true;
+          }
+          return left.second.started < right.second.started;
+        });
+    if (oldest->first == message_id) {
+      AE_TELED_ERROR("Reassembly memory limit reached, drop message {}",
+                     static_cast<int>(message_id));
+      Drop(it);
+      return std::nullopt;
+    }
+    Drop(oldest);
+  }
+
+  partial.fragments[index].assign(
+      std::begin(frame) + Fragmenter::kFragmentHeaderSize, std::end(frame));
+  partial.received++;
+  partial.size += size;
+  size_ += size;
+  if (last) {
+    partial.total = index + 1;
+  }
+
+  if ((partial.total == 0) || (partial.received != partial.total)) {
+    return std::nullopt;
+  }
+
+  auto data = DataBuffer{};
+  data.reserve(partial.size);
+  for (auto const& fragment : partial.fragments) {
+    data.insert(std::end(data), std::begin(fragment), std::end(fragment));
+  }
+  Drop(it);
+  return data;
+}
+
+void Reassembler::DropExpired(TimePoint now) {
+  for (auto it = std::begin(partials_); it != std::end(partials_);) {
+    if ((now - it->second.started) > limits_.timeout) {
+      AE_TELED_DEBUG("Reassembly timeout for message {}",
+                     static_cast<int>(it->first));
+      auto expired = it++;
+      Drop(expired);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool Reassembler::DropOldest() {
+  if (partials_.empty()) {
+    return false;
+  }
+  auto oldest = std::min_element(std::begin(partials_), std::end(partials_),
+                                 [](auto const& left, auto const& right) {
+                                   return left.second.started <
+                                          right.second.started;
+                                 });
+  Drop(oldest);
+  return true;
+}
+
+void Reassembler::Drop(std::map<std::uint8_t, Partial>::iterator it) {
+  size_ -= it->second.size;
+  partials_.erase(it);
+}
+}  // namespace ae::gw
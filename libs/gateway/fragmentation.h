@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_FRAGMENTATION_H_
+#define GATEWAY_FRAGMENTATION_H_
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief Frame fragmentation for MTU limited device links.
+ * Frame fits into MTU is sent with one byte header 0x00.
+ * Fragment has two bytes header 1mmmmmmm liiiiiii, where m is the message id,
+ * l is the last fragment flag and i is the fragment index.
+ */
+class Fragmenter {
+ public:
+  static constexpr std::size_t kWholeHeaderSize = 1;
+  static constexpr std::size_t kFragmentHeaderSize = 2;
+  static constexpr std::size_t kMaxFragments = 128;
+
+  /**
+   * \brief Split data into frames not larger than mtu.
+   * \return List of frames or empty list if data is not possible to split.
+   */
+  std::vector<DataBuffer> Split(DataBuffer const& data, std::uint16_t mtu);
+
+ private:
+  std::uint8_t next_message_id_{};
+};
+
+/**
+ * \brief Collects fragments made by Fragmenter back to the frames.
+ * Memory used by incomplete messages is limited by max_size and max_messages,
+ * the oldest incomplete message is dropped first.
+ */
+class Reassembler {
+ public:
+  struct Limits {
+    Duration timeout;
+    std::size_t max_size;
+    std::size_t max_messages;
+  };
+
+  explicit Reassembler(Limits limits);
+
+  /**
+   * \brief Push received frame.
+   * \return Whole frame if it's complete.
+   */
+  std::optional<DataBuffer> Push(DataBuffer const& frame, TimePoint now);
+
+ private:
+  struct Partial {
+    TimePoint started;
+    std::vector<DataBuffer> fragments;
+    std::size_t received;
+    std::size_t total;
+    std::size_t size;
+  };
+
+  void DropExpired(TimePoint now);
+  bool DropOldest();
+  void Drop(std::map<std::uint8_t, Partial>::iterator it);
+
+  Limits limits_;
+  std::map<std::uint8_t, Partial> partials_;
+  std::size_t size_{};
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_FRAGMENTATION_H_
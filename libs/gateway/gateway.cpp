@@ -39,4 +39,32 @@ LocalPort& Gateway::local_port() {
 
 GatewayCloud& Gateway::gateway_cloud() { return *gateway_cloud_; }
 
+BufferPool& Gateway::buffer_pool() {
+  if (!buffer_pool_) {
+    buffer_pool_ = std::make_unique<BufferPool>();
+  }
+  return *buffer_pool_;
+}
+
+LatencyTracer& Gateway::latency_tracer() {
+  if (!latency_tracer_) {
+    latency_tracer_ = std::make_unique<LatencyTracer>();
+  }
+  return *latency_tracer_;
+}
+
+MetricsRegistry& Gateway::metrics() {
+  if (!metrics_) {
+    metrics_ = std::make_unique<MetricsRegistry>();
+  }
+  return *metrics_;
+}
+
+TraceRing& Gateway::trace_ring() {
+  if (!trace_ring_) {
+    trace_ring_ = std::make_unique<TraceRing>();
+  }
+  return *trace_ring_;
+}
+
 }  // namespace ae::gw
@@ -20,7 +20,11 @@
 #include "aether/all.h"
 
 #include "gateway/local_port.h"
+#include "gateway/buffer_pool.h"
 #include "gateway/gateway_cloud.h"
+#include "gateway/latency_tracer.h"
+#include "gateway/metrics_registry.h"
+#include "gateway/trace_ring.h"
 #include "gateway/server_stream_manager.h"
 
 namespace ae::gw {
@@ -39,12 +43,33 @@ class Gateway : public Obj {
   ServerStreamManager& server_stream_manager();
   LocalPort& local_port();
   GatewayCloud& gateway_cloud();
+  /**
+   * \brief Budget of the bytes buffered by the streams.
+   */
+  BufferPool& buffer_pool();
+  /**
+   * \brief Latency histograms of the packet stages.
+   */
+  LatencyTracer& latency_tracer();
+  /**
+   * \brief Counters and gauges of the gateway, the streams and the radio.
+   */
+  MetricsRegistry& metrics();
+  /**
+   * \brief Binary trace of the forwarded packets.
+   */
+  TraceRing& trace_ring();
 
   Aether::ptr aether;
   Client::ptr gateway_client;
 
  private:
   GatewayCloud::ptr gateway_cloud_;
+  // the metrics, the pool and the tracers outlive the streams using them
+  std::unique_ptr<MetricsRegistry> metrics_;
+  std::unique_ptr<BufferPool> buffer_pool_;
+  std::unique_ptr<LatencyTracer> latency_tracer_;
+  std::unique_ptr<TraceRing> trace_ring_;
   std::unique_ptr<ServerStreamManager> server_stream_manager_;
   std::unique_ptr<LocalPort> local_port_;
 };
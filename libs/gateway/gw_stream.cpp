@@ -16,18 +16,30 @@
 
 #include "gateway/gw_stream.h"
 
+#include <utility>
+
 #include "gateway/gateway.h"
 #include "gateway/server_stream_manager.h"
 
 namespace ae::gw {
+namespace gw_stream_internal {
+/**
+ * \brief Write rejected because the buffer pool is over the limits.
+ */
+class RejectedWriteAction final : public StreamWriteAction {
+ public:
+  explicit RejectedWriteAction(ActionContext action_context)
+      : StreamWriteAction{action_context} {
+    state_ = State::kFailed;
+  }
+};
+}  // namespace gw_stream_internal
+
 GwStream::GwStream(Gateway& gateway, ServerId server_id) : GwStream{gateway} {
   // TODO: add policy to select cache stream or not
   auto get_stream_action = gateway.server_stream_manager().GetStream(server_id);
   get_sererver_stream_sub_ = get_stream_action->StatusEvent().Subscribe(
-      OnResult{[this](auto const& action) {
-        server_stream_ = action.stream();
-        Tie(buffer_stream_, *server_stream_);
-      }});
+      OnResult{[this](auto const& action) { Connected(action.stream()); }});
 }
 
 GwStream::GwStream(Gateway& gateway, ServerEndpoints const& endpoints)
@@ -36,17 +48,40 @@ GwStream::GwStream(Gateway& gateway, ServerEndpoints const& endpoints)
       // TODO: add policy to select cache stream or not
       gateway.server_stream_manager().GetStream(endpoints);
   get_sererver_stream_sub_ = get_stream_action->StatusEvent().Subscribe(
-      OnResult{[this](auto const& action) {
-        server_stream_ = action.stream();
-        Tie(buffer_stream_, *server_stream_);
-      }});
+      OnResult{[this](auto const& action) { Connected(action.stream()); }});
 }
 
 GwStream::GwStream(Gateway& gateway)
-    : gateway_{&gateway}, buffer_stream_{*gateway_} {}
+    : gateway_{&gateway},
+      buffer_pool_{&gateway_->buffer_pool()},
+      buffer_owner_{buffer_pool_->Open()},
+      latency_tracer_{&gateway_->latency_tracer()},
+      buffer_stream_{*gateway_} {}
+
+GwStream::~GwStream() { buffer_pool_->Close(buffer_owner_); }
 
 ActionPtr<StreamWriteAction> GwStream::Write(DataBuffer&& data) {
-  return buffer_stream_.Write(std::move(data));
+  auto const size = data.size();
+  if (!buffer_pool_->Acquire(buffer_owner_, size)) {
+    AE_TELED_WARNING("Buffer pool limit, drop {} bytes", size);
+    return ActionPtr<gw_stream_internal::RejectedWriteAction>{*gateway_};
+  }
+  auto const written_at = Now();
+  if (!server_stream_) {
+    pre_connect_writes_.push_back(written_at);
+  }
+  auto write_action = buffer_stream_.Write(std::move(data));
+  // the pool outlives the streams, the write may outlive this stream
+  auto release = [pool{buffer_pool_}, owner{buffer_owner_}, size]() {
+    pool->Release(owner, size);
+  };
+  write_action->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[release, tracer{latency_tracer_}, written_at]() {
+        tracer->Record(LatencyStage::kStreamWrite, Now() - written_at);
+        release();
+      }},
+      OnError{release}, OnStop{release}});
+  return write_action;
 }
 
 GwStream::StreamUpdateEvent::Subscriber GwStream::stream_update_event() {
@@ -63,4 +98,19 @@ GwStream::OutDataEvent::Subscriber GwStream::out_data_event() {
 
 void GwStream::Restream() { buffer_stream_.Restream(); }
 
+std::size_t GwStream::buffered_bytes() const {
+  return buffer_pool_->used(buffer_owner_);
+}
+
+void GwStream::Connected(std::shared_ptr<ByteIStream> stream) {
+  server_stream_ = std::move(stream);
+  Tie(buffer_stream_, *server_stream_);
+
+  auto const now = Now();
+  for (auto const& written_at : pre_connect_writes_) {
+    latency_tracer_->Record(LatencyStage::kPreConnect, now - written_at);
+  }
+  pre_connect_writes_.clear();
+}
+
 }  // namespace ae::gw
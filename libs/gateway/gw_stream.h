@@ -17,10 +17,14 @@
 #ifndef GATEWAY_GW_STREAM_H_
 #define GATEWAY_GW_STREAM_H_
 
+#include <vector>
 #include <memory>
 
 #include "aether/all.h"
 
+#include "gateway/buffer_pool.h"
+#include "gateway/latency_tracer.h"
+
 namespace ae::gw {
 class Gateway;
 class GwStream : public ByteIStream {
@@ -29,6 +33,7 @@ class GwStream : public ByteIStream {
   GwStream(Gateway& gateway, ServerId server_id);
   // Make GwStream with server descriptor provided
   GwStream(Gateway& gateway, ServerEndpoints const& endpoints);
+  ~GwStream() override;
 
   ActionPtr<StreamWriteAction> Write(DataBuffer&& data) override;
   StreamUpdateEvent::Subscriber stream_update_event() override;
@@ -36,10 +41,23 @@ class GwStream : public ByteIStream {
   OutDataEvent::Subscriber out_data_event() override;
   void Restream() override;
 
+  /**
+   * \brief Bytes written and not yet sent by the server stream.
+   */
+  std::size_t buffered_bytes() const;
+
  private:
   explicit GwStream(Gateway& gateway);
 
+  void Connected(std::shared_ptr<ByteIStream> stream);
+
   Gateway* gateway_;
+  // written data is charged to the pool until the write is done
+  BufferPool* buffer_pool_;
+  BufferPool::OwnerId buffer_owner_;
+  LatencyTracer* latency_tracer_;
+  // write times buffered until the server stream is connected
+  std::vector<TimePoint> pre_connect_writes_;
   Subscription get_sererver_stream_sub_;
   std::shared_ptr<ByteIStream> server_stream_;
   BufferStream<DataBuffer> buffer_stream_;
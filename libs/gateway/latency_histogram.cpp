@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway/latency_histogram.h"
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+namespace ae::gw {
+namespace {
+std::size_t HighestBit(std::uint64_t value) {
+  std::size_t bit = 0;
+  while ((value >>= 1) != 0) {
+    ++bit;
+  }
+  return bit;
+}
+}  // namespace
+
+void LatencyHistogram::Record(Duration latency) {
+  auto const us = static_cast<std::uint64_t>(std::max<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count(),
+      0));
+  counts_[Index(us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(us, std::memory_order_relaxed);
+  auto max = max_.load(std::memory_order_relaxed);
+  while ((us > max) &&
+         !max_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::count() const {
+  return count_.load(std::memory_order_relaxed);
+}
+
+Duration LatencyHistogram::max() const {
+  return std::chrono::duration_cast<Duration>(std::chrono::microseconds{
+      static_cast<std::int64_t>(max_.load(std::memory_order_relaxed))});
+}
+
+Duration LatencyHistogram::mean() const {
+  auto const count = count_.load(std::memory_order_relaxed);
+  if (count == 0) {
+    return {};
+  }
+  return std::chrono::duration_cast<Duration>(std::chrono::microseconds{
+      static_cast<std::int64_t>(sum_.load(std::memory_order_relaxed) /
+                                count)});
+}
+
+Duration LatencyHistogram::Percentile(double percentile) const {
+  auto const count = count_.load(std::memory_order_relaxed);
+  if (count == 0) {
+    return {};
+  }
+  auto const rank = std::max<std::uint64_t>(
+      static_cast<std::uint64_t>(
+          std::ceil((std::clamp(percentile, 0.0, 100.0) / 100.0) *
+                    static_cast<double>(count))),
+      1);
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kCounts; ++i) {
+    seen += counts_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      auto const value = std::min(HighestValue(i),
+                                  max_.load(std::memory_order_relaxed));
+      return std::chrono::duration_cast<Duration>(
+          std::chrono::microseconds{static_cast<std::int64_t>(value)});
+    }
+  }
+  return max();
+}
+
+std::size_t LatencyHistogram::Index(std::uint64_t value) {
+  if (value < (2 * kSubBuckets)) {
+    return static_cast<std::size_t>(value);
+  }
+  auto const shift = std::min(HighestBit(value), kMaxBits - 1) -
+                     kSubBucketBits;
+  auto const sub_bucket = std::min<std::uint64_t>(value >> shift,
+                                                  (2 * kSubBuckets) - 1);
+  return ((shift + 1) * kSubBuckets) +
+         static_cast<std::size_t>(sub_bucket - kSubBuckets);
+}
+
+std::uint64_t LatencyHistogram::HighestValue(std::size_t index) {
+  if (index < (2 * kSubBuckets)) {
+    return index;
+  }
+  auto const shift = (index / kSubBuckets) - 1;
+  auto const sub_bucket = (index % kSubBuckets) + kSubBuckets;
+  return ((static_cast<std::uint64_t>(sub_bucket) + 1) << shift) - 1;
+}
+}  // namespace ae::gw
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_LATENCY_HISTOGRAM_H_
+#define GATEWAY_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief HDR style histogram of latencies in microseconds.
+ * Values are bucketed by powers of two split into kSubBuckets linear
+ * sub-buckets, so the relative error is below 1/kSubBuckets for the whole
+ * range up to 2^kMaxBits us. Counters are relaxed atomics, recording is lock
+ * free and the histogram may be read from another thread.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr std::size_t kSubBucketBits = 4;
+  static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+  // about 71 minutes
+  static constexpr std::size_t kMaxBits = 32;
+  static constexpr std::size_t kCounts =
+      (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  void Record(Duration latency);
+  void Reset();
+
+  std::uint64_t count() const;
+  Duration max() const;
+  Duration mean() const;
+  /**
+   * \brief Highest value of the bucket the percentile falls to.
+   * \param percentile from 0 to 100.
+   */
+  Duration Percentile(double percentile) const;
+
+ private:
+  static std::size_t Index(std::uint64_t value);
+  static std::uint64_t HighestValue(std::size_t index);
+
+  std::array<std::atomic<std::uint32_t>, kCounts> counts_{};
+  std::atomic<std::uint64_t> count_{};
+  std::atomic<std::uint64_t> sum_{};
+  std::atomic<std::uint64_t> max_{};
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_LATENCY_HISTOGRAM_H_
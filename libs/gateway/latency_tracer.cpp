@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway/latency_tracer.h"
+
+#include <chrono>
+
+namespace ae::gw {
+std::string_view LatencyTracer::StageName(LatencyStage stage) {
+  switch (stage) {
+    case LatencyStage::kInput:
+      return "input";
+    case LatencyStage::kServerResolve:
+      return "server_resolve";
+    case LatencyStage::kPreConnect:
+      return "pre_connect";
+    case LatencyStage::kStreamWrite:
+      return "stream_write";
+    case LatencyStage::kServerReply:
+      return "server_reply";
+    case LatencyStage::kCount:
+      break;
+  }
+  return "unknown";
+}
+
+void LatencyTracer::Record(LatencyStage stage, Duration latency) {
+  histograms_[static_cast<std::size_t>(stage)].Record(latency);
+}
+
+void LatencyTracer::Reset() {
+  for (auto& histogram : histograms_) {
+    histogram.Reset();
+  }
+}
+
+LatencyHistogram const& LatencyTracer::histogram(LatencyStage stage) const {
+  return histograms_[static_cast<std::size_t>(stage)];
+}
+
+std::string LatencyTracer::Report() const {
+  auto const to_us = [](Duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+  };
+  std::string report;
+  for (std::size_t i = 0; i < kStageCount; ++i) {
+    auto const stage = static_cast<LatencyStage>(i);
+    auto const& h = histograms_[i];
+    report += Format(
+        "{}: count {} mean {} p50 {} p90 {} p99 {} max {} us\n",
+        StageName(stage), h.count(), to_us(h.mean()),
+        to_us(h.Percentile(50)), to_us(h.Percentile(90)),
+        to_us(h.Percentile(99)), to_us(h.max()));
+  }
+  return report;
+}
+}  // namespace ae::gw
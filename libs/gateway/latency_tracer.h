@@ -0,0 +1,74 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_LATENCY_TRACER_H_
+#define GATEWAY_LATENCY_TRACER_H_
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "gateway/latency_histogram.h"
+
+namespace ae::gw {
+/**
+ * \brief Stages of a packet through the gateway.
+ * kInput - LocalPort::Input, parsing and writing to the stream.
+ * kServerResolve - waiting for the server to be resolved by id.
+ * kPreConnect - buffering of a write until the server stream is ready.
+ * kStreamWrite - from GwStream::Write to the write done by the server
+ * stream.
+ * kServerReply - from the request written to the stream to the reply sent
+ * out of LocalPort::OutData.
+ */
+enum class LatencyStage : std::uint8_t {
+  kInput,
+  kServerResolve,
+  kPreConnect,
+  kStreamWrite,
+  kServerReply,
+  kCount,
+};
+
+/**
+ * \brief Latency histograms of the gateway stages.
+ */
+class LatencyTracer {
+ public:
+  static constexpr auto kStageCount =
+      static_cast<std::size_t>(LatencyStage::kCount);
+
+  static std::string_view StageName(LatencyStage stage);
+
+  void Record(LatencyStage stage, Duration latency);
+  void Reset();
+
+  LatencyHistogram const& histogram(LatencyStage stage) const;
+  /**
+   * \brief Count, mean and percentiles of each stage in us, line per stage.
+   */
+  std::string Report() const;
+
+ private:
+  std::array<LatencyHistogram, kStageCount> histograms_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_LATENCY_TRACER_H_
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_LOCAL_LINK_H_
+#define GATEWAY_LOCAL_LINK_H_
+
+#include <cstdint>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief Interface of a link between the gateway and local devices.
+ * LocalPort is the topmost link, other links are stacked in front of it to
+ * adapt the traffic to the device side transport.
+ */
+class ILocalLink {
+ public:
+  using Output = Event<void(std::uint8_t device_id, DataBuffer const& data)>;
+
+  virtual ~ILocalLink() = default;
+
+  /**
+   * \brief Input data from local device
+   */
+  virtual void Input(std::uint8_t device_id, DataBuffer const& data) = 0;
+
+  /**
+   * \brief Output data event to local device
+   */
+  virtual Output::Subscriber output_event() = 0;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_LOCAL_LINK_H_
@@ -44,6 +44,31 @@ class GatewayApiImpl : public GatewayApi {
         .Write(std::move(data));
   }
 
+  void BindStream(std::uint8_t stream_index, ClientId client_id,
+                  ServerId server_id) override {
+    local_port_->BindStream(device_id_, stream_index,
+                            Key{device_id_, client_id, server_id}, server_id);
+  }
+
+  void BindStreamEndpoints(std::uint8_t stream_index, ClientId client_id,
+                           ServerEndpoints server_endpoints) override {
+    local_port_->BindStream(device_id_, stream_index,
+                            Key{device_id_, client_id, server_endpoints},
+                            server_endpoints);
+  }
+
+  void ToStream(std::uint8_t stream_index, DataBuffer data) override {
+    auto* stream = local_port_->BoundStream(device_id_, stream_index);
+    if (stream == nullptr) {
+      AE_TELED_WARNING("Stream index {} is not bound for device {}",
+                       static_cast<int>(stream_index),
+                       static_cast<int>(device_id_));
+      local_port_->UnknownStream(device_id_, stream_index);
+      return;
+    }
+    stream->Write(std::move(data));
+  }
+
  private:
   std::uint8_t device_id_;
   LocalPort* local_port_;
@@ -68,12 +93,63 @@ bool operator<(LocalPort::Key const& a, LocalPort::Key const& b) {
 }
 
 LocalPort::LocalPort(Gateway& gateway)
-    : gateway_{&gateway}, client_api_{protocol_context_} {}
+    : gateway_{&gateway},
+      client_api_{protocol_context_},
+      metrics_{&gateway_->metrics()} {
+  sessions_collector_ = metrics_->AddCollector(
+      MetricsRegistry::Type::kGauge, "gateway_stream_sessions",
+      "Streams opened for the local devices", [this](auto& samples) {
+        samples.push_back({"gateway_stream_sessions", {},
+                           static_cast<std::int64_t>(stream_store_.size())});
+      });
+  buffered_collector_ = metrics_->AddCollector(
+      MetricsRegistry::Type::kGauge, "gateway_stream_buffered_bytes",
+      "Bytes buffered by the stream of a device client",
+      [this](auto& samples) { CollectStreams(samples); });
+
+  struct DeviceCounter {
+    char const* name;
+    char const* help;
+    std::int64_t DeviceCounters::*counter;
+  };
+  static constexpr DeviceCounter kDeviceCounters[] = {
+      {"gateway_device_frames_in_total", "Frames from the device",
+       &DeviceCounters::frames_in},
+      {"gateway_device_bytes_in_total", "Bytes from the device",
+       &DeviceCounters::bytes_in},
+      {"gateway_device_frames_out_total", "Frames to the device",
+       &DeviceCounters::frames_out},
+      {"gateway_device_bytes_out_total", "Bytes to the device",
+       &DeviceCounters::bytes_out},
+  };
+  for (auto const& device_counter : kDeviceCounters) {
+    device_collectors_.push_back(metrics_->AddCollector(
+        MetricsRegistry::Type::kCounter, device_counter.name,
+        device_counter.help,
+        [this, name = std::string{device_counter.name},
+         counter = device_counter.counter](auto& samples) {
+          CollectDevices(samples, name, counter);
+        }));
+  }
+}
+
+LocalPort::~LocalPort() {
+  metrics_->RemoveCollector(sessions_collector_);
+  metrics_->RemoveCollector(buffered_collector_);
+  for (auto collector : device_collectors_) {
+    metrics_->RemoveCollector(collector);
+  }
+}
 
 void LocalPort::Input(std::uint8_t device_id, DataBuffer const& data) {
+  auto const input_at = Now();
+  auto& counters = device_counters_[device_id];
+  ++counters.frames_in;
+  counters.bytes_in += static_cast<std::int64_t>(data.size());
   auto parser = ApiParser{protocol_context_, data};
   auto api = GatewayApiImpl{device_id, *this};
   parser.Parse(api);
+  gateway_->latency_tracer().Record(LatencyStage::kInput, Now() - input_at);
 }
 
 LocalPort::Output::Subscriber LocalPort::output_event() {
@@ -82,12 +158,17 @@ LocalPort::Output::Subscriber LocalPort::output_event() {
 
 ByteIStream& LocalPort::OpenStream(std::uint8_t device_id, ClientId client_id,
                                    ServerId server_id) {
-  return OpenStream(Key{device_id, client_id, server_id}, server_id);
+  auto key = Key{device_id, client_id, server_id};
+  auto& stream = OpenStream(key, server_id);
+  RequestSent(stream_store_.at(key));
+  return stream;
 }
 ByteIStream& LocalPort::OpenStream(std::uint8_t device_id, ClientId client_id,
                                    ServerEndpoints const& server_endpoints) {
-  return OpenStream(Key{device_id, client_id, server_endpoints},
-                    server_endpoints);
+  auto key = Key{device_id, client_id, server_endpoints};
+  auto& stream = OpenStream(key, server_endpoints);
+  RequestSent(stream_store_.at(key));
+  return stream;
 }
 
 ByteIStream& LocalPort::OpenStream(Key const& key, ServeKind const& server) {
@@ -99,8 +180,9 @@ ByteIStream& LocalPort::OpenStream(Key const& key, ServeKind const& server) {
         },
         server);
 
-    std::tie(it, std::ignore) =
-        stream_store_.emplace(key, StreamStore{{}, server, std::move(stream)});
+    std::tie(it, std::ignore) = stream_store_.emplace(
+        key, StreamStore{{}, server, std::move(stream), std::nullopt,
+                         std::nullopt});
 
     // subscribe stream data and updates
     out_data_subs_.Push(  // ~(^o^)~
@@ -115,9 +197,57 @@ ByteIStream& LocalPort::OpenStream(Key const& key, ServeKind const& server) {
   return *it->second.stream;
 }
 
+void LocalPort::BindStream(std::uint8_t device_id, std::uint8_t stream_index,
+                           Key const& key, ServeKind const& server) {
+  OpenStream(key, server);
+  auto& store = stream_store_.at(key);
+
+  auto index_key = std::pair{device_id, stream_index};
+  auto index_it = stream_indexes_.find(index_key);
+  if (index_it != std::end(stream_indexes_)) {
+    // rebind the index to another stream
+    auto old_it = stream_store_.find(index_it->second);
+    if (old_it != std::end(stream_store_)) {
+      old_it->second.stream_index.reset();
+    }
+    index_it->second = key;
+  } else {
+    stream_indexes_.emplace(index_key, key);
+  }
+  if (store.stream_index && (*store.stream_index != stream_index)) {
+    stream_indexes_.erase(std::pair{device_id, *store.stream_index});
+  }
+  store.stream_index = stream_index;
+}
+
+ByteIStream* LocalPort::BoundStream(std::uint8_t device_id,
+                                    std::uint8_t stream_index) {
+  auto index_it = stream_indexes_.find(std::pair{device_id, stream_index});
+  if (index_it == std::end(stream_indexes_)) {
+    return nullptr;
+  }
+  auto it = stream_store_.find(index_it->second);
+  if (it == std::end(stream_store_)) {
+    return nullptr;
+  }
+  it->second.last_used = Now();
+  RequestSent(it->second);
+  return it->second.stream.get();
+}
+
+void LocalPort::RequestSent(StreamStore& store) {
+  // the reply latency is measured from the oldest unanswered request, an
+  // expired one was not waiting for a reply
+  auto const now = Now();
+  if (!store.request_at || ((now - *store.request_at) > kReplyTimeout)) {
+    store.request_at = now;
+  }
+}
+
 void LocalPort::OutData(Key const& key, DataBuffer const& data) {
-  AE_TELED_DEBUG("OutData get for device {} client {} with data {}",
-                 static_cast<int>(key.device_id), key.client_id, data);
+  gateway_->trace_ring().Trace(TraceEvent::kLocalOutData, key.device_id,
+                               data.size(), key.client_id,
+                               key.server_identity);
   auto it = stream_store_.find(key);
   if (it == std::end(stream_store_)) {
     AE_TELED_ERROR("Unable to find stream for answear");
@@ -127,8 +257,57 @@ void LocalPort::OutData(Key const& key, DataBuffer const& data) {
   it->second.last_used = Now();
 
   auto api_context = ApiContext{client_api_};
-  api_context->from_server(key.client_id, data);
-  output_event_.Emit(key.device_id, DataBuffer{std::move(api_context)});
+  if (it->second.stream_index) {
+    api_context->from_stream(*it->second.stream_index, data);
+  } else {
+    api_context->from_server(key.client_id, data);
+  }
+
+  if (auto request_at = std::exchange(it->second.request_at, std::nullopt);
+      request_at) {
+    auto const reply_time = Now() - *request_at;
+    // later data is pushed by the server, not a reply
+    if (reply_time <= kReplyTimeout) {
+      gateway_->latency_tracer().Record(LatencyStage::kServerReply,
+                                        reply_time);
+    }
+  }
+  auto out_data = DataBuffer{std::move(api_context)};
+  auto& counters = device_counters_[key.device_id];
+  ++counters.frames_out;
+  counters.bytes_out += static_cast<std::int64_t>(out_data.size());
+  output_event_.Emit(key.device_id, out_data);
+}
+
+void LocalPort::UnknownStream(std::uint8_t device_id,
+                              std::uint8_t stream_index) {
+  // let the device bind the index again, it still has the data
+  auto api_context = ApiContext{client_api_};
+  api_context->unknown_stream(stream_index);
+  auto out_data = DataBuffer{std::move(api_context)};
+  output_event_.Emit(device_id, out_data);
+}
+
+void LocalPort::CollectDevices(std::vector<MetricsRegistry::Sample>& samples,
+                               std::string const& name,
+                               std::int64_t DeviceCounters::*counter) const {
+  for (auto const& [device_id, counters] : device_counters_) {
+    samples.push_back({name,
+                       Format("device=\"{}\"", static_cast<int>(device_id)),
+                       counters.*counter});
+  }
+}
+
+void LocalPort::CollectStreams(
+    std::vector<MetricsRegistry::Sample>& samples) const {
+  for (auto const& [key, store] : stream_store_) {
+    samples.push_back(
+        {"gateway_stream_buffered_bytes",
+         Format("device=\"{}\",client=\"{}\",server=\"{}\"",
+                static_cast<int>(key.device_id), key.client_id,
+                key.server_identity),
+         static_cast<std::int64_t>(store.stream->buffered_bytes())});
+  }
 }
 
 void LocalPort::StreamState(Key const& key) {
@@ -139,6 +318,10 @@ void LocalPort::StreamState(Key const& key) {
   auto const& info = it->second.stream->stream_info();
   // if link in error state, remove the stream
   if (info.link_state == LinkState::kLinkError) {
+    if (it->second.stream_index) {
+      stream_indexes_.erase(
+          std::pair{key.device_id, *it->second.stream_index});
+    }
     stream_store_.erase(it);
   }
 }
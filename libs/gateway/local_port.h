@@ -18,19 +18,32 @@
 #define GATEWAY_LOCAL_PORT_H_
 
 #include <map>
+#include <string>
+#include <vector>
+#include <utility>
 #include <variant>
+#include <optional>
 
 #include "aether/all.h"
 
 #include "gateway/gw_stream.h"
+#include "gateway/local_link.h"
+#include "gateway/metrics_registry.h"
 #include "gateway/api/client_api.h"
 
 namespace ae::gw {
 class Gateway;
-class LocalPort {
+class LocalPort final : public ILocalLink {
   friend class GatewayApiImpl;
 
  public:
+  /**
+   * \brief Data to a server not answered in this time is one way traffic.
+   * Payloads are opaque to the gateway, so the reply latency is recorded only
+   * for server data arriving within the timeout after a device request.
+   */
+  static constexpr Duration kReplyTimeout = std::chrono::seconds{30};
+
   using ServeKind = std::variant<ServerId, ServerEndpoints>;
 
   struct Key {
@@ -46,21 +59,24 @@ class LocalPort {
     TimePoint last_used;
     ServeKind server;
     std::unique_ptr<GwStream> stream;
+    // device local index if the stream is bound by BindStream
+    std::optional<std::uint8_t> stream_index;
+    // time of the first request not answered yet, \see kReplyTimeout
+    std::optional<TimePoint> request_at;
   };
 
-  using Output = Event<void(std::uint8_t device_id, DataBuffer const& data)>;
-
   explicit LocalPort(Gateway& gateway);
+  ~LocalPort() override;
 
   /**
    * \brief Input data from local device
    */
-  void Input(std::uint8_t device_id, DataBuffer const& data);
+  void Input(std::uint8_t device_id, DataBuffer const& data) override;
 
   /**
    * \brief Output data event to local device
    */
-  Output::Subscriber output_event();
+  Output::Subscriber output_event() override;
 
  private:
   ByteIStream& OpenStream(std::uint8_t device_id, ClientId client_id,
@@ -68,6 +84,26 @@ class LocalPort {
   ByteIStream& OpenStream(std::uint8_t device_id, ClientId client_id,
                           ServerEndpoints const& server_endpoints);
   ByteIStream& OpenStream(Key const& key, ServeKind const& server);
+  void BindStream(std::uint8_t device_id, std::uint8_t stream_index,
+                  Key const& key, ServeKind const& server);
+  ByteIStream* BoundStream(std::uint8_t device_id, std::uint8_t stream_index);
+  void UnknownStream(std::uint8_t device_id, std::uint8_t stream_index);
+  void RequestSent(StreamStore& store);
+
+  /**
+   * \brief Traffic counters of the device.
+   * Reported by collectors, so any number of devices fits the registry.
+   */
+  struct DeviceCounters {
+    std::int64_t frames_in;
+    std::int64_t bytes_in;
+    std::int64_t frames_out;
+    std::int64_t bytes_out;
+  };
+  void CollectDevices(std::vector<MetricsRegistry::Sample>& samples,
+                      std::string const& name,
+                      std::int64_t DeviceCounters::*counter) const;
+  void CollectStreams(std::vector<MetricsRegistry::Sample>& samples) const;
 
   void OutData(Key const& key, DataBuffer const& data);
   void StreamState(Key const& key);
@@ -78,8 +114,15 @@ class LocalPort {
   ClientApi client_api_;
 
   std::map<Key, StreamStore> stream_store_;
+  std::map<std::pair<std::uint8_t, std::uint8_t>, Key> stream_indexes_;
   MultiSubscription out_data_subs_;
   MultiSubscription update_stream_subs_;
+
+  MetricsRegistry* metrics_;
+  std::map<std::uint8_t, DeviceCounters> device_counters_;
+  MetricsRegistry::CollectorId sessions_collector_;
+  MetricsRegistry::CollectorId buffered_collector_;
+  std::vector<MetricsRegistry::CollectorId> device_collectors_;
 };
 }  // namespace ae::gw
 
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway/metrics_registry.h"
+
+#include <utility>
+#include <algorithm>
+
+#include "aether/tele/tele.h"
+
+namespace ae::gw {
+namespace {
+std::atomic<std::uint64_t> next_registry_serial{1};
+
+struct ShardCache {
+  std::uint64_t serial;
+  void* shard;
+};
+thread_local ShardCache shard_cache{};
+
+char const* TypeName(MetricsRegistry::Type type) {
+  switch (type) {
+    case MetricsRegistry::Type::kCounter:
+      return "counter";
+    case MetricsRegistry::Type::kGauge:
+      return "gauge";
+  }
+  return "untyped";
+}
+
+void AppendSample(std::string& text, MetricsRegistry::Sample const& sample) {
+  text += sample.name;
+  if (!sample.labels.empty()) {
+    text += '{';
+    text += sample.labels;
+    text += '}';
+  }
+  text += ' ';
+  text += std::to_string(sample.value);
+  text += '\n';
+}
+}  // namespace
+
+MetricsRegistry::MetricsRegistry()
+    : serial_{next_registry_serial.fetch_add(1, std::memory_order_relaxed)} {}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry::MetricId MetricsRegistry::Register(Type type,
+                                                    std::string const& name,
+                                                    std::string const& help,
+                                                    std::string const& labels) {
+  auto lock = std::lock_guard{mutex_};
+  auto [it, inserted] = metric_ids_.try_emplace(std::pair{name, labels},
+                                                metrics_.size());
+  if (!inserted) {
+    return it->second;
+  }
+  if (metrics_.size() == kMaxMetrics) {
+    metric_ids_.erase(it);
+    if (!std::exchange(full_logged_, true)) {
+      AE_TELED_ERROR("Metrics registry is full, {} {} is not registered",
+                     name, labels);
+    }
+    return kNoMetric;
+  }
+  families_.try_emplace(name, Family{type, help});
+  metrics_.push_back(Metric{name, labels});
+  return it->second;
+}
+
+void MetricsRegistry::Add(MetricId metric, std::int64_t value) {
+  if (metric >= kMaxMetrics) {
+    return;
+  }
+  // the shard is written by this thread only
+  auto& shard_value = LocalShard().values[metric];
+  shard_value.store(shard_value.load(std::memory_order_relaxed) + value,
+                    std::memory_order_relaxed);
+}
+
+MetricsRegistry::CollectorId MetricsRegistry::AddCollector(
+    Type type, std::string const& name, std::string const& help,
+    Collector collector) {
+  auto lock = std::lock_guard{mutex_};
+  families_.try_emplace(name, Family{type, help});
+  auto const id = next_collector_++;
+  collectors_.emplace(id, std::pair{name, std::move(collector)});
+  return id;
+}
+
+void MetricsRegistry::RemoveCollector(CollectorId collector) {
+  auto lock = std::lock_guard{mutex_};
+  collectors_.erase(collector);
+}
+
+std::vector<MetricsRegistry::Sample> MetricsRegistry::Collect() const {
+  std::vector<Sample> samples;
+  std::vector<Collector> collectors;
+  {
+    auto lock = std::lock_guard{mutex_};
+    samples.reserve(metrics_.size());
+    for (std::size_t i = 0; i < metrics_.size(); ++i) {
+      std::int64_t value = 0;
+      for (auto const& shard : shards_) {
+        value += shard->values[i].load(std::memory_order_relaxed);
+      }
+      samples.push_back(Sample{metrics_[i].name, metrics_[i].labels, value});
+    }
+    collectors.reserve(collectors_.size());
+    for (auto const& [id, collector] : collectors_) {
+      collectors.push_back(collector.second);
+    }
+  }
+  // collectors may use the registry
+  for (auto const& collector : collectors) {
+    collector(samples);
+  }
+  std::stable_sort(
+      std::begin(samples), std::end(samples),
+      [](auto const& a, auto const& b) { return a.name < b.name; });
+  return samples;
+}
+
+std::string MetricsRegistry::PrometheusText() const {
+  auto const samples = Collect();
+  auto lock = std::lock_guard{mutex_};
+  std::string text;
+  std::string_view family_name;
+  for (auto const& sample : samples) {
+    if (sample.name != family_name) {
+      family_name = sample.name;
+      auto it = families_.find(family_name);
+      if (it != std::end(families_)) {
+        text += "# HELP " + sample.name + ' ' + it->second.help + '\n';
+        text += "# TYPE " + sample.name + ' ' + TypeName(it->second.type) +
+                '\n';
+      }
+    }
+    AppendSample(text, sample);
+  }
+  return text;
+}
+
+std::string MetricsRegistry::CompactText() const {
+  std::string text;
+  for (auto const& sample : Collect()) {
+    AppendSample(text, sample);
+  }
+  return text;
+}
+
+MetricsRegistry::Shard& MetricsRegistry::LocalShard() {
+  if (shard_cache.serial == serial_) {
+    return *static_cast<Shard*>(shard_cache.shard);
+  }
+  auto lock = std::lock_guard{mutex_};
+  auto [it, inserted] = thread_shards_.try_emplace(std::this_thread::get_id(),
+                                                   shards_.size());
+  if (inserted) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+  shard_cache = ShardCache{serial_, shards_[it->second].get()};
+  return *shards_[it->second];
+}
+}  // namespace ae::gw
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_METRICS_REGISTRY_H_
+#define GATEWAY_METRICS_REGISTRY_H_
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace ae::gw {
+/**
+ * \brief Registry of the gateway counters and gauges.
+ * Metrics are registered once by name and labels and updated with Add from
+ * any thread. Each thread adds to its own shard without contention and the
+ * shards are summed on scrape. Values known only at scrape time, e.g. sizes
+ * of containers, are reported by collectors called on the scraping thread.
+ */
+class MetricsRegistry {
+ public:
+  using MetricId = std::size_t;
+  using CollectorId = std::size_t;
+
+  enum class Type : std::uint8_t {
+    kCounter,
+    kGauge,
+  };
+
+  struct Sample {
+    std::string name;
+    // prometheus label list without braces, e.g. device="1"
+    std::string labels;
+    std::int64_t value;
+  };
+
+  using Collector = std::function<void(std::vector<Sample>& samples)>;
+
+#if defined(ESP_PLATFORM)
+  static constexpr std::size_t kMaxMetrics = 64;
+#else
+  static constexpr std::size_t kMaxMetrics = 512;
+#endif
+  // returned if there is no room for a new metric, Add ignores it
+  // metrics of an unbounded number of objects, e.g. per device counters,
+  // are reported by collectors instead of taking this room
+  static constexpr MetricId kNoMetric = kMaxMetrics;
+
+  MetricsRegistry();
+  ~MetricsRegistry();
+
+  /**
+   * \brief Metric of the name and labels, the same id for the same pair.
+   * Name family type and help are set by the first registration. kNoMetric
+   * if the registry is full, that is logged once.
+   */
+  MetricId Register(Type type, std::string const& name,
+                    std::string const& help, std::string const& labels = {});
+  /**
+   * \brief Add value to the metric, negative values decrease a gauge.
+   */
+  void Add(MetricId metric, std::int64_t value = 1);
+
+  /**
+   * \brief Collector of the samples of the name family.
+   */
+  CollectorId AddCollector(Type type, std::string const& name,
+                           std::string const& help, Collector collector);
+  void RemoveCollector(CollectorId collector);
+
+  /**
+   * \brief Current values of all the metrics, grouped by name.
+   */
+  std::vector<Sample> Collect() const;
+  /**
+   * \brief Prometheus text exposition format.
+   */
+  std::string PrometheusText() const;
+  /**
+   * \brief Line per sample without type and help, for small devices logs.
+   */
+  std::string CompactText() const;
+
+ private:
+  struct Family {
+    Type type;
+    std::string help;
+  };
+
+  struct Shard {
+    std::array<std::atomic<std::int64_t>, kMaxMetrics> values{};
+  };
+
+  struct Metric {
+    std::string name;
+    std::string labels;
+  };
+
+  Shard& LocalShard();
+
+  // distinguishes registries in the per thread shard cache
+  std::uint64_t serial_;
+  mutable std::mutex mutex_;
+  std::map<std::string, Family, std::less<>> families_;
+  std::vector<Metric> metrics_;
+  std::map<std::pair<std::string, std::string>, MetricId> metric_ids_;
+  bool full_logged_{};
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::map<std::thread::id, std::size_t> thread_shards_;
+  CollectorId next_collector_{};
+  std::map<CollectorId, std::pair<std::string, Collector>> collectors_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_METRICS_REGISTRY_H_
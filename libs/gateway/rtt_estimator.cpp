@@ -0,0 +1,46 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway/rtt_estimator.h"
+
+#include <algorithm>
+
+namespace ae::gw {
+RttEstimator::RttEstimator(Config config)
+    : config_{config}, rto_{config_.initial_rto} {}
+
+void RttEstimator::Sample(Duration rtt) {
+  if (!srtt_) {
+    srtt_ = rtt;
+    rttvar_ = rtt / 2;
+  } else {
+    auto const delta = (*srtt_ > rtt) ? (*srtt_ - rtt) : (rtt - *srtt_);
+    rttvar_ = (rttvar_ * 3 + delta) / 4;
+    srtt_ = (*srtt_ * 7 + rtt) / 8;
+  }
+  min_rtt_ = min_rtt_ ? std::min(*min_rtt_, rtt) : rtt;
+  rto_ = std::clamp(*srtt_ + rttvar_ * 4, config_.min_rto, config_.max_rto);
+}
+
+Duration RttEstimator::rto() const { return rto_; }
+
+std::optional<Duration> RttEstimator::srtt() const { return srtt_; }
+
+Duration RttEstimator::rttvar() const { return rttvar_; }
+
+std::optional<Duration> RttEstimator::min_rtt() const { return min_rtt_; }
+}  // namespace ae::gw
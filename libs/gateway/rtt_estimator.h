@@ -0,0 +1,60 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_RTT_ESTIMATOR_H_
+#define GATEWAY_RTT_ESTIMATOR_H_
+
+#include <optional>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief Retransmission timeout estimated from RTT samples as in RFC 6298.
+ * Samples of retransmitted frames are ambiguous and must not be passed
+ * (Karn's algorithm) unless the transmission they acknowledge is known.
+ */
+class RttEstimator {
+ public:
+  struct Config {
+    Duration initial_rto;
+    Duration min_rto;
+    Duration max_rto;
+  };
+
+  explicit RttEstimator(Config config);
+
+  void Sample(Duration rtt);
+
+  Duration rto() const;
+  std::optional<Duration> srtt() const;
+  Duration rttvar() const;
+  /**
+   * \brief The smallest sample seen, the link delay without queueing.
+   */
+  std::optional<Duration> min_rtt() const;
+
+ private:
+  Config config_;
+  std::optional<Duration> srtt_;
+  Duration rttvar_{};
+  std::optional<Duration> min_rtt_;
+  Duration rto_;
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_RTT_ESTIMATOR_H_
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/selective_repeat.h"
+
+#include <tuple>
+#include <utility>
+#include <algorithm>
+
+namespace ae::gw {
+static constexpr std::uint8_t kDataFrame = 0x01;
+static constexpr std::uint8_t kAckFrame = 0x02;
+// sequence numbers are 8 bit
+static constexpr std::uint8_t kHalfSequenceSpace = 128;
+
+static constexpr std::uint8_t Distance(std::uint8_t from, std::uint8_t to) {
+  return static_cast<std::uint8_t>(to - from);
+}
+
+static constexpr std::size_t Slot(std::uint8_t seq) {
+  return seq % SelectiveRepeat::kWindowSize;
+}
+
+SelectiveRepeat::SelectiveRepeat(Config config)
+    : config_{config},
+      rtt_{RttEstimator::Config{config_.initial_rto, config_.min_rto,
+                                config_.max_rto}} {
+  config_.window_size =
+      std::clamp<std::uint8_t>(config_.window_size, 1, kWindowSize);
+  window_ = std::min(kInitialWindow, config_.window_size);
+  ssthresh_ = config_.window_size;
+}
+
+void SelectiveRepeat::Send(DataBuffer data, TimePoint now) {
+  if (pending_.size() >= config_.max_pending) {
+    AE_TELED_ERROR("Selective repeat pending queue overflow, drop data");
+    return;
+  }
+  pending_.emplace_back(std::move(data));
+  SendPending(now);
+}
+
+void SelectiveRepeat::Receive(DataBuffer const& frame, TimePoint now) {
+  if (frame.empty()) {
+    return;
+  }
+  switch (frame[0]) {
+    case kDataFrame:
+      ReceiveData(frame);
+      break;
+    case kAckFrame:
+      ReceiveAck(frame, now);
+      break;
+    default:
+      AE_TELED_ERROR("Unknown selective repeat frame type {}",
+                     static_cast<int>(frame[0]));
+      break;
+  }
+}
+
+TimePoint SelectiveRepeat::Update(TimePoint now) {
+  auto next = TimePoint::max();
+  auto const in_flight = Distance(send_base_, send_next_);
+  for (std::uint8_t i = 0; i < in_flight; ++i) {
+    auto const seq = static_cast<std::uint8_t>(send_base_ + i);
+    auto& outgoing = send_window_[Slot(seq)];
+    if (!outgoing || outgoing->done) {
+      continue;
+    }
+    if ((outgoing->sent_at + outgoing->rto) <= now) {
+      if (outgoing->retries >= config_.max_retries) {
+        AE_TELED_ERROR("Selective repeat frame {} lost after {} retries",
+                       static_cast<int>(seq),
+                       static_cast<int>(outgoing->retries));
+        outgoing->done = true;
+        stats_.lost++;
+        delivery_event_.Emit(false);
+        continue;
+      }
+      outgoing->retries++;
+      stats_.retransmits++;
+      // exponential backoff for the frame
+      outgoing->rto = std::min(outgoing->rto * 2, config_.max_rto);
+      ShrinkWindow(now);
+      Transmit(*outgoing, now);
+    }
+    next = std::min(next, outgoing->sent_at + outgoing->rto);
+  }
+
+  SlideSendWindow();
+  SendPending(now);
+  return next;
+}
+
+SelectiveRepeat::OutFrameEvent::Subscriber
+SelectiveRepeat::out_frame_event() {
+  return EventSubscriber{out_frame_event_};
+}
+
+SelectiveRepeat::OutDataEvent::Subscriber SelectiveRepeat::out_data_event() {
+  return EventSubscriber{out_data_event_};
+}
+
+SelectiveRepeat::DeliveryEvent::Subscriber SelectiveRepeat::delivery_event() {
+  return EventSubscriber{delivery_event_};
+}
+
+Duration SelectiveRepeat::rto() const { return rtt_.rto(); }
+
+RttEstimator const& SelectiveRepeat::rtt() const { return rtt_; }
+
+std::uint8_t SelectiveRepeat::window() const { return window_; }
+
+SelectiveRepeat::Stats const& SelectiveRepeat::stats() const {
+  return stats_;
+}
+
+void SelectiveRepeat::SendPending(TimePoint now) {
+  while (!pending_.empty() &&
+         (Distance(send_base_, send_next_) < window_)) {
+    auto const seq = send_next_++;
+    auto const& data = pending_.front();
+
+    auto frame = DataBuffer{};
+    frame.reserve(kDataHeaderSize + data.size());
+    frame.push_back(kDataFrame);
+    frame.push_back(seq);
+    frame.push_back(0);  // base is set on transmit
+    frame.push_back(0);  // attempt is set on transmit
+    frame.insert(std::end(frame), std::begin(data), std::end(data));
+    pending_.pop_front();
+
+    auto& outgoing = send_window_[Slot(seq)];
+    outgoing.emplace(
+        Outgoing{std::move(frame), now, now, rtt_.rto(), 0, false, false});
+    stats_.sent++;
+    Transmit(*outgoing, now);
+  }
+}
+
+void SelectiveRepeat::Transmit(Outgoing& outgoing, TimePoint now) {
+  outgoing.frame[2] = send_base_;
+  outgoing.frame[3] = outgoing.retries;
+  outgoing.sent_at = now;
+  out_frame_event_.Emit(outgoing.frame);
+}
+
+void SelectiveRepeat::ReceiveData(DataBuffer const& frame) {
+  if (frame.size() < kDataHeaderSize) {
+    AE_TELED_ERROR("Selective repeat data frame is too short");
+    return;
+  }
+  auto const seq = frame[1];
+  auto const sender_base = frame[2];
+  auto const attempt = frame[3];
+
+  // sender gave up on frames before its base, skip them, a base behind
+  // receive_base_ is of an old frame and is more than half the sequence
+  // space away
+  auto const skip = Distance(receive_base_, sender_base);
+  if ((skip != 0) && (skip < kHalfSequenceSpace)) {
+    // only the frames in the window may be held
+    auto const held = std::min(skip, kWindowSize);
+    for (std::uint8_t i = 0; i < held; ++i) {
+      auto& slot = receive_window_[Slot(receive_base_)];
+      if (slot) {
+        out_data_event_.Emit(*slot);
+        slot.reset();
+      }
+      ++receive_base_;
+    }
+    receive_base_ = sender_base;
+  }
+
+  if (Distance(receive_base_, seq) < kWindowSize) {
+    auto& slot = receive_window_[Slot(seq)];
+    if (!slot) {
+      slot.emplace(std::begin(frame) + kDataHeaderSize, std::end(frame));
+    }
+    DeliverInOrder();
+  }
+  // acknowledge duplicates too, previous ack might be lost
+  SendAck(seq, attempt);
+}
+
+void SelectiveRepeat::ReceiveAck(DataBuffer const& frame, TimePoint now) {
+  if (frame.size() < kAckSize) {
+    AE_TELED_ERROR("Selective repeat ack frame is too short");
+    return;
+  }
+  auto const next_seq = frame[1];
+  auto const sack = static_cast<std::uint16_t>(
+      frame[2] | (static_cast<std::uint16_t>(frame[3]) << 8));
+  auto const echo_seq = frame[4];
+  auto const echo_attempt = frame[5];
+
+  auto const in_flight = Distance(send_base_, send_next_);
+  auto const acked = Distance(send_base_, next_seq);
+  if (acked > in_flight) {
+    // stale ack
+    return;
+  }
+  if (Distance(send_base_, echo_seq) < in_flight) {
+    Echo(echo_seq, echo_attempt, now);
+  }
+  for (std::uint8_t i = 0; i < acked; ++i) {
+    Acknowledge(static_cast<std::uint8_t>(send_base_ + i), now);
+  }
+  for (std::uint8_t i = 0; i < (kWindowSize - 1); ++i) {
+    if ((sack & (1U << i)) == 0) {
+      continue;
+    }
+    auto const seq = static_cast<std::uint8_t>(next_seq + 1 + i);
+    if (Distance(send_base_, seq) < in_flight) {
+      Acknowledge(seq, now);
+    }
+  }
+
+  SlideSendWindow();
+  SendPending(now);
+}
+
+void SelectiveRepeat::Echo(std::uint8_t seq, std::uint8_t attempt,
+                           TimePoint now) {
+  auto& outgoing = send_window_[Slot(seq)];
+  if (!outgoing || outgoing->done || (attempt > outgoing->retries)) {
+    return;
+  }
+  // only send times of the first and the last transmissions are known
+  if (attempt == 0) {
+    rtt_.Sample(
+        std::chrono::duration_cast<Duration>(now - outgoing->first_sent_at));
+  } else if (attempt == outgoing->retries) {
+    rtt_.Sample(std::chrono::duration_cast<Duration>(now - outgoing->sent_at));
+  }
+  if (attempt < outgoing->retries) {
+    // an earlier transmission was received, the timeout was too short
+    stats_.spurious_retransmits +=
+        static_cast<std::size_t>(outgoing->retries - attempt);
+    outgoing->spurious = true;
+    if (undo_window_) {
+      std::tie(window_, ssthresh_) = *undo_window_;
+      undo_window_.reset();
+    }
+  }
+}
+
+void SelectiveRepeat::Acknowledge(std::uint8_t seq, TimePoint now) {
+  auto& outgoing = send_window_[Slot(seq)];
+  if (!outgoing || outgoing->done) {
+    return;
+  }
+  outgoing->done = true;
+  if ((outgoing->retries != 0) && !outgoing->spurious) {
+    auto const recovery_time =
+        std::chrono::duration_cast<Duration>(now - outgoing->first_sent_at);
+    stats_.recoveries++;
+    stats_.recovery_time += recovery_time;
+    stats_.max_recovery_time =
+        std::max(stats_.max_recovery_time, recovery_time);
+  }
+  GrowWindow();
+  delivery_event_.Emit(true);
+}
+
+void SelectiveRepeat::GrowWindow() {
+  if (window_ >= config_.window_size) {
+    return;
+  }
+  if (window_ < ssthresh_) {
+    // slow start
+    ++window_;
+    return;
+  }
+  // congestion avoidance, one frame per window of acknowledgements
+  if (++window_acks_ >= window_) {
+    window_acks_ = 0;
+    ++window_;
+  }
+}
+
+void SelectiveRepeat::ShrinkWindow(TimePoint now) {
+  // timeouts of the frames sent in the same round trip are one loss event
+  auto const round_trip = rtt_.srtt().value_or(rtt_.rto());
+  if (reduced_at_ && ((now - *reduced_at_) < round_trip)) {
+    return;
+  }
+  reduced_at_ = now;
+  undo_window_.emplace(window_, ssthresh_);
+  ssthresh_ = std::max<std::uint8_t>(window_ / 2, 1);
+  window_ = ssthresh_;
+  window_acks_ = 0;
+}
+
+void SelectiveRepeat::SlideSendWindow() {
+  while (send_base_ != send_next_) {
+    auto& outgoing = send_window_[Slot(send_base_)];
+    if (outgoing && !outgoing->done) {
+      break;
+    }
+    outgoing.reset();
+    ++send_base_;
+  }
+}
+
+void SelectiveRepeat::DeliverInOrder() {
+  for (auto* slot = &receive_window_[Slot(receive_base_)]; slot->has_value();
+       slot = &receive_window_[Slot(receive_base_)]) {
+    auto data = std::move(**slot);
+    slot->reset();
+    ++receive_base_;
+    out_data_event_.Emit(data);
+  }
+}
+
+void SelectiveRepeat::SendAck(std::uint8_t echo_seq,
+                              std::uint8_t echo_attempt) {
+  std::uint16_t sack{};
+  for (std::uint8_t i = 0; i < (kWindowSize - 1); ++i) {
+    auto const seq = static_cast<std::uint8_t>(receive_base_ + 1 + i);
+    if (receive_window_[Slot(seq)]) {
+      sack |= static_cast<std::uint16_t>(1U << i);
+    }
+  }
+  out_frame_event_.Emit(DataBuffer{
+      kAckFrame,
+      receive_base_,
+      static_cast<std::uint8_t>(sack & 0xFF),
+      static_cast<std::uint8_t>(sack >> 8),
+      echo_seq,
+      echo_attempt,
+  });
+}
+}  // namespace ae::gw
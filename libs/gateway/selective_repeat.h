@@ -0,0 +1,164 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GATEWAY_SELECTIVE_REPEAT_H_
+#define GATEWAY_SELECTIVE_REPEAT_H_
+
+#include <array>
+#include <deque>
+#include <cstdint>
+#include <utility>
+#include <optional>
+
+#include "aether/all.h"
+
+#include "gateway/rtt_estimator.h"
+
+namespace ae::gw {
+/**
+ * \brief One endpoint of selective repeat ARQ session over a lossy link.
+ * Data frame: 0x01 seq base attempt payload, where base is the oldest
+ * sequence number the sender still waits acknowledgement for and attempt is
+ * the retransmission number of the frame.
+ * Ack frame: 0x02 next_seq sack_low sack_high echo_seq echo_attempt, where
+ * sack is a bitmap of frames received after next_seq and echo is the frame
+ * the ack is sent for.
+ * Retransmission timeout is estimated from RTT samples as in RFC 6298. The
+ * echoed attempt tells which transmission is acknowledged, so retransmitted
+ * frames are sampled too and retransmissions of delivered frames are detected
+ * as spurious. The send window starts small, grows with acknowledgements up to
+ * window_size and is halved at most once per RTT on a timeout. A spurious
+ * timeout undoes the reduction.
+ */
+class SelectiveRepeat {
+ public:
+  static constexpr std::uint8_t kWindowSize = 16;
+  static constexpr std::uint8_t kInitialWindow = 2;
+  static constexpr std::size_t kDataHeaderSize = 4;
+  static constexpr std::size_t kAckSize = 6;
+
+  struct Config {
+    Duration initial_rto;
+    Duration min_rto;
+    Duration max_rto;
+    std::uint8_t max_retries;
+    std::size_t max_pending;
+    // upper limit of the send window, at most kWindowSize
+    std::uint8_t window_size{kWindowSize};
+  };
+
+  struct Stats {
+    std::size_t sent;
+    std::size_t retransmits;
+    // retransmissions of frames the remote side had already received
+    std::size_t spurious_retransmits;
+    std::size_t lost;
+    // frames delivered after retransmission and the time from their first
+    // transmission to the acknowledgement
+    std::size_t recoveries;
+    Duration recovery_time;
+    Duration max_recovery_time;
+  };
+
+  using OutFrameEvent = Event<void(DataBuffer const& frame)>;
+  using OutDataEvent = Event<void(DataBuffer const& data)>;
+  using DeliveryEvent = Event<void(bool delivered)>;
+
+  explicit SelectiveRepeat(Config config);
+
+  /**
+   * \brief Send data to the remote side.
+   * Data is queued if the send window is full.
+   */
+  void Send(DataBuffer data, TimePoint now);
+  /**
+   * \brief Handle frame received from the remote side.
+   */
+  void Receive(DataBuffer const& frame, TimePoint now);
+  /**
+   * \brief Retransmit timed out frames.
+   * \return Time of the next retransmission or TimePoint::max().
+   */
+  TimePoint Update(TimePoint now);
+
+  /**
+   * \brief Frames to send over the link.
+   */
+  OutFrameEvent::Subscriber out_frame_event();
+  /**
+   * \brief Received data in the sending order.
+   */
+  OutDataEvent::Subscriber out_data_event();
+  /**
+   * \brief Result of each frame.
+   * A frame is reported delivered once acknowledged and lost once given up
+   * after max_retries, retransmissions are not reported.
+   */
+  DeliveryEvent::Subscriber delivery_event();
+
+  Duration rto() const;
+  RttEstimator const& rtt() const;
+  std::uint8_t window() const;
+  Stats const& stats() const;
+
+ private:
+  struct Outgoing {
+    DataBuffer frame;
+    TimePoint first_sent_at;
+    TimePoint sent_at;
+    Duration rto;
+    std::uint8_t retries;
+    bool spurious;
+    bool done;
+  };
+
+  void SendPending(TimePoint now);
+  void Transmit(Outgoing& outgoing, TimePoint now);
+  void ReceiveData(DataBuffer const& frame);
+  void ReceiveAck(DataBuffer const& frame, TimePoint now);
+  void Echo(std::uint8_t seq, std::uint8_t attempt, TimePoint now);
+  void Acknowledge(std::uint8_t seq, TimePoint now);
+  void GrowWindow();
+  void ShrinkWindow(TimePoint now);
+  void SlideSendWindow();
+  void DeliverInOrder();
+  void SendAck(std::uint8_t echo_seq, std::uint8_t echo_attempt);
+
+  Config config_;
+  OutFrameEvent out_frame_event_;
+  OutDataEvent out_data_event_;
+  DeliveryEvent delivery_event_;
+
+  std::uint8_t send_base_{};
+  std::uint8_t send_next_{};
+  std::array<std::optional<Outgoing>, kWindowSize> send_window_;
+  std::deque<DataBuffer> pending_;
+
+  std::uint8_t receive_base_{};
+  std::array<std::optional<DataBuffer>, kWindowSize> receive_window_;
+
+  RttEstimator rtt_;
+  std::uint8_t window_;
+  std::uint8_t ssthresh_;
+  std::uint8_t window_acks_{};
+  // window before the last reduction, restored if it was spurious
+  std::optional<std::pair<std::uint8_t, std::uint8_t>> undo_window_;
+  std::optional<TimePoint> reduced_at_;
+  Stats stats_{};
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_SELECTIVE_REPEAT_H_
@@ -16,18 +16,68 @@
 
 #include "gateway/server_stream.h"
 
+#include <utility>
+
 namespace ae::gw {
+namespace server_stream_internal {
+MultiplexWriteAction::MultiplexWriteAction(ActionContext action_context)
+    : StreamWriteAction{action_context} {}
+
+void MultiplexWriteAction::Bind(
+    ActionPtr<StreamWriteAction> const& packet_write) {
+  packet_write_sub_ = packet_write->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this]() { state_ = State::kDone; }},
+      OnError{[this]() { state_ = State::kFailed; }},
+      OnStop{[this]() { state_ = State::kStopped; }},
+  });
+}
+
+void MultiplexWriteAction::Fail() { state_ = State::kFailed; }
+}  // namespace server_stream_internal
+
 ServerStream::ServerStream(ActionContext action_context,
-                           Server::ptr const& server)
+                           Server::ptr const& server,
+                           MultiplexConfig multiplex_config)
     : action_context_{action_context},
       channel_manager_{action_context_, server},
       channel_select_stream_{action_context_, channel_manager_},
-      buffer_stream_{action_context_} {
+      buffer_stream_{action_context_},
+      multiplex_config_{multiplex_config},
+      flush_action_{action_context_,
+                    [this](auto now) { return Flush(now); }} {
   Tie(buffer_stream_, channel_select_stream_);
 }
 
+ServerStream::~ServerStream() {
+  // the batch is never flushed, do not leave its writers waiting
+  for (auto& write_action : batch_writes_) {
+    write_action->Fail();
+  }
+}
+
 ActionPtr<StreamWriteAction> ServerStream::Write(DataBuffer&& data) {
-  return buffer_stream_.Write(std::move(data));
+  if (!multiplex_config_.enabled) {
+    return buffer_stream_.Write(std::move(data));
+  }
+
+  if (!batch_.empty() &&
+      ((batch_.size() + data.size()) > multiplex_config_.max_packet_size)) {
+    FlushBatch();
+  }
+  if (batch_.empty()) {
+    batch_deadline_ = Now() + multiplex_config_.flush_window;
+    flush_action_->Reschedule();
+  }
+  batch_.insert(std::end(batch_), std::begin(data), std::end(data));
+
+  auto write_action =
+      ActionPtr<server_stream_internal::MultiplexWriteAction>{action_context_};
+  batch_writes_.push_back(write_action);
+
+  if (batch_.size() >= multiplex_config_.max_packet_size) {
+    FlushBatch();
+  }
+  return write_action;
 }
 
 StreamInfo ServerStream::stream_info() const {
@@ -45,4 +95,24 @@ ServerStream::OutDataEvent::Subscriber ServerStream::out_data_event() {
 
 void ServerStream::Restream() { buffer_stream_.Restream(); }
 
+TimePoint ServerStream::Flush(TimePoint now) {
+  if (batch_.empty()) {
+    return TimePoint::max();
+  }
+  if (batch_deadline_ > now) {
+    return batch_deadline_;
+  }
+  FlushBatch();
+  return TimePoint::max();
+}
+
+void ServerStream::FlushBatch() {
+  auto packet_write = buffer_stream_.Write(std::move(batch_));
+  for (auto& write_action : batch_writes_) {
+    write_action->Bind(packet_write);
+  }
+  batch_.clear();
+  batch_writes_.clear();
+}
+
 }  // namespace ae::gw
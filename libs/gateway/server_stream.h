@@ -17,16 +17,53 @@
 #ifndef GATEWAY_SERVER_STREAM_H_
 #define GATEWAY_SERVER_STREAM_H_
 
+#include <vector>
+
 #include "aether/server.h"
 #include "aether/stream_api/istream.h"
 #include "aether/actions/action_context.h"
 #include "aether/stream_api/buffer_stream.h"
 #include "aether/server_connections/channel_selection_stream.h"
 
+#include "gateway/deadline_action.h"
+
 namespace ae::gw {
+namespace server_stream_internal {
+/**
+ * \brief Write action for the data packed into multiplexed packet.
+ */
+class MultiplexWriteAction final : public StreamWriteAction {
+ public:
+  explicit MultiplexWriteAction(ActionContext action_context);
+
+  void Bind(ActionPtr<StreamWriteAction> const& packet_write);
+  /**
+   * \brief The packet is never written, e.g. the stream is destroyed.
+   */
+  void Fail();
+
+ private:
+  Subscription packet_write_sub_;
+};
+}  // namespace server_stream_internal
+
+/**
+ * \brief Multiplexing of writes to the server stream.
+ * Aether server packets are sequences of self delimited api calls, so writes
+ * from different clients made within flush_window are concatenated into one
+ * packet up to max_packet_size.
+ */
+struct MultiplexConfig {
+  bool enabled{false};
+  Duration flush_window{};
+  std::size_t max_packet_size{};
+};
+
 class ServerStream : public ByteIStream {
  public:
-  ServerStream(ActionContext action_context, Server::ptr const& server);
+  ServerStream(ActionContext action_context, Server::ptr const& server,
+               MultiplexConfig multiplex_config = {});
+  ~ServerStream() override;
 
   ActionPtr<StreamWriteAction> Write(DataBuffer&& data) override;
   StreamInfo stream_info() const override;
@@ -36,11 +73,20 @@ class ServerStream : public ByteIStream {
 
  private:
   void OnStreamUpdate();
+  TimePoint Flush(TimePoint now);
+  void FlushBatch();
 
   ActionContext action_context_;
   ChannelManager channel_manager_;
   ChannelSelectStream channel_select_stream_;
   BufferStream<DataBuffer> buffer_stream_;
+
+  MultiplexConfig multiplex_config_;
+  DataBuffer batch_;
+  std::vector<ActionPtr<server_stream_internal::MultiplexWriteAction>>
+      batch_writes_;
+  TimePoint batch_deadline_;
+  OwnActionPtr<DeadlineAction> flush_action_;
 };
 }  // namespace ae::gw
 
@@ -18,10 +18,10 @@
 
 #include <utility>
 #include <cassert>
+#include <algorithm>
 #include <cstdint>
 
 #include "gateway/gateway.h"
-#include "gateway/server_stream.h"
 
 namespace ae::gw {
 namespace server_stream_manager_internal {
@@ -56,6 +56,7 @@ class RequestServerStreamGetAction : public StreamGetAction {
       : StreamGetAction{action_context},
         server_stream_manager_{&server_stream_manager},
         server_id_{server_id},
+        started_at_{Now()},
         state_{State::kCheckServerExists} {
     state_.changed_event().Subscribe([this](auto) { Action::Trigger(); });
   }
@@ -70,6 +71,8 @@ class RequestServerStreamGetAction : public StreamGetAction {
           RequestServer();
           break;
         case State::kResult:
+          server_stream_manager_->gateway_->latency_tracer().Record(
+              LatencyStage::kServerResolve, Now() - started_at_);
           return UpdateStatus::Result();
         case State::kError:
           return UpdateStatus::Error();
@@ -124,12 +127,17 @@ class RequestServerStreamGetAction : public StreamGetAction {
           server_stream_manager_->CacheStream(server_id_, stream_);
           state_ = State::kResult;
         }},
-        OnError{[this]() { state_ = State::kError; }},
+        OnError{[this]() {
+          server_stream_manager_->metrics_->Add(
+              server_stream_manager_->resolution_failures_);
+          state_ = State::kError;
+        }},
     });
   }
 
   ServerStreamManager* server_stream_manager_;
   ServerId server_id_;
+  TimePoint started_at_;
   StateMachine<State> state_;
   OwnActionPtr<GetServersAction> get_servers_action_;
 
@@ -139,7 +147,26 @@ class RequestServerStreamGetAction : public StreamGetAction {
 }  // namespace server_stream_manager_internal
 
 ServerStreamManager::ServerStreamManager(Gateway& gateway)
-    : gateway_{&gateway} {}
+    : gateway_{&gateway},
+      metrics_{&gateway_->metrics()},
+      resolution_failures_{metrics_->Register(
+          MetricsRegistry::Type::kCounter,
+          "gateway_server_resolution_failures_total",
+          "Servers failed to be resolved by id")} {
+  cached_servers_collector_ = metrics_->AddCollector(
+      MetricsRegistry::Type::kGauge, "gateway_cached_servers",
+      "Server streams in the stream cache", [this](auto& samples) {
+        auto const live = std::count_if(
+            std::begin(stream_cache_), std::end(stream_cache_),
+            [](auto const& entry) { return !entry.second.expired(); });
+        samples.push_back({"gateway_cached_servers", {},
+                           static_cast<std::int64_t>(live)});
+      });
+}
+
+ServerStreamManager::~ServerStreamManager() {
+  metrics_->RemoveCollector(cached_servers_collector_);
+}
 
 ActionPtr<StreamGetAction> ServerStreamManager::GetStream(ServerId server_id,
                                                           bool cache) {
@@ -165,6 +192,11 @@ ActionPtr<StreamGetAction> ServerStreamManager::GetStream(
       *gateway_, std::move(stream)};
 }
 
+void ServerStreamManager::SetMultiplexConfig(
+    MultiplexConfig const& multiplex_config) {
+  multiplex_config_ = multiplex_config;
+}
+
 Server::ptr ServerStreamManager::BuildServer(ServerId server_id,
                                              ServerEndpoints const& endpoints) {
   auto const& aether = gateway_->aether;
@@ -193,7 +225,8 @@ std::shared_ptr<ByteIStream> ServerStreamManager::MakeStream(
     Server::ptr server) {
   assert(server && "Server should not be null");
 
-  auto stream = std::make_shared<ServerStream>(*gateway_, std::move(server));
+  auto stream = std::make_shared<ServerStream>(*gateway_, std::move(server),
+                                               multiplex_config_);
   return stream;
 }
 
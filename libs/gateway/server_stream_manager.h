@@ -22,6 +22,9 @@
 
 #include "aether/all.h"
 
+#include "gateway/server_stream.h"
+#include "gateway/metrics_registry.h"
+
 namespace ae::gw {
 class Gateway;
 
@@ -45,6 +48,7 @@ class ServerStreamManager {
 
  public:
   explicit ServerStreamManager(Gateway& gateway);
+  ~ServerStreamManager();
 
   /**
    * \brief Get stream based on existing or newly resolved server by its id.
@@ -62,6 +66,11 @@ class ServerStreamManager {
    */
   ActionPtr<StreamGetAction> GetStream(ServerEndpoints const& server_endpoints);
 
+  /**
+   * \brief Set multiplexing config for newly created server streams.
+   */
+  void SetMultiplexConfig(MultiplexConfig const& multiplex_config);
+
  private:
   Server::ptr BuildServer(ServerId server_id, ServerEndpoints const& endpoints);
   std::shared_ptr<ByteIStream> MakeStream(Server::ptr server);
@@ -71,7 +80,11 @@ class ServerStreamManager {
   std::map<ServerId, std::weak_ptr<ByteIStream>>& OpenCache();
 
   Gateway* gateway_;
+  MultiplexConfig multiplex_config_;
   std::map<ServerId, std::weak_ptr<ByteIStream>> stream_cache_;
+  MetricsRegistry* metrics_;
+  MetricsRegistry::MetricId resolution_failures_;
+  MetricsRegistry::CollectorId cached_servers_collector_;
 };
 }  // namespace ae::gw
 
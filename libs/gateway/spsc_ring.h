@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_SPSC_RING_H_
+#define GATEWAY_SPSC_RING_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <optional>
+
+namespace ae::gw {
+/**
+ * \brief Bounded lock-free ring for exactly one producer and one consumer
+ * thread. Push is called only on the producer thread, Pop only on the
+ * consumer thread. Capacity is a power of two, the slots are reused and keep
+ * the moved from values.
+ */
+template <typename T, std::size_t Capacity>
+class SpscRing {
+  static_assert((Capacity != 0) && ((Capacity & (Capacity - 1)) == 0),
+                "Capacity must be a power of two");
+
+ public:
+  static constexpr std::size_t kCapacity = Capacity;
+
+  /**
+   * \brief Returns false if the ring is full, value is not moved then.
+   */
+  bool Push(T&& value) {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if ((head - tail_cache_) == Capacity) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if ((head - tail_cache_) == Capacity) {
+        return false;
+      }
+    }
+    slots_[head & kMask] = std::move(value);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::optional<T> Pop() {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_cache_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail == head_cache_) {
+        return std::nullopt;
+      }
+    }
+    auto value = std::optional<T>{std::move(slots_[tail & kMask])};
+    tail_.store(tail + 1, std::memory_order_release);
+    return value;
+  }
+
+  /**
+   * \brief Approximate if called concurrently with Push or Pop.
+   */
+  std::size_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr std::size_t kMask = Capacity - 1;
+  static constexpr std::size_t kCacheLine = 64;
+
+  std::array<T, Capacity> slots_{};
+  // written by the producer
+  alignas(kCacheLine) std::atomic<std::size_t> head_{};
+  std::size_t tail_cache_{};
+  // written by the consumer
+  alignas(kCacheLine) std::atomic<std::size_t> tail_{};
+  std::size_t head_cache_{};
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_SPSC_RING_H_
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway/trace_ring.h"
+
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+namespace ae::gw {
+namespace {
+constexpr std::uint8_t kMagic[] = {'A', 'E', 'T', 'R'};
+
+template <typename T>
+void PutLe(DataBuffer& buffer, T value) {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    buffer.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+  }
+}
+
+template <typename T>
+T GetLe(std::uint8_t const* data) {
+  T value{};
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<T>(static_cast<T>(data[i]) << (8 * i));
+  }
+  return value;
+}
+
+// the ring index is masked, so the capacity is a power of 2
+std::size_t RingCapacity(std::size_t capacity) {
+  std::size_t result = 1;
+  while (result < capacity) {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+TraceRing::TraceRing(Config const& config)
+    : started_at_{Now()},
+      records_(RingCapacity(config.capacity)),
+      mask_{records_.size() - 1},
+      sample_every_{std::max<std::uint32_t>(config.sample_every, 1)} {}
+
+void TraceRing::SetSampling(std::uint32_t sample_every) {
+  sample_every_ = std::max<std::uint32_t>(sample_every, 1);
+  sample_counter_ = 0;
+}
+
+DataBuffer TraceRing::Dump() const {
+  auto const count = static_cast<std::size_t>(
+      std::min<std::uint64_t>(written_, records_.size()));
+  DataBuffer dump;
+  dump.reserve(kHeaderSize + (count * kRecordSize));
+  dump.insert(std::end(dump), std::begin(kMagic), std::end(kMagic));
+  PutLe(dump, kVersion);
+  PutLe(dump, static_cast<std::uint16_t>(kRecordSize));
+  PutLe(dump, sample_every_);
+  PutLe(dump, events_);
+  PutLe(dump, static_cast<std::uint32_t>(count));
+  for (auto i = written_ - count; i < written_; ++i) {
+    auto const& record = records_[static_cast<std::size_t>(i) & mask_];
+    PutLe(dump, record.time_us);
+    PutLe(dump, static_cast<std::uint8_t>(record.event));
+    PutLe(dump, record.device_id);
+    PutLe(dump, record.size);
+    PutLe(dump, record.client_id);
+    PutLe(dump, record.server_id);
+  }
+  return dump;
+}
+
+std::optional<TraceRing::Dumped> TraceRing::Parse(DataBuffer const& dump) {
+  if ((dump.size() < kHeaderSize) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), std::begin(dump))) {
+    return std::nullopt;
+  }
+  auto const* data = dump.data();
+  auto const version = GetLe<std::uint16_t>(data + 4);
+  auto const record_size = GetLe<std::uint16_t>(data + 6);
+  // newer versions may only grow the record
+  if ((version == 0) || (record_size < kRecordSize)) {
+    return std::nullopt;
+  }
+  auto dumped = Dumped{GetLe<std::uint32_t>(data + 8),
+                       GetLe<std::uint64_t>(data + 12),
+                       {}};
+  auto const count = GetLe<std::uint32_t>(data + 20);
+  if ((dump.size() - kHeaderSize) / record_size < count) {
+    return std::nullopt;
+  }
+  dumped.records.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto const* record = data + kHeaderSize + (i * record_size);
+    dumped.records.push_back(TraceRecord{
+        GetLe<std::uint32_t>(record),
+        static_cast<TraceEvent>(record[4]),
+        record[5],
+        GetLe<std::uint16_t>(record + 6),
+        GetLe<std::uint32_t>(record + 8),
+        GetLe<std::uint32_t>(record + 12),
+    });
+  }
+  return dumped;
+}
+
+std::string_view TraceRing::EventName(TraceEvent event) {
+  switch (event) {
+    case TraceEvent::kNone:
+      return "none";
+    case TraceEvent::kLocalOutData:
+      return "local_out_data";
+    case TraceEvent::kSimPortPush:
+      return "sim_port_push";
+    case TraceEvent::kSimPortPublish:
+      return "sim_port_publish";
+    case TraceEvent::kSimDeviceToServer:
+      return "sim_device_to_server";
+    case TraceEvent::kSimDevicePush:
+      return "sim_device_push";
+  }
+  return "unknown";
+}
+
+void TraceRing::Write(TraceEvent event, std::uint8_t device_id,
+                      std::size_t size, std::uint32_t client_id,
+                      std::uint32_t server_id) {
+  auto const time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           Now() - started_at_)
+                           .count();
+  records_[static_cast<std::size_t>(written_) & mask_] = TraceRecord{
+      static_cast<std::uint32_t>(time_us),
+      event,
+      device_id,
+      static_cast<std::uint16_t>(std::min<std::size_t>(
+          size, std::numeric_limits<std::uint16_t>::max())),
+      client_id,
+      server_id,
+  };
+  ++written_;
+}
+}  // namespace ae::gw
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_TRACE_RING_H_
+#define GATEWAY_TRACE_RING_H_
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "aether/all.h"
+
+namespace ae::gw {
+/**
+ * \brief Packet events traced on the forwarding path.
+ */
+enum class TraceEvent : std::uint8_t {
+  kNone,
+  // LocalPort::OutData, data from the server stream to the device
+  kLocalOutData,
+  // simulator device port, data from the device to the gateway
+  kSimPortPush,
+  // simulator device port, data from the gateway to the device
+  kSimPortPublish,
+  // simulator device, data written to the server
+  kSimDeviceToServer,
+  // simulator device, data from the gateway
+  kSimDevicePush,
+};
+
+/**
+ * \brief Fixed size record of a traced event.
+ * Time is in us since the ring is made and wraps in about 71 minutes, ids
+ * are 0 if not known for the event.
+ */
+struct TraceRecord {
+  std::uint32_t time_us;
+  TraceEvent event;
+  std::uint8_t device_id;
+  // saturated at 0xFFFF
+  std::uint16_t size;
+  std::uint32_t client_id;
+  std::uint32_t server_id;
+};
+
+/**
+ * \brief Ring of binary trace records, the oldest records are overwritten.
+ * Tracing an event is a few stores without formatting, so it may stay on in
+ * production, 1 in sample_every events is recorded. The ring is dumped in
+ * the binary format and formatted offline by the trace decoder.
+ * Dump format, little endian: "AETR" magic, u16 version, u16 record size,
+ * u32 sample_every, u64 events traced, u32 records count, then records from
+ * the oldest as u32 time_us, u8 event, u8 device_id, u16 size, u32
+ * client_id, u32 server_id.
+ * The ring is written and dumped on one thread.
+ */
+class TraceRing {
+ public:
+  static constexpr std::uint16_t kVersion = 1;
+  static constexpr std::size_t kRecordSize = 16;
+  static constexpr std::size_t kHeaderSize = 24;
+
+  struct Config {
+    // rounded up to a power of 2
+    std::size_t capacity;
+    std::uint32_t sample_every;
+  };
+
+#if defined(ESP_PLATFORM)
+  static constexpr Config kDefaultConfig{256, 1};
+#else
+  static constexpr Config kDefaultConfig{4096, 1};
+#endif
+
+  struct Dumped {
+    std::uint32_t sample_every;
+    std::uint64_t events;
+    std::vector<TraceRecord> records;
+  };
+
+  explicit TraceRing(Config const& config = kDefaultConfig);
+
+  void Trace(TraceEvent event, std::uint8_t device_id, std::size_t size,
+             std::uint32_t client_id = 0, std::uint32_t server_id = 0) {
+    ++events_;
+    if (++sample_counter_ < sample_every_) {
+      return;
+    }
+    sample_counter_ = 0;
+    Write(event, device_id, size, client_id, server_id);
+  }
+
+  void SetSampling(std::uint32_t sample_every);
+
+  /**
+   * \brief Binary dump of the records in the ring.
+   */
+  DataBuffer Dump() const;
+  /**
+   * \brief Records of the binary dump, nullopt if the dump is malformed.
+   */
+  static std::optional<Dumped> Parse(DataBuffer const& dump);
+  static std::string_view EventName(TraceEvent event);
+
+ private:
+  void Write(TraceEvent event, std::uint8_t device_id, std::size_t size,
+             std::uint32_t client_id, std::uint32_t server_id);
+
+  TimePoint started_at_;
+  std::vector<TraceRecord> records_;
+  std::size_t mask_;
+  std::uint32_t sample_every_;
+  std::uint32_t sample_counter_{};
+  // records written, the next one goes to written_ & mask_
+  std::uint64_t written_{};
+  // events traced including the not sampled ones
+  std::uint64_t events_{};
+};
+}  // namespace ae::gw
+
+#endif  // GATEWAY_TRACE_RING_H_
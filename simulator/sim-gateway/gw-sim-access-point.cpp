@@ -47,8 +47,10 @@ Aether::ptr const& GwSimAccessPoint::aether() const { return aether_; }
 
 GwSimDevice& GwSimAccessPoint::gw_device() {
   if (!gw_device_) {
+    auto gw_sim_adapter = adapter_.as<GwSimAdapter>();
     gw_device_ = std::make_unique<GwSimDevice>(
-        *aether_, adapter_.as<GwSimAdapter>()->data_bus());
+        *aether_, gw_sim_adapter->data_bus(),
+        gw_sim_adapter->device_encoding());
   }
   return *gw_device_;
 }
@@ -19,7 +19,13 @@
 namespace ae::gw::sim {
 GwSimAdapter::GwSimAdapter(GwSimDataBus& data_bus, Aether::ptr aether,
                            Domain* domain)
-    : Adapter{domain}, data_bus_{&data_bus} {
+    : GwSimAdapter{data_bus, std::move(aether),
+                   GwSimDevice::Encoding::kFullIds, domain} {}
+
+GwSimAdapter::GwSimAdapter(GwSimDataBus& data_bus, Aether::ptr aether,
+                           GwSimDevice::Encoding device_encoding,
+                           Domain* domain)
+    : Adapter{domain}, data_bus_{&data_bus}, device_encoding_{device_encoding} {
   access_point_ = domain->CreateObj<GwSimAccessPoint>(
       std::move(aether), Adapter::ptr{MakePtrFromThis(this)});
 }
@@ -30,4 +36,8 @@ std::vector<AccessPoint::ptr> GwSimAdapter::access_points() {
 
 GwSimDataBus& GwSimAdapter::data_bus() { return *data_bus_; }
 
+GwSimDevice::Encoding GwSimAdapter::device_encoding() const {
+  return device_encoding_;
+}
+
 }  // namespace ae::gw::sim
@@ -30,16 +30,20 @@ class GwSimAdapter final : public Adapter {
 
  public:
   GwSimAdapter(GwSimDataBus& data_bus, Aether::ptr aether, Domain* domain);
+  GwSimAdapter(GwSimDataBus& data_bus, Aether::ptr aether,
+               GwSimDevice::Encoding device_encoding, Domain* domain);
 
   AE_OBJECT_REFLECT(AE_MMBRS(access_point_))
 
   std::vector<AccessPoint::ptr> access_points() override;
 
   GwSimDataBus& data_bus();
+  GwSimDevice::Encoding device_encoding() const;
 
  private:
   GwSimAccessPoint::ptr access_point_;
   GwSimDataBus* data_bus_;
+  GwSimDevice::Encoding device_encoding_{GwSimDevice::Encoding::kFullIds};
 };
 }  // namespace ae::gw::sim
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sim-gateway/gw-sim-alice-bob.h"
+
+#include <utility>
+#include <algorithm>
+
+#include "gateway/local_port.h"
+
+#include "sim-gateway/gw-sim-adapter.h"
+
+namespace ae::gw::sim {
+static constexpr Uid kParentUid =
+    Uid::FromString("3ac93165-3d37-4970-87a6-fa4ee27744e4");
+
+GwSimAliceBob::GwSimAliceBob(GwSimDevice::Encoding encoding)
+    : encoding_{encoding} {}
+
+int GwSimAliceBob::Run(SelectedHandler on_selected, DoneCheck done) {
+  // make aether gateway
+  gateway_app_ = AetherApp::Construct(AetherAppContext{});
+  auto select_gw_client = gateway_app_->aether()->SelectClient(kParentUid, 0);
+
+  gateway_app_->WaitActions(select_gw_client);
+  auto gw_client = select_gw_client->client();
+  if (!gw_client) {
+    return -1;
+  }
+
+  gateway_ = gateway_app_->domain().CreateObj<Gateway>(
+      ObjId{1337}, gateway_app_->aether(), std::move(gw_client));
+
+  // connect gateway sim data bus
+  device_port_.emplace(data_bus_, gateway_->local_port());
+
+  // make aether client side
+  client_app_ = AetherApp::Construct(
+      AetherAppContext{}.AdaptersFactory([&](AetherAppContext const& context) {
+        auto adapters = context.domain().CreateObj<AdapterRegistry>();
+        adapters->Add(context.domain().CreateObj<GwSimAdapter>(
+            data_bus_, context.aether(), encoding_));
+        return adapters;
+      }));
+
+  auto select_alice = client_app_->aether()->SelectClient(kParentUid, 0);
+  select_alice->StatusEvent().Subscribe(
+      OnResult{[&](auto const& action) { alice_ = action.client(); }});
+
+  auto select_bob = client_app_->aether()->SelectClient(kParentUid, 1);
+  select_bob->StatusEvent().Subscribe(
+      OnResult{[&](auto const& action) { bob_ = action.client(); }});
+
+  auto comm_event = CumulativeEvent{
+      select_alice->StatusEvent(),
+      select_bob->StatusEvent(),
+  };
+
+  comm_event.Subscribe([&]() {
+    if (!alice_ || !bob_) {
+      return;
+    }
+    on_selected(alice_, bob_);
+  });
+
+  // make two apps use common trigger
+  auto& gateway_trigger =
+      gateway_app_->aether()->action_processor->get_trigger();
+  auto& client_trigger =
+      client_app_->aether()->action_processor->get_trigger();
+  Merge(gateway_trigger, client_trigger);
+
+  // run common update loop
+  while (!gateway_app_->IsExited() && !client_app_->IsExited()) {
+    auto gateway_time = gateway_app_->Update(Now());
+    auto client_time = client_app_->Update(Now());
+
+    gateway_app_->WaitUntil(std::min(gateway_time, client_time));
+
+    if (done()) {
+      client_app_->Exit(0);
+    }
+  }
+
+  if (client_app_->IsExited()) {
+    auto code = client_app_->ExitCode();
+    return code != 0 ? (100 + code) : 0;
+  }
+
+  return gateway_app_->ExitCode();
+}
+
+void GwSimAliceBob::Trigger() {
+  client_app_->aether()->action_processor->get_trigger().Trigger();
+}
+
+GwSimDataBus& GwSimAliceBob::data_bus() { return data_bus_; }
+
+Gateway& GwSimAliceBob::gateway() { return *gateway_; }
+}  // namespace ae::gw::sim
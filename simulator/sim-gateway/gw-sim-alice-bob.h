@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIM_GATEWAY_GW_SIM_ALICE_BOB_H_
+#define SIM_GATEWAY_GW_SIM_ALICE_BOB_H_
+
+#include <optional>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "gateway/gateway.h"
+
+#include "sim-gateway/gw-sim-device.h"
+#include "sim-gateway/gw-sim-data-bus.h"
+#include "sim-gateway/gw-sim-device-port.h"
+
+namespace ae::gw::sim {
+/**
+ * \brief Gateway and its two clients, alice and bob, on the sim data bus.
+ * Both clients are devices of the gateway. The scenario gets them once they
+ * are selected and the apps run on the common update loop until it is done.
+ */
+class GwSimAliceBob {
+ public:
+  using SelectedHandler =
+      std::function<void(Client::ptr const& alice, Client::ptr const& bob)>;
+  using DoneCheck = std::function<bool()>;
+
+  explicit GwSimAliceBob(
+      GwSimDevice::Encoding encoding = GwSimDevice::Encoding::kFullIds);
+
+  /**
+   * \brief Run the gateway and the clients until done returns true.
+   * on_selected is called once both clients are selected.
+   * \return 0 on success, -1 if the gateway client is not selected, 100 plus
+   * the client app exit code or the gateway app exit code otherwise.
+   */
+  int Run(SelectedHandler on_selected, DoneCheck done);
+
+  /**
+   * \brief Wake the common update loop, call it on each received message.
+   */
+  void Trigger();
+
+  GwSimDataBus& data_bus();
+  /**
+   * \brief The gateway, valid from on_selected call.
+   */
+  Gateway& gateway();
+
+ private:
+  GwSimDevice::Encoding encoding_;
+  GwSimDataBus data_bus_;
+  RcPtr<AetherApp> gateway_app_;
+  Gateway::ptr gateway_;
+  std::optional<GwSimDevicePort> device_port_;
+  RcPtr<AetherApp> client_app_;
+  Client::ptr alice_;
+  Client::ptr bob_;
+};
+}  // namespace ae::gw::sim
+
+#endif  // SIM_GATEWAY_GW_SIM_ALICE_BOB_H_
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sim-gateway/gw-sim-compact-api.h"
+
+namespace ae::gw::sim {
+GwSimCompactApi::GwSimCompactApi(ProtocolContext& protocol_context)
+    : ApiClass{protocol_context},
+      bind_stream{protocol_context},
+      bind_stream_endpoints{protocol_context},
+      to_stream{protocol_context} {}
+
+void GwSimCompactClientApi::FromServer(ClientId client_id, DataBuffer data) {
+  from_server_event_.Emit(client_id, data);
+}
+
+void GwSimCompactClientApi::FromStream(std::uint8_t stream_index,
+                                       DataBuffer data) {
+  from_stream_event_.Emit(stream_index, data);
+}
+
+void GwSimCompactClientApi::UnknownStream(std::uint8_t stream_index) {
+  unknown_stream_event_.Emit(stream_index);
+}
+
+GwSimCompactClientApi::FromServerEvent::Subscriber
+GwSimCompactClientApi::from_server_event() {
+  return EventSubscriber{from_server_event_};
+}
+
+GwSimCompactClientApi::FromStreamEvent::Subscriber
+GwSimCompactClientApi::from_stream_event() {
+  return EventSubscriber{from_stream_event_};
+}
+
+GwSimCompactClientApi::UnknownStreamEvent::Subscriber
+GwSimCompactClientApi::unknown_stream_event() {
+  return EventSubscriber{unknown_stream_event_};
+}
+}  // namespace ae::gw::sim
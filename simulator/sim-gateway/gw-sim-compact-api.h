@@ -0,0 +1,73 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIM_GATEWAY_GW_SIM_COMPACT_API_H_
+#define SIM_GATEWAY_GW_SIM_COMPACT_API_H_
+
+#include <cstdint>
+
+#include "aether/all.h"
+
+namespace ae::gw::sim {
+/**
+ * \brief Device side of gw::GatewayApi stream index methods.
+ */
+class GwSimCompactApi : public ApiClass {
+ public:
+  explicit GwSimCompactApi(ProtocolContext& protocol_context);
+
+  Method<5, void(std::uint8_t stream_index, ClientId client_id,
+                 ServerId server_id)>
+      bind_stream;
+  Method<6, void(std::uint8_t stream_index, ClientId client_id,
+                 ServerEndpoints endpoints)>
+      bind_stream_endpoints;
+  Method<7, void(std::uint8_t stream_index, DataBuffer data)> to_stream;
+};
+
+/**
+ * \brief Device side parser of gw::ClientApi with stream index methods.
+ */
+class GwSimCompactClientApi : public ApiClassImpl<GwSimCompactClientApi> {
+ public:
+  using FromServerEvent =
+      Event<void(ClientId client_id, DataBuffer const& data)>;
+  using FromStreamEvent =
+      Event<void(std::uint8_t stream_index, DataBuffer const& data)>;
+  using UnknownStreamEvent = Event<void(std::uint8_t stream_index)>;
+
+  using ApiClassImpl::ApiClassImpl;
+
+  void FromServer(ClientId client_id, DataBuffer data);
+  void FromStream(std::uint8_t stream_index, DataBuffer data);
+  void UnknownStream(std::uint8_t stream_index);
+
+  AE_METHODS(RegMethod<3, &GwSimCompactClientApi::FromServer>,
+             RegMethod<4, &GwSimCompactClientApi::FromStream>,
+             RegMethod<5, &GwSimCompactClientApi::UnknownStream>);
+
+  FromServerEvent::Subscriber from_server_event();
+  FromStreamEvent::Subscriber from_stream_event();
+  UnknownStreamEvent::Subscriber unknown_stream_event();
+
+ private:
+  FromServerEvent from_server_event_;
+  FromStreamEvent from_stream_event_;
+  UnknownStreamEvent unknown_stream_event_;
+};
+}  // namespace ae::gw::sim
+
+#endif  // SIM_GATEWAY_GW_SIM_COMPACT_API_H_
@@ -23,12 +23,16 @@
 namespace ae::gw::sim {
 void GwSimDataBus::PublishDeviceData(DeviceId from_device,
                                      DataBuffer const& data) {
+  stats_.device_frames++;
+  stats_.device_bytes += data.size();
   for (auto const& gw : gateway_listeners_) {
     gw->PushData(from_device, data);
   }
 }
 
 void GwSimDataBus::PublishGwData(DeviceId to_device, DataBuffer const& data) {
+  stats_.gateway_frames++;
+  stats_.gateway_bytes += data.size();
   auto it = device_listeners_.find(to_device);
   if (it == std::end(device_listeners_)) {
     return;
@@ -58,6 +62,12 @@ void GwSimDataBus::RemoveGatewayListener(GatewayListener* listener) {
   }
 }
 
+GwSimDataBus::Stats const& GwSimDataBus::stats() const { return stats_; }
+
+void GwSimDataBus::SetTraceRing(TraceRing* trace_ring) {
+  trace_ring_ = trace_ring;
+}
+
 DeviceId GwSimDataBus::GetDeviceId() {
   auto id = next_device_id_++;
   assert((id < std::numeric_limits<DeviceId>::max()) && "Device ID overflow");
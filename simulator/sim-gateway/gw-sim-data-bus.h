@@ -22,6 +22,8 @@
 
 #include "aether/types/data_buffer.h"
 
+#include "gateway/trace_ring.h"
+
 namespace ae::gw::sim {
 using DeviceId = std::uint8_t;
 
@@ -46,6 +48,13 @@ class GatewayListener {
  */
 class GwSimDataBus {
  public:
+  struct Stats {
+    std::size_t device_frames{};
+    std::size_t device_bytes{};
+    std::size_t gateway_frames{};
+    std::size_t gateway_bytes{};
+  };
+
   void PublishDeviceData(DeviceId from_device, DataBuffer const& data);
   void PublishGwData(DeviceId to_device, DataBuffer const& data);
 
@@ -54,12 +63,27 @@ class GwSimDataBus {
   void RegGatewayListener(GatewayListener* listener);
   void RemoveGatewayListener(GatewayListener* listener);
 
+  Stats const& stats() const;
+
+  /**
+   * \brief Trace the devices and the ports to trace_ring, nullptr to stop.
+   */
+  void SetTraceRing(TraceRing* trace_ring);
+  void Trace(TraceEvent event, DeviceId device_id, std::size_t size,
+             std::uint32_t client_id = 0, std::uint32_t server_id = 0) {
+    if (trace_ring_ != nullptr) {
+      trace_ring_->Trace(event, device_id, size, client_id, server_id);
+    }
+  }
+
  private:
   DeviceId GetDeviceId();
 
   DeviceId next_device_id_ = 1;
   std::map<DeviceId, DeviceListener*> device_listeners_;
   std::vector<GatewayListener*> gateway_listeners_;
+  Stats stats_;
+  TraceRing* trace_ring_{};
 };
 }  // namespace ae::gw::sim
 
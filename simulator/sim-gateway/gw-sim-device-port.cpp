@@ -16,17 +16,15 @@
 
 #include "sim-gateway/gw-sim-device-port.h"
 
-#include "aether/tele/tele.h"
-
 namespace ae::gw::sim {
 GwSimDevicePort::GwSimDevicePort(GwSimDataBus& gw_sim_data_bus,
-                                 LocalPort& local_port)
-    : gw_sim_data_bus_{&gw_sim_data_bus}, local_port_{&local_port} {
+                                 ILocalLink& local_link)
+    : gw_sim_data_bus_{&gw_sim_data_bus}, local_link_{&local_link} {
   gw_sim_data_bus_->RegGatewayListener(this);
-  output_sub_ = local_port_->output_event().Subscribe(
+  output_sub_ = local_link_->output_event().Subscribe(
       [this](auto device_id, auto const& data) {
-        AE_TELED_DEBUG("Publish data from gateway to {} {}",
-                       static_cast<int>(device_id), data);
+        gw_sim_data_bus_->Trace(TraceEvent::kSimPortPublish, device_id,
+                                data.size());
         gw_sim_data_bus_->PublishGwData(device_id, data);
       });
 }
@@ -36,8 +34,7 @@ GwSimDevicePort::~GwSimDevicePort() {
 }
 
 void GwSimDevicePort::PushData(DeviceId device_id, DataBuffer const& data) {
-  AE_TELED_DEBUG("Push from device id {} with data {}",
-                 static_cast<int>(device_id), data)
-  local_port_->Input(device_id, data);
+  gw_sim_data_bus_->Trace(TraceEvent::kSimPortPush, device_id, data.size());
+  local_link_->Input(device_id, data);
 }
 }  // namespace ae::gw::sim
@@ -17,21 +17,21 @@
 #ifndef SIM_GATEWAY_GW_SIM_DEVICE_PORT_H_
 #define SIM_GATEWAY_GW_SIM_DEVICE_PORT_H_
 
-#include "gateway/local_port.h"
+#include "gateway/local_link.h"
 
 #include "sim-gateway/gw-sim-data-bus.h"
 
 namespace ae::gw::sim {
 class GwSimDevicePort final : public GatewayListener {
  public:
-  GwSimDevicePort(GwSimDataBus& gw_sim_data_bus, LocalPort& local_port);
+  GwSimDevicePort(GwSimDataBus& gw_sim_data_bus, ILocalLink& local_link);
   ~GwSimDevicePort() override;
 
   void PushData(DeviceId device_id, DataBuffer const& data) override;
 
  private:
   GwSimDataBus* gw_sim_data_bus_;
-  LocalPort* local_port_;
+  ILocalLink* local_link_;
   Subscription output_sub_;
 };
 }  // namespace ae::gw::sim
@@ -30,12 +30,33 @@ class GwStreamWriteAction final : public StreamWriteAction {
 }  // namespace gw_sim_device_internal
 
 GwSimDevice::GwSimDevice(ActionContext action_context,
-                         GwSimDataBus& gw_sim_data_bus)
+                         GwSimDataBus& gw_sim_data_bus, Encoding encoding)
     : action_context_{action_context},
       gw_sim_data_bus_{&gw_sim_data_bus},
       device_id_{gw_sim_data_bus_->RegDeviceListener(this)},
+      encoding_{encoding},
       gateway_api_{protocol_context_},
-      gateway_client_api_{protocol_context_} {}
+      gateway_client_api_{protocol_context_},
+      client_api_{protocol_context_},
+      compact_api_{protocol_context_},
+      compact_client_api_{protocol_context_} {
+  from_server_sub_ = compact_client_api_.from_server_event().Subscribe(
+      [this](auto client_id, auto const& data) {
+        FromServer(client_id, data);
+      });
+  from_stream_sub_ = compact_client_api_.from_stream_event().Subscribe(
+      [this](auto stream_index, auto const& data) {
+        auto it = stream_bindings_.find(stream_index);
+        if (it == std::end(stream_bindings_)) {
+          AE_TELED_ERROR("Unknown stream index {}",
+                         static_cast<int>(stream_index));
+          return;
+        }
+        FromServer(it->second.client_id, data);
+      });
+  unknown_stream_sub_ = compact_client_api_.unknown_stream_event().Subscribe(
+      [this](auto stream_index) { UnknownStream(stream_index); });
+}
 
 GwSimDevice::~GwSimDevice() {
   gw_sim_data_bus_->RemoveDeviceListener(device_id_);
@@ -44,14 +65,18 @@ GwSimDevice::~GwSimDevice() {
 ActionPtr<StreamWriteAction> GwSimDevice::ToServer(ClientId client_id,
                                                    ServerId server_id,
                                                    DataBuffer&& data) {
-  auto api = ApiContext{gateway_api_};
-  api->to_server_id(client_id, server_id, std::move(data));
-  DataBuffer packet = std::move(api);
-
-  AE_TELED_DEBUG("Publish from device_id {} data {}",
-                 static_cast<int>(device_id_), packet);
+  gw_sim_data_bus_->Trace(TraceEvent::kSimDeviceToServer, device_id_,
+                          data.size(), client_id, server_id);
+  if (encoding_ == Encoding::kCompactIds) {
+    auto [stream_index, bind] = StreamIndex(
+        client_id, static_cast<std::size_t>(server_id), server_id);
+    ToStream(stream_index, bind, std::move(data));
+  } else {
+    auto api = ApiContext{gateway_api_};
+    api->to_server_id(client_id, server_id, std::move(data));
+    Publish(DataBuffer{std::move(api)});
+  }
 
-  gw_sim_data_bus_->PublishDeviceData(device_id_, packet);
   return ActionPtr<gw_sim_device_internal::GwStreamWriteAction>{
       action_context_};
 }
@@ -59,14 +84,20 @@ ActionPtr<StreamWriteAction> GwSimDevice::ToServer(ClientId client_id,
 ActionPtr<StreamWriteAction> GwSimDevice::ToServer(
     ClientId client_id, ServerEndpoints const& server_endpoints,
     DataBuffer&& data) {
-  auto api = ApiContext{gateway_api_};
-  api->to_server(client_id, server_endpoints, std::move(data));
-  DataBuffer packet = std::move(api);
-
-  AE_TELED_DEBUG("Publish from device_id {} data {}",
-                 static_cast<int>(device_id_), packet);
+  auto const server_identity = std::hash<ServerEndpoints>{}(server_endpoints);
+  gw_sim_data_bus_->Trace(TraceEvent::kSimDeviceToServer, device_id_,
+                          data.size(), client_id,
+                          static_cast<std::uint32_t>(server_identity));
+  if (encoding_ == Encoding::kCompactIds) {
+    auto [stream_index, bind] =
+        StreamIndex(client_id, server_identity, server_endpoints);
+    ToStream(stream_index, bind, std::move(data));
+  } else {
+    auto api = ApiContext{gateway_api_};
+    api->to_server(client_id, server_endpoints, std::move(data));
+    Publish(DataBuffer{std::move(api)});
+  }
 
-  gw_sim_data_bus_->PublishDeviceData(device_id_, packet);
   return ActionPtr<gw_sim_device_internal::GwStreamWriteAction>{
       action_context_};
 }
@@ -76,8 +107,80 @@ GwSimDevice::FromServerEvent::Subscriber GwSimDevice::from_server_event() {
 }
 
 void GwSimDevice::PushData(DataBuffer const& data) {
-  AE_TELED_DEBUG("Push data from gateway {}", data);
+  gw_sim_data_bus_->Trace(TraceEvent::kSimDevicePush, device_id_, data.size());
   auto parser = ApiParser{protocol_context_, data};
+  if (encoding_ == Encoding::kCompactIds) {
+    parser.Parse(compact_client_api_);
+  } else {
+    parser.Parse(gateway_client_api_);
+  }
+}
+
+void GwSimDevice::Publish(DataBuffer const& packet) {
+  gw_sim_data_bus_->PublishDeviceData(device_id_, packet);
+}
+
+std::pair<std::uint8_t, bool> GwSimDevice::StreamIndex(
+    ClientId client_id, std::size_t server_identity, ServeKind const& server) {
+  auto key = std::pair{client_id, server_identity};
+  auto it = stream_indexes_.find(key);
+  if (it != std::end(stream_indexes_)) {
+    return {it->second, false};
+  }
+
+  auto stream_index = next_stream_index_++;
+  // the index is reused after overflow, forget the old binding
+  for (auto i = std::begin(stream_indexes_); i != std::end(stream_indexes_);
+       ++i) {
+    if (i->second == stream_index) {
+      stream_indexes_.erase(i);
+      break;
+    }
+  }
+  stream_indexes_.emplace(key, stream_index);
+  stream_bindings_[stream_index] = StreamBinding{client_id, server, {}};
+  return {stream_index, true};
+}
+
+void GwSimDevice::ToStream(std::uint8_t stream_index, bool bind,
+                           DataBuffer&& data) {
+  auto& binding = stream_bindings_.at(stream_index);
+  binding.last_data = data;
+  auto api = ApiContext{compact_api_};
+  if (bind) {
+    std::visit(reflect::OverrideFunc{
+                   [&](ServerId server_id) {
+                     api->bind_stream(stream_index, binding.client_id,
+                                      server_id);
+                   },
+                   [&](ServerEndpoints const& server_endpoints) {
+                     api->bind_stream_endpoints(
+                         stream_index, binding.client_id, server_endpoints);
+                   }},
+               binding.server);
+  }
+  api->to_stream(stream_index, std::move(data));
+  Publish(DataBuffer{std::move(api)});
+}
+
+void GwSimDevice::UnknownStream(std::uint8_t stream_index) {
+  // the gateway evicted the stream, bind the same index again and resend
+  auto it = stream_bindings_.find(stream_index);
+  if (it == std::end(stream_bindings_)) {
+    AE_TELED_ERROR("Unknown stream index {}", static_cast<int>(stream_index));
+    return;
+  }
+  AE_TELED_DEBUG("Rebind stream index {}", static_cast<int>(stream_index));
+  ToStream(stream_index, true, DataBuffer{it->second.last_data});
+}
+
+void GwSimDevice::FromServer(ClientId client_id, DataBuffer const& data) {
+  // pass the data to the regular gateway client api
+  auto api = ApiContext{client_api_};
+  api->from_server(client_id, data);
+  DataBuffer packet = std::move(api);
+
+  auto parser = ApiParser{protocol_context_, packet};
   parser.Parse(gateway_client_api_);
 }
 }  // namespace ae::gw::sim
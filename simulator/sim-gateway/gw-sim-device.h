@@ -17,6 +17,9 @@
 #ifndef SIM_GATEWAY_GW_SIM_DEVICE_H_
 #define SIM_GATEWAY_GW_SIM_DEVICE_H_
 
+#include <map>
+#include <utility>
+#include <variant>
 #include <cstdint>
 
 #include "aether/types/server_id.h"
@@ -24,13 +27,26 @@
 #include "aether/gateway_api/gateway_api.h"
 #include "aether/transport/gateway/gateway_device.h"
 
+#include "gateway/api/client_api.h"
+
 #include "sim-gateway/gw-sim-data-bus.h"
+#include "sim-gateway/gw-sim-compact-api.h"
 
 namespace ae::gw::sim {
 class GwSimDevice final : public IGatewayDevice, public DeviceListener {
  public:
+  /**
+   * \brief How the device addresses client and server in each frame.
+   * kCompactIds binds a one byte stream index on the first frame.
+   */
+  enum class Encoding : std::uint8_t {
+    kFullIds,
+    kCompactIds,
+  };
+
   explicit GwSimDevice(ActionContext action_context,
-                       GwSimDataBus& gw_sim_data_bus);
+                       GwSimDataBus& gw_sim_data_bus,
+                       Encoding encoding = Encoding::kFullIds);
   ~GwSimDevice() override;
 
   ActionPtr<StreamWriteAction> ToServer(ClientId client_id, ServerId server_id,
@@ -45,13 +61,41 @@ class GwSimDevice final : public IGatewayDevice, public DeviceListener {
   void PushData(DataBuffer const& data) override;
 
  private:
+  using ServeKind = std::variant<ServerId, ServerEndpoints>;
+
+  struct StreamBinding {
+    ClientId client_id;
+    ServeKind server;
+    // resent if the gateway does not know the stream index
+    DataBuffer last_data;
+  };
+
+  void Publish(DataBuffer const& packet);
+  std::pair<std::uint8_t, bool> StreamIndex(ClientId client_id,
+                                            std::size_t server_identity,
+                                            ServeKind const& server);
+  void ToStream(std::uint8_t stream_index, bool bind, DataBuffer&& data);
+  void UnknownStream(std::uint8_t stream_index);
+  void FromServer(ClientId client_id, DataBuffer const& data);
+
   ActionContext action_context_;
   GwSimDataBus* gw_sim_data_bus_;
   DeviceId device_id_;
+  Encoding encoding_;
 
   ProtocolContext protocol_context_;
   GatewayApi gateway_api_;
   GatewayClientApi gateway_client_api_;
+
+  gw::ClientApi client_api_;
+  GwSimCompactApi compact_api_;
+  GwSimCompactClientApi compact_client_api_;
+  Subscription from_server_sub_;
+  Subscription from_stream_sub_;
+  Subscription unknown_stream_sub_;
+  std::uint8_t next_stream_index_{};
+  std::map<std::pair<ClientId, std::size_t>, std::uint8_t> stream_indexes_;
+  std::map<std::uint8_t, StreamBinding> stream_bindings_;
 };
 }  // namespace ae::gw::sim
 
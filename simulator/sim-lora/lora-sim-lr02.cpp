@@ -0,0 +1,332 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sim-lora/lora-sim-lr02.h"
+
+#include <array>
+#include <utility>
+#include <algorithm>
+
+#include "lora_gateways/lora_airtime.h"
+
+namespace ae::gw::sim {
+namespace {
+constexpr std::string_view kAtModeToggle = "+++";
+// address high, address low and channel
+constexpr std::size_t kFixedPointPrefixSize = 3;
+
+// AT+BAUDn argument for each kBaudRate, starts from 1
+constexpr std::array kAtBaudRates{
+    kBaudRate::kBaudRate1200,   kBaudRate::kBaudRate2400,
+    kBaudRate::kBaudRate4800,   kBaudRate::kBaudRate9600,
+    kBaudRate::kBaudRate19200,  kBaudRate::kBaudRate38400,
+    kBaudRate::kBaudRate57600,  kBaudRate::kBaudRate115200,
+    kBaudRate::kBaudRate128000,
+};
+
+constexpr std::array kAtBandWidths{
+    kLoraGatewayBandWidth::kBandWidth125K,
+    kLoraGatewayBandWidth::kBandWidth250K,
+    kLoraGatewayBandWidth::kBandWidth500K,
+};
+
+std::optional<int> CommandArgument(std::string_view command,
+                                   std::string_view name) {
+  if (command.substr(0, name.size()) != name) {
+    return std::nullopt;
+  }
+  auto const arg = command.substr(name.size());
+  if (arg.empty() || (arg.size() > 2) ||
+      !std::all_of(std::begin(arg), std::end(arg),
+                   [](char c) { return (c >= '0') && (c <= '9'); })) {
+    return std::nullopt;
+  }
+  int value = 0;
+  for (auto c : arg) {
+    value = value * 10 + (c - '0');
+  }
+  return value;
+}
+}  // namespace
+
+LoraSimLr02Port::LoraSimLr02Port(LoraSimLr02& module, kBaudRate baud_rate)
+    : module_{&module}, baud_rate_{baud_rate} {}
+
+LoraSimLr02Port::~LoraSimLr02Port() { module_->ClosePort(*this); }
+
+void LoraSimLr02Port::Write(DataBuffer const& data) {
+  module_->HostWrite(*this, data);
+}
+
+LoraSimLr02Port::DataReadEvent::Subscriber LoraSimLr02Port::read_event() {
+  return EventSubscriber{read_event_};
+}
+
+bool LoraSimLr02Port::IsOpen() { return module_->port_ == this; }
+
+kBaudRate LoraSimLr02Port::baud_rate() const { return baud_rate_; }
+
+LoraSimLr02::LoraSimLr02(ActionContext action_context, Config config)
+    : config_{config},
+      baud_rate_{config_.baud_rate},
+      serial_free_at_{Now()},
+      air_free_at_{Now()},
+      update_action_{action_context,
+                     [this](auto now) { return Update(now); }} {}
+
+std::unique_ptr<ISerialPort> LoraSimLr02::OpenPort(
+    SerialInit const& serial_init) {
+  auto port = std::make_unique<LoraSimLr02Port>(*this, serial_init.baud_rate);
+  port_ = port.get();
+  return port;
+}
+
+void LoraSimLr02::AirReceive(DataBuffer const& data) {
+  if (at_mode_) {
+    AE_TELED_DEBUG("LR02 sim: air packet dropped in AT mode");
+    return;
+  }
+  ToHost(data, Now() + LoraAirtime::Calculate(psp_, data.size()));
+  update_action_->Reschedule();
+}
+
+LoraSimLr02::AirEvent::Subscriber LoraSimLr02::air_event() {
+  return EventSubscriber{air_event_};
+}
+
+kBaudRate LoraSimLr02::baud_rate() const { return baud_rate_; }
+
+bool LoraSimLr02::at_mode() const { return at_mode_; }
+
+LoraGatewayPowerSaveParam const& LoraSimLr02::psp() const { return psp_; }
+
+std::size_t LoraSimLr02::at_commands() const { return at_commands_; }
+
+std::uint32_t LoraSimLr02::BaudRateValue(kBaudRate baud_rate) {
+  static constexpr std::array<std::uint32_t, kAtBaudRates.size()> kValues{
+      1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 128000};
+  for (std::size_t i = 0; i < kAtBaudRates.size(); ++i) {
+    if (kAtBaudRates[i] == baud_rate) {
+      return kValues[i];
+    }
+  }
+  return 9600;
+}
+
+void LoraSimLr02::HostWrite(LoraSimLr02Port const& port,
+                            DataBuffer const& data) {
+  if (port_ != &port) {
+    return;
+  }
+  if (port.baud_rate() != baud_rate_) {
+    // the module sees only garbage on the line
+    AE_TELED_DEBUG("LR02 sim: {} bytes lost, baud rate mismatch",
+                   data.size());
+    return;
+  }
+  auto const received_at = Now() + TransferTime(data.size());
+  std::string_view const text{reinterpret_cast<char const*>(data.data()),
+                              data.size()};
+
+  if (!at_mode_) {
+    auto const line = text.substr(0, text.find_first_of("\r\n"));
+    if (line == kAtModeToggle) {
+      at_mode_ = true;
+      command_buffer_.clear();
+      Respond("Entry AT", received_at + config_.response_time);
+    } else {
+      // each write is a single packet
+      auto packet = AirPacket{{}, LoraDeviceAddress{}, data};
+      if (psp_.lora_gateway_mode ==
+          kLoraGatewayMode::kFixedPointTransmission) {
+        if (data.size() <= kFixedPointPrefixSize) {
+          update_action_->Reschedule();
+          return;
+        }
+        // target address and channel are not transmitted
+        packet.target.address =
+            static_cast<std::uint16_t>((data[0] << 8) | data[1]);
+        packet.target.channel = data[2];
+        packet.data.erase(std::begin(packet.data),
+                          std::begin(packet.data) + kFixedPointPrefixSize);
+      }
+      auto const start = std::max(received_at, air_free_at_);
+      air_free_at_ =
+          start + LoraAirtime::Calculate(psp_, packet.data.size());
+      packet.at = air_free_at_;
+      to_air_.push_back(std::move(packet));
+    }
+    update_action_->Reschedule();
+    return;
+  }
+
+  command_buffer_.append(text);
+  while (!command_buffer_.empty()) {
+    if (command_buffer_.compare(0, kAtModeToggle.size(), kAtModeToggle) ==
+        0) {
+      command_buffer_.erase(0, kAtModeToggle.size());
+      command_buffer_.erase(0, command_buffer_.find_first_not_of("\r\n"));
+      Command(kAtModeToggle, received_at);
+      if (!at_mode_) {
+        command_buffer_.clear();
+        break;
+      }
+      continue;
+    }
+    auto const end = command_buffer_.find('\n');
+    if (end == std::string::npos) {
+      break;
+    }
+    auto command = command_buffer_.substr(0, end);
+    command_buffer_.erase(0, end + 1);
+    if (!command.empty() && (command.back() == '\r')) {
+      command.pop_back();
+    }
+    if (!command.empty()) {
+      Command(command, received_at);
+    }
+  }
+  update_action_->Reschedule();
+}
+
+void LoraSimLr02::ClosePort(LoraSimLr02Port const& port) {
+  if (port_ == &port) {
+    port_ = nullptr;
+  }
+}
+
+void LoraSimLr02::Command(std::string_view command, TimePoint at) {
+  ++at_commands_;
+  auto const respond_at = at + config_.response_time;
+
+  if (command == kAtModeToggle) {
+    at_mode_ = false;
+    Respond("Exit AT", respond_at);
+    Respond("Power on", respond_at + config_.power_on_time);
+    return;
+  }
+  if (command == "AT") {
+    Respond("OK", respond_at);
+    return;
+  }
+  if (command == "AT+RESET") {
+    Respond("OK", respond_at);
+    Respond("Power on", respond_at + config_.power_on_time);
+    return;
+  }
+  if (auto baud = CommandArgument(command, "AT+BAUD"); baud) {
+    if ((*baud < 1) || (*baud > static_cast<int>(kAtBaudRates.size())) ||
+        (BaudRateValue(kAtBaudRates[*baud - 1]) >
+         BaudRateValue(config_.max_baud_rate))) {
+      Respond("ERROR", respond_at);
+      return;
+    }
+    // OK is sent with the old rate, the new one is used right after
+    Respond("OK", respond_at);
+    baud_rate_ = kAtBaudRates[*baud - 1];
+    return;
+  }
+  if (auto sf = CommandArgument(command, "AT+SF"); sf) {
+    if ((*sf < 5) || (*sf > 12)) {
+      Respond("ERROR", respond_at);
+      return;
+    }
+    psp_.lora_gateway_spreading_factor =
+        static_cast<kLoraGatewaySpreadingFactor>(*sf);
+    Respond("OK", respond_at);
+    return;
+  }
+  if (auto bw = CommandArgument(command, "AT+BW"); bw) {
+    if (*bw >= static_cast<int>(kAtBandWidths.size())) {
+      Respond("ERROR", respond_at);
+      return;
+    }
+    psp_.lora_gateway_band_width = kAtBandWidths[*bw];
+    Respond("OK", respond_at);
+    return;
+  }
+  if (auto mode = CommandArgument(command, "AT+MODE"); mode) {
+    if (*mode > 2) {
+      Respond("ERROR", respond_at);
+      return;
+    }
+    psp_.lora_gateway_mode = static_cast<kLoraGatewayMode>(*mode);
+    Respond("OK", respond_at);
+    return;
+  }
+  if (auto cr = CommandArgument(command, "AT+CR"); cr) {
+    if ((*cr < 1) || (*cr > 4)) {
+      Respond("ERROR", respond_at);
+      return;
+    }
+    psp_.lora_gateway_coding_rate = static_cast<kLoraGatewayCodingRate>(*cr);
+    Respond("OK", respond_at);
+    return;
+  }
+  if (command.substr(0, 3) == "AT+") {
+    // the other settings are accepted but do not change the emulation
+    Respond("OK", respond_at);
+    return;
+  }
+  Respond("ERROR", respond_at);
+}
+
+void LoraSimLr02::Respond(std::string_view response, TimePoint at) {
+  DataBuffer data(std::begin(response), std::end(response));
+  data.push_back('\r');
+  data.push_back('\n');
+  ToHost(std::move(data), at);
+}
+
+void LoraSimLr02::ToHost(DataBuffer data, TimePoint at) {
+  // bytes are sent one after another with the current baud rate
+  auto const start = std::max(at, serial_free_at_);
+  serial_free_at_ = start + TransferTime(data.size());
+  to_host_.push_back(Output{serial_free_at_, baud_rate_, std::move(data)});
+}
+
+Duration LoraSimLr02::TransferTime(std::size_t size) const {
+  // start bit, 8 data bits and stop bit for each byte
+  auto const bits = static_cast<std::uint64_t>(size) * 10;
+  return std::chrono::duration_cast<Duration>(
+      std::chrono::microseconds{(bits * 1000000) / BaudRateValue(baud_rate_)});
+}
+
+TimePoint LoraSimLr02::Update(TimePoint now) {
+  // handlers may write to the module, so the item is removed before emit
+  while (!to_air_.empty() && (to_air_.front().at <= now)) {
+    auto packet = std::move(to_air_.front());
+    to_air_.pop_front();
+    air_event_.Emit(packet.target, packet.data);
+  }
+  while (!to_host_.empty() && (to_host_.front().at <= now)) {
+    auto output = std::move(to_host_.front());
+    to_host_.pop_front();
+    if ((port_ != nullptr) && (port_->baud_rate() == output.baud_rate)) {
+      port_->read_event_.Emit(output.data);
+    }
+  }
+
+  auto next = TimePoint::max();
+  if (!to_air_.empty()) {
+    next = std::min(next, to_air_.front().at);
+  }
+  if (!to_host_.empty()) {
+    next = std::min(next, to_host_.front().at);
+  }
+  return next;
+}
+}  // namespace ae::gw::sim
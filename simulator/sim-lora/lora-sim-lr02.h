@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIM_LORA_LORA_SIM_LR02_H_
+#define SIM_LORA_LORA_SIM_LR02_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <optional>
+#include <string_view>
+
+#include "aether/all.h"
+#include "aether/serial_ports/iserial_port.h"
+
+#include "gateway/deadline_action.h"
+
+#include "lora_gateways/lora_device_registry.h"
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae::gw::sim {
+class LoraSimLr02;
+
+/**
+ * \brief Host side serial port of the emulated module.
+ */
+class LoraSimLr02Port final : public ISerialPort {
+  friend class LoraSimLr02;
+
+ public:
+  LoraSimLr02Port(LoraSimLr02& module, kBaudRate baud_rate);
+  ~LoraSimLr02Port() override;
+
+  void Write(DataBuffer const& data) override;
+  DataReadEvent::Subscriber read_event() override;
+  bool IsOpen() override;
+
+  kBaudRate baud_rate() const;
+
+ private:
+  LoraSimLr02* module_;
+  kBaudRate baud_rate_;
+  DataReadEvent read_event_;
+};
+
+/**
+ * \brief In-process emulator of the DX-SMART LR02 module.
+ * Speaks the AT dialect on the serial side: "+++" entry and exit with
+ * "Entry AT", "Exit AT" and "Power on", "AT" and "AT+..." commands answered by
+ * "OK" or "ERROR". Each write in data mode is transmitted to the air with the
+ * LoRa time on air of the configured settings, in fixed-point mode the first
+ * three bytes of the write are the target address and channel.
+ * Serial bytes take the time of the module baud rate, bytes written with
+ * another baud rate are lost.
+ */
+class LoraSimLr02 {
+  friend class LoraSimLr02Port;
+
+ public:
+  using AirEvent = Event<void(LoraDeviceAddress const& target,
+                              DataBuffer const& data)>;
+
+  struct Config {
+    kBaudRate baud_rate{kBaudRate::kBaudRate9600};
+    // the fastest rate accepted by AT+BAUD
+    kBaudRate max_baud_rate{kBaudRate::kBaudRate128000};
+    Duration response_time{std::chrono::milliseconds{5}};
+    Duration power_on_time{std::chrono::milliseconds{100}};
+  };
+
+  LoraSimLr02(ActionContext action_context, Config config);
+
+  /**
+   * \brief Open host port, it replaces the previous one.
+   */
+  std::unique_ptr<ISerialPort> OpenPort(SerialInit const& serial_init);
+
+  /**
+   * \brief Packet received from the air, transferred to the host in data
+   * mode.
+   */
+  void AirReceive(DataBuffer const& data);
+  /**
+   * \brief Packet transmitted to the air, target is broadcast if the module
+   * is not in fixed-point mode.
+   */
+  AirEvent::Subscriber air_event();
+
+  kBaudRate baud_rate() const;
+  bool at_mode() const;
+  LoraGatewayPowerSaveParam const& psp() const;
+  std::size_t at_commands() const;
+
+  static std::uint32_t BaudRateValue(kBaudRate baud_rate);
+
+ private:
+  struct Output {
+    TimePoint at;
+    kBaudRate baud_rate;
+    DataBuffer data;
+  };
+
+  struct AirPacket {
+    TimePoint at;
+    LoraDeviceAddress target;
+    DataBuffer data;
+  };
+
+  void HostWrite(LoraSimLr02Port const& port, DataBuffer const& data);
+  void ClosePort(LoraSimLr02Port const& port);
+  void Command(std::string_view command, TimePoint at);
+  void Respond(std::string_view response, TimePoint at);
+  void ToHost(DataBuffer data, TimePoint at);
+  Duration TransferTime(std::size_t size) const;
+  TimePoint Update(TimePoint now);
+
+  Config config_;
+  kBaudRate baud_rate_;
+  bool at_mode_{};
+  LoraGatewayPowerSaveParam psp_;
+  std::string command_buffer_;
+  LoraSimLr02Port* port_{};
+  std::deque<Output> to_host_;
+  TimePoint serial_free_at_;
+  std::deque<AirPacket> to_air_;
+  TimePoint air_free_at_;
+  std::size_t at_commands_{};
+  AirEvent air_event_;
+  OwnActionPtr<gw::DeadlineAction> update_action_;
+};
+}  // namespace ae::gw::sim
+
+#endif  // SIM_LORA_LORA_SIM_LR02_H_
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+#include "aether/all.h"
+
+#include "gateway/selective_repeat.h"
+
+namespace ae::gw::sim {
+// more than a window and not a multiple of the sequence space
+static constexpr std::size_t kLostFrames = 3 * SelectiveRepeat::kWindowSize + 5;
+static constexpr std::size_t kFrames = 10;
+static constexpr SelectiveRepeat::Config kConfig{
+    std::chrono::milliseconds{100},  // initial_rto
+    std::chrono::milliseconds{10},   // min_rto
+    std::chrono::seconds{1},         // max_rto
+    1,                               // max_retries
+    128,                             // max_pending
+};
+static constexpr auto kStep = std::chrono::milliseconds{10};
+static constexpr auto kRunTime = std::chrono::seconds{60};
+
+/**
+ * \brief Session recovers after the sender gave up on more than a window.
+ * All the frames to the receiver are lost while it's unreachable, e.g. a
+ * sleeping device, the sender drops them after its retries. Frames sent after
+ * the link is back have to be delivered and acknowledged.
+ */
+int SimArqResync() {
+  auto sender = SelectiveRepeat{kConfig};
+  auto receiver = SelectiveRepeat{kConfig};
+  auto now = Now();
+  bool link_up = false;
+
+  std::vector<DataBuffer> received;
+  std::size_t delivered = 0;
+  auto to_receiver = sender.out_frame_event().Subscribe(
+      [&](auto const& frame) {
+        if (link_up) {
+          receiver.Receive(frame, now);
+        }
+      });
+  auto to_sender = receiver.out_frame_event().Subscribe(
+      [&](auto const& frame) { sender.Receive(frame, now); });
+  auto data_sub = receiver.out_data_event().Subscribe(
+      [&](auto const& data) { received.push_back(data); });
+  auto delivery_sub = sender.delivery_event().Subscribe([&](auto ok) {
+    if (ok) {
+      ++delivered;
+    }
+  });
+
+  // virtual time in steps, frames sent by an update are timed by the next
+  auto run = [&]() {
+    for (auto const until = now + kRunTime; now < until; now += kStep) {
+      sender.Update(now);
+    }
+  };
+
+  for (std::size_t i = 0; i < kLostFrames; ++i) {
+    sender.Send(DataBuffer{0xFF, static_cast<std::uint8_t>(i)}, now);
+  }
+  run();
+  if (sender.stats().lost != kLostFrames) {
+    std::cerr << Format("{} frames lost, expected {}\n", sender.stats().lost,
+                        kLostFrames);
+    return 1;
+  }
+
+  link_up = true;
+  for (std::size_t i = 0; i < kFrames; ++i) {
+    sender.Send(DataBuffer{static_cast<std::uint8_t>(i)}, now);
+  }
+  run();
+
+  std::cout << Format("Received {} frames, delivered {}\n", received.size(),
+                      delivered);
+  if ((received.size() != kFrames) || (delivered != kFrames)) {
+    std::cerr << "Session is not recovered\n";
+    return 2;
+  }
+  for (std::size_t i = 0; i < kFrames; ++i) {
+    if (received[i] != DataBuffer{static_cast<std::uint8_t>(i)}) {
+      std::cerr << "Frames are out of order\n";
+      return 3;
+    }
+  }
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimArqResync(); }
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <queue>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+#include "aether/all.h"
+
+#include "gateway/selective_repeat.h"
+
+namespace ae::gw::sim {
+static constexpr std::size_t kFrames = 400;
+static constexpr std::size_t kFrameSize = 32;
+
+struct LinkModel {
+  char const* name;
+  // time to send one frame, frames are queued in each direction
+  Duration frame_time;
+  Duration delay;
+  Duration jitter;
+  double loss;
+};
+
+struct Result {
+  SelectiveRepeat::Stats stats;
+  Duration transfer_time;
+  bool delivered;
+};
+
+/**
+ * \brief Transfer kFrames over a lossy link with virtual time.
+ */
+Result Transfer(LinkModel const& link, SelectiveRepeat::Config config) {
+  struct InFlight {
+    TimePoint arrive_at;
+    bool to_receiver;
+    DataBuffer frame;
+    bool operator>(InFlight const& other) const {
+      return arrive_at > other.arrive_at;
+    }
+  };
+
+  auto random = std::mt19937{42};
+  auto lost = std::bernoulli_distribution{link.loss};
+  auto jitter = std::uniform_int_distribution<Duration::rep>{
+      0, link.jitter.count()};
+
+  auto now = TimePoint{} + std::chrono::hours{1};
+  auto const started_at = now;
+  std::priority_queue<InFlight, std::vector<InFlight>, std::greater<>> wire;
+  // the time each direction of the link is free to send
+  TimePoint free_at[2] = {now, now};
+
+  auto sender = SelectiveRepeat{config};
+  auto receiver = SelectiveRepeat{config};
+  auto send = [&](bool to_receiver, DataBuffer const& frame) {
+    auto& sent_at = free_at[to_receiver ? 0 : 1];
+    sent_at = std::max(sent_at, now) + link.frame_time;
+    if (lost(random)) {
+      return;
+    }
+    wire.push(InFlight{sent_at + link.delay + Duration{jitter(random)},
+                       to_receiver, frame});
+  };
+  auto sender_sub = sender.out_frame_event().Subscribe(
+      [&](auto const& frame) { send(true, frame); });
+  auto receiver_sub = receiver.out_frame_event().Subscribe(
+      [&](auto const& frame) { send(false, frame); });
+
+  std::size_t received = 0;
+  bool in_order = true;
+  auto data_sub = receiver.out_data_event().Subscribe([&](auto const& data) {
+    in_order = in_order && (data[0] == static_cast<std::uint8_t>(received));
+    ++received;
+  });
+
+  for (std::size_t i = 0; i < kFrames; ++i) {
+    auto data = DataBuffer(kFrameSize, static_cast<std::uint8_t>(i));
+    sender.Send(std::move(data), now);
+  }
+
+  auto const deadline = now + std::chrono::hours{1};
+  while ((received < kFrames) && (now < deadline)) {
+    auto next = std::min(sender.Update(now), receiver.Update(now));
+    if (!wire.empty()) {
+      next = std::min(next, wire.top().arrive_at);
+    }
+    if (next == TimePoint::max()) {
+      break;
+    }
+    now = std::max(now, next);
+    while (!wire.empty() && (wire.top().arrive_at <= now)) {
+      auto in_flight = wire.top();
+      wire.pop();
+      if (in_flight.to_receiver) {
+        receiver.Receive(in_flight.frame, now);
+      } else {
+        sender.Receive(in_flight.frame, now);
+      }
+    }
+  }
+  return Result{sender.stats(),
+                std::chrono::duration_cast<Duration>(now - started_at),
+                (received == kFrames) && in_order};
+}
+
+std::int64_t ToMs(Duration duration) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+      .count();
+}
+
+void Print(char const* name, Result const& result) {
+  auto const& stats = result.stats;
+  auto const avg_recovery =
+      stats.recoveries != 0
+          ? stats.recovery_time / static_cast<Duration::rep>(stats.recoveries)
+          : Duration{};
+  std::cout << Format(
+      "  {}: retransmits {} spurious {} lost {}, recovery avg {} ms max {} "
+      "ms, transfer {} ms\n",
+      name, stats.retransmits, stats.spurious_retransmits, stats.lost,
+      ToMs(avg_recovery), ToMs(stats.max_recovery_time),
+      ToMs(result.transfer_time));
+}
+
+int SimArqRtt() {
+  using std::chrono::milliseconds;
+  // timers of the gateway SafeStreamConfig for every link
+  auto const fixed_config = SelectiveRepeat::Config{
+      milliseconds{600}, milliseconds{600}, milliseconds{600}, 20, kFrames};
+  // estimated from the link RTT
+  auto const adaptive_config = SelectiveRepeat::Config{
+      milliseconds{600}, milliseconds{100}, milliseconds{30000}, 20, kFrames};
+
+  LinkModel const links[] = {
+      {"wired", milliseconds{1}, milliseconds{10}, milliseconds{5}, 0.05},
+      {"lora-sf7", milliseconds{60}, milliseconds{5}, milliseconds{20}, 0.05},
+      {"lora-sf12", milliseconds{1200}, milliseconds{5}, milliseconds{20},
+       0.05},
+  };
+
+  int res = 0;
+  for (auto const& link : links) {
+    std::cout << Format("Link {}\n", link.name);
+    auto const fixed = Transfer(link, fixed_config);
+    auto const adaptive = Transfer(link, adaptive_config);
+    Print("fixed", fixed);
+    Print("adaptive", adaptive);
+    if (!fixed.delivered) {
+      std::cout << "  fixed timers did not deliver all the data\n";
+    }
+    if (!adaptive.delivered) {
+      std::cerr << "Data is not delivered in order\n";
+      res = 1;
+    }
+    if (adaptive.stats.spurious_retransmits >
+        fixed.stats.spurious_retransmits) {
+      std::cerr << "Adaptive timers make more spurious retransmits\n";
+      res = 1;
+    }
+    if (adaptive.transfer_time > fixed.transfer_time) {
+      std::cerr << "Adaptive timers make the transfer slower\n";
+      res = 1;
+    }
+  }
+  return res;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimArqRtt(); }
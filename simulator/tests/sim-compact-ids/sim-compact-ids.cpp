@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "sim-gateway/gw-sim-data-bus.h"
+#include "sim-gateway/gw-sim-alice-bob.h"
+
+namespace ae::gw::sim {
+DataBuffer Message(std::string_view text) {
+  return DataBuffer{
+      reinterpret_cast<std::uint8_t const*>(text.data()),
+      reinterpret_cast<std::uint8_t const*>(text.data() + text.size())};
+}
+
+/**
+ * \brief Exchange messages between alice and bob through the gateway.
+ * exchange_stats gets the device traffic of the exchange only, the clients
+ * selection traffic is not counted.
+ */
+int RunExchange(GwSimDevice::Encoding encoding,
+                GwSimDataBus::Stats& exchange_stats) {
+  auto alice_bob = GwSimAliceBob{encoding};
+
+  int received_messages = 0;
+  RcPtr<P2pStream> alice_stream;
+  RcPtr<P2pStream> bob_stream;
+  GwSimDataBus::Stats selected_stats;
+
+  auto res = alice_bob.Run(
+      [&](Client::ptr const& alice, Client::ptr const& bob) {
+        selected_stats = alice_bob.data_bus().stats();
+
+        // send message from alice to bob and than send one back
+        alice_stream =
+            alice->message_stream_manager().CreateStream(bob->uid());
+        alice_stream->out_data_event().Subscribe([&](auto const&) {
+          alice_bob.Trigger();
+          received_messages++;
+        });
+        alice_stream->Write(Message("Hello, Bob!"));
+
+        bob_stream = bob->message_stream_manager().CreateStream(alice->uid());
+        bob_stream->out_data_event().Subscribe([&](auto const&) {
+          alice_bob.Trigger();
+          received_messages++;
+          bob_stream->Write(Message("Hello, Alice!"));
+        });
+      },
+      [&]() { return received_messages == 2; });
+
+  auto const& bus_stats = alice_bob.data_bus().stats();
+  exchange_stats = GwSimDataBus::Stats{
+      bus_stats.device_frames - selected_stats.device_frames,
+      bus_stats.device_bytes - selected_stats.device_bytes,
+      bus_stats.gateway_frames - selected_stats.gateway_frames,
+      bus_stats.gateway_bytes - selected_stats.gateway_bytes,
+  };
+  std::cout << Format(
+      "Device to gateway {} frames {} bytes, gateway to device {} frames {} "
+      "bytes\n",
+      exchange_stats.device_frames, exchange_stats.device_bytes,
+      exchange_stats.gateway_frames, exchange_stats.gateway_bytes);
+  return res;
+}
+int SimCompactIds() {
+  auto full_stats = GwSimDataBus::Stats{};
+  auto full_res = RunExchange(GwSimDevice::Encoding::kFullIds, full_stats);
+  if (full_res != 0) {
+    return full_res;
+  }
+  // devices bind one byte stream index instead of client and server ids
+  auto compact_stats = GwSimDataBus::Stats{};
+  auto compact_res =
+      RunExchange(GwSimDevice::Encoding::kCompactIds, compact_stats);
+  if (compact_res != 0) {
+    return compact_res;
+  }
+
+  if ((compact_stats.device_bytes >= full_stats.device_bytes) ||
+      (compact_stats.gateway_bytes >= full_stats.gateway_bytes)) {
+    std::cerr << Format(
+        "Compact ids do not save bytes: device {} vs {}, gateway {} vs {}\n",
+        compact_stats.device_bytes, full_stats.device_bytes,
+        compact_stats.gateway_bytes, full_stats.gateway_bytes);
+    return 2;
+  }
+  std::cout << Format("Compact ids saved {} device and {} gateway bytes\n",
+                      full_stats.device_bytes - compact_stats.device_bytes,
+                      full_stats.gateway_bytes - compact_stats.gateway_bytes);
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimCompactIds(); }
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+#include "aether/all.h"
+
+#include "gateway/local_link.h"
+#include "gateway/fragment_link.h"
+#include "gateway/fragmentation.h"
+
+namespace ae::gw::sim {
+static constexpr std::uint16_t kMtu = 32;
+static constexpr std::size_t kChunkSize =
+    kMtu - Fragmenter::kFragmentHeaderSize;
+static constexpr Reassembler::Limits kLimits{
+    std::chrono::seconds{30},  // timeout
+    16 * kChunkSize,           // max_size
+    2,                         // max_messages
+};
+
+DataBuffer Data(std::size_t size, std::uint8_t seed) {
+  auto data = DataBuffer(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<std::uint8_t>(seed + i);
+  }
+  return data;
+}
+
+/**
+ * \brief Top link recording the frames reassembled for it.
+ */
+class RecordLink final : public ILocalLink {
+ public:
+  void Input(std::uint8_t device_id, DataBuffer const& data) override {
+    received.emplace_back(device_id, data);
+  }
+  Output::Subscriber output_event() override {
+    return EventSubscriber{output};
+  }
+
+  Output output;
+  std::vector<std::pair<std::uint8_t, DataBuffer>> received;
+};
+
+// frames up to the MTU go whole, longer ones in fragments fitting the MTU
+bool CheckSplit() {
+  auto fragmenter = Fragmenter{};
+  auto reassembler = Reassembler{kLimits};
+  auto const now = Now();
+  for (auto size : {std::size_t{1}, std::size_t{kMtu - 1}, std::size_t{kMtu},
+                    3 * kChunkSize, (3 * kChunkSize) + 1}) {
+    auto const data = Data(size, static_cast<std::uint8_t>(size));
+    auto const frames = fragmenter.Split(data, kMtu);
+    auto const expected_count =
+        (size < kMtu) ? 1 : ((size + kChunkSize - 1) / kChunkSize);
+    if (frames.size() != expected_count) {
+      std::cerr << Format("{} bytes split to {} frames\n", size,
+                          frames.size());
+      return false;
+    }
+    std::optional<DataBuffer> result;
+    for (auto const& frame : frames) {
+      if (frame.size() > kMtu) {
+        std::cerr << Format("Frame of {} bytes exceeds MTU\n", frame.size());
+        return false;
+      }
+      result = reassembler.Push(frame, now);
+    }
+    if (!result || (*result != data)) {
+      std::cerr << Format("{} bytes are not reassembled\n", size);
+      return false;
+    }
+  }
+  // too many fragments
+  return fragmenter
+      .Split(Data((Fragmenter::kMaxFragments * kChunkSize) + 1, 0), kMtu)
+      .empty();
+}
+
+bool CheckOutOfOrder() {
+  auto fragmenter = Fragmenter{};
+  auto reassembler = Reassembler{kLimits};
+  auto const now = Now();
+  auto const first = Data(4 * kChunkSize, 1);
+  auto const second = Data(3 * kChunkSize, 2);
+  auto first_frames = fragmenter.Split(first, kMtu);
+  auto second_frames = fragmenter.Split(second, kMtu);
+  std::reverse(std::begin(first_frames), std::end(first_frames));
+
+  // the fragments of two messages interleaved, the last ones go first
+  std::vector<DataBuffer> results;
+  for (std::size_t i = 0; i < first_frames.size(); ++i) {
+    if (auto data = reassembler.Push(first_frames[i], now); data) {
+      results.push_back(*data);
+    }
+    // duplicate is ignored
+    if (reassembler.Push(first_frames[i], now)) {
+      return false;
+    }
+    if (i < second_frames.size()) {
+      if (auto data =
+              reassembler.Push(second_frames[second_frames.size() - 1 - i],
+                               now);
+          data) {
+        results.push_back(*data);
+      }
+    }
+  }
+  return (results.size() == 2) && (results[0] == second) &&
+         (results[1] == first);
+}
+
+bool CheckTimeout() {
+  auto fragmenter = Fragmenter{};
+  auto reassembler = Reassembler{kLimits};
+  auto const now = Now();
+  auto const frames = fragmenter.Split(Data(2 * kChunkSize, 3), kMtu);
+  reassembler.Push(frames[0], now);
+  // the first fragment is expired and the message stays incomplete
+  return !reassembler.Push(frames[1],
+                           now + kLimits.timeout + std::chrono::seconds{1});
+}
+
+bool CheckLimits() {
+  auto const now = Now();
+  {
+    // the oldest incomplete message is dropped over max_messages
+    auto fragmenter = Fragmenter{};
+    auto reassembler = Reassembler{kLimits};
+    std::vector<std::vector<DataBuffer>> messages;
+    for (std::uint8_t i = 0; i < 3; ++i) {
+      messages.push_back(fragmenter.Split(Data(2 * kChunkSize, i), kMtu));
+      reassembler.Push(messages.back()[0],
+                       now + std::chrono::milliseconds{i});
+    }
+    if (reassembler.Push(messages[0][1], now) ||
+        !reassembler.Push(messages[2][1], now)) {
+      std::cerr << "max_messages is not kept\n";
+      return false;
+    }
+  }
+  {
+    // a message bigger than max_size is not collected
+    auto fragmenter = Fragmenter{};
+    auto reassembler = Reassembler{kLimits};
+    auto const frames = fragmenter.Split(
+        Data(kLimits.max_size + kChunkSize, 4), kMtu);
+    for (auto const& frame : frames) {
+      if (reassembler.Push(frame, now)) {
+        std::cerr << "max_size is not kept\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// frames from the top link are split per device and reassembled back
+bool CheckLink() {
+  auto top = RecordLink{};
+  auto link = FragmentLink{top, {kMtu, kLimits}};
+  link.SetMtu(2, 2 * kMtu);
+  std::vector<std::pair<std::uint8_t, DataBuffer>> sent;
+  auto sub = link.output_event().Subscribe(
+      [&](auto device_id, auto const& frame) {
+        sent.emplace_back(device_id, frame);
+      });
+  auto const data = Data(3 * kMtu, 5);
+  top.output.Emit(1, data);
+  top.output.Emit(2, data);
+  for (auto const& [device_id, frame] : sent) {
+    std::size_t const mtu = (device_id == 2) ? (2 * kMtu) : kMtu;
+    if (frame.size() > mtu) {
+      return false;
+    }
+    link.Input(device_id, frame);
+  }
+  return (top.received.size() == 2) && (top.received[0].first == 1) &&
+         (top.received[0].second == data) && (top.received[1].first == 2) &&
+         (top.received[1].second == data);
+}
+
+int SimFragmentation() {
+  if (!CheckSplit()) {
+    return 1;
+  }
+  if (!CheckOutOfOrder()) {
+    std::cerr << "Out of order fragments are not reassembled\n";
+    return 2;
+  }
+  if (!CheckTimeout()) {
+    std::cerr << "Expired fragments are reassembled\n";
+    return 3;
+  }
+  if (!CheckLimits()) {
+    return 4;
+  }
+  if (!CheckLink()) {
+    std::cerr << "Fragment link does not pass frames through\n";
+    return 5;
+  }
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimFragmentation(); }
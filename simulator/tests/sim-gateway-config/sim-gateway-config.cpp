@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+#include "aether/all.h"
+
+#include "gateway_config.h"
+
+namespace ae::gw::sim {
+static constexpr auto kTimeout = std::chrono::seconds{30};
+
+using gateway_server::ConfigValues;
+using gateway_server::GatewayConfig;
+
+bool CheckParse() {
+  auto const values = gateway_server::ParseConfigText(
+      "# gateway config\n"
+      "  lora_channel = 5  \n"
+      "lora_crc=1 # crc on\n"
+      "line without value\n"
+      "\n"
+      "mux_window_ms = 20\r\n"
+      "lora_channel = 7");
+  auto const expected = ConfigValues{
+      {"lora_channel", "7"},
+      {"lora_crc", "1"},
+      {"mux_window_ms", "20"},
+  };
+  if (values != expected) {
+    std::cerr << "Config text is parsed wrong\n";
+    return false;
+  }
+  return true;
+}
+
+bool CheckApply() {
+  auto const defaults = GatewayConfig{};
+  auto const config = gateway_server::ApplyConfigValues(
+      defaults, ConfigValues{
+                    {"lora_channel", "5"},
+                    {"lora_crc", "1"},
+                    {"mux_window_ms", "20"},
+                    // out of range, unknown and not a number are skipped
+                    {"lora_sf", "13"},
+                    {"unknown_key", "1"},
+                    {"lora_address", "0x10"},
+                });
+  auto const& init = config.lora_gateway_init;
+  if ((init.lora_gateway_channel != 5) ||
+      (init.lora_gateway_crc_check != kLoraGatewayCRCCheck::kCRCOn) ||
+      (config.multiplex_config.flush_window != std::chrono::milliseconds{20}) ||
+      (init.psp.lora_gateway_spreading_factor !=
+       defaults.lora_gateway_init.psp.lora_gateway_spreading_factor) ||
+      (init.lora_gateway_my_adress !=
+       defaults.lora_gateway_init.lora_gateway_my_adress)) {
+    std::cerr << "Config values are applied wrong\n";
+    return false;
+  }
+
+  // module settings are applied by the driver, serial port on restart
+  auto const changes = gateway_server::CompareConfigs(defaults, config);
+  if (!changes.module_init || changes.serial_init ||
+      changes.power_save_param || !changes.multiplex_config ||
+      changes.safe_stream_config) {
+    std::cerr << "Config changes are detected wrong\n";
+    return false;
+  }
+  return true;
+}
+
+void WriteConfig(std::filesystem::path const& path, std::string_view text,
+                 std::filesystem::file_time_type write_time) {
+  std::ofstream{path} << text;
+  // the store version is the modification time, make sure it changes
+  std::filesystem::last_write_time(path, write_time);
+}
+
+/**
+ * \brief Config file is loaded over the defaults and reloaded on change.
+ * The first change is reloaded explicitly, the second one is noticed by the
+ * watcher if the store is watched.
+ */
+int SimGatewayConfig() {
+  if (!CheckParse()) {
+    return 1;
+  }
+  if (!CheckApply()) {
+    return 2;
+  }
+
+  auto const path =
+      std::filesystem::temp_directory_path() / "sim-gateway-config.txt";
+  auto const write_time = std::filesystem::file_time_type::clock::now();
+  WriteConfig(path, "lora_channel = 3\n", write_time);
+
+  auto app = AetherApp::Construct(AetherAppContext{});
+  auto action_context = ActionContext{*app->aether()};
+
+  auto store = gateway_server::GatewayConfigStore{path.string()};
+  auto reloader = gateway_server::GatewayConfigReloader{
+      action_context, app->aether()->action_processor->get_trigger(), store,
+      {}};
+  if (reloader.config().lora_gateway_init.lora_gateway_channel != 3) {
+    std::cerr << "Config file is not loaded\n";
+    return 3;
+  }
+
+  int reloads = 0;
+  auto changed_sub = reloader.changed_event().Subscribe(
+      [&](auto const& old_config, auto const& new_config) {
+        auto const changes =
+            gateway_server::CompareConfigs(old_config, new_config);
+        auto const channel = (++reloads == 1) ? 4 : 5;
+        if (!changes.module_init ||
+            (new_config.lora_gateway_init.lora_gateway_channel != channel)) {
+          app->Exit(4);
+          return;
+        }
+        if ((reloads == 1) && reloader.watched()) {
+          WriteConfig(path, "lora_channel = 5\n",
+                      write_time + std::chrono::seconds{2});
+          return;
+        }
+        app->Exit(0);
+      });
+  WriteConfig(path, "lora_channel = 4\n", write_time + std::chrono::seconds{1});
+  reloader.Reload();
+
+  auto const started_at = Now();
+  while (!app->IsExited()) {
+    reloader.Poll();
+    auto next_time = app->Update(Now());
+    app->WaitUntil(std::min(next_time, started_at + kTimeout));
+    if (Now() >= started_at + kTimeout) {
+      AE_TELED_ERROR("Config reload timeout");
+      app->Exit(5);
+    }
+  }
+  std::filesystem::remove(path);
+  return app->ExitCode();
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimGatewayConfig(); }
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <fstream>
+#include <iostream>
+
+#include "aether/all.h"
+
+#include "gateway/latency_tracer.h"
+
+#include "sim-gateway/gw-sim-alice-bob.h"
+
+namespace ae::gw::sim {
+static constexpr int kRounds = 20;
+
+DataBuffer Message(std::string const& text) {
+  return DataBuffer{
+      reinterpret_cast<std::uint8_t const*>(text.data()),
+      reinterpret_cast<std::uint8_t const*>(text.data() + text.size())};
+}
+
+/**
+ * \brief Latency of the gateway stages for request and reply traffic.
+ * Alice sends kRounds requests to Bob one by one and Bob echoes each of
+ * them, both are devices of the gateway. The report of the stage histograms
+ * is printed and the server reply stage must be measured. The packet trace
+ * of the exchange is dumped to sim-gateway-latency.trace for trace-decode.
+ */
+int SimGatewayLatency() {
+  auto alice_bob = GwSimAliceBob{};
+
+  int replies = 0;
+  RcPtr<P2pStream> alice_stream;
+  RcPtr<P2pStream> bob_stream;
+
+  auto res = alice_bob.Run(
+      [&](Client::ptr const& alice, Client::ptr const& bob) {
+        // only the exchange is measured, not the client selection
+        alice_bob.gateway().latency_tracer().Reset();
+        alice_bob.data_bus().SetTraceRing(&alice_bob.gateway().trace_ring());
+
+        alice_stream =
+            alice->message_stream_manager().CreateStream(bob->uid());
+        alice_stream->out_data_event().Subscribe([&](auto const&) {
+          alice_bob.Trigger();
+          if (++replies < kRounds) {
+            alice_stream->Write(Message(Format("request {}", replies)));
+          }
+        });
+
+        bob_stream = bob->message_stream_manager().CreateStream(alice->uid());
+        bob_stream->out_data_event().Subscribe([&](auto const& message) {
+          alice_bob.Trigger();
+          bob_stream->Write(DataBuffer{message});
+        });
+
+        alice_stream->Write(Message("request 0"));
+      },
+      [&]() { return replies == kRounds; });
+  if (res == -1) {
+    return res;
+  }
+  alice_bob.data_bus().SetTraceRing(nullptr);
+
+  auto const& bus_stats = alice_bob.data_bus().stats();
+  std::cout << Format(
+      "Device to gateway {} frames {} bytes, gateway to device {} frames {} "
+      "bytes\n",
+      bus_stats.device_frames, bus_stats.device_bytes,
+      bus_stats.gateway_frames, bus_stats.gateway_bytes);
+
+  auto const& latency_tracer = alice_bob.gateway().latency_tracer();
+  std::cout << "Gateway latency:\n" << latency_tracer.Report();
+
+  // decode with trace-decode
+  auto const trace = alice_bob.gateway().trace_ring().Dump();
+  std::ofstream{"sim-gateway-latency.trace", std::ios::binary}.write(
+      reinterpret_cast<char const*>(trace.data()),
+      static_cast<std::streamsize>(trace.size()));
+
+  if (res != 0) {
+    return res;
+  }
+  if (latency_tracer.histogram(LatencyStage::kServerReply).count() == 0) {
+    AE_TELED_ERROR("Server reply latency is not measured");
+    return 2;
+  }
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimGatewayLatency(); }
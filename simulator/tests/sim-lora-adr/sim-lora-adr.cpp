@@ -0,0 +1,157 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "aether/all.h"
+
+#include "lora_gateways/lora_airtime.h"
+#include "lora_gateways/lora_gateway_adr.h"
+
+namespace ae::gw::sim {
+static constexpr std::size_t kRounds = 400;
+static constexpr std::size_t kPayloadSize = 50;
+// loss not related to SNR, e.g. collisions
+static constexpr double kRandomLoss = 0.01;
+
+struct SimLink {
+  LoraGatewayAdr::LinkId id;
+  // SNR at full power in 125 kHz channel, dB
+  double snr;
+};
+
+static std::vector<SimLink> const kLinks{
+    {1, 8.0},
+    {2, 2.0},
+    {3, -3.0},
+    {4, -5.0},
+};
+
+struct SimResult {
+  std::size_t sent;
+  std::size_t delivered;
+  Duration airtime;
+};
+
+double RequiredSnr(LoraGatewayPowerSaveParam const& psp) {
+  auto const sf = static_cast<int>(psp.lora_gateway_spreading_factor);
+  return -7.5 - (2.5 * (sf - 7));
+}
+
+SimResult Run(LoraGatewayPowerSaveParam psp, LoraGatewayAdr* adr,
+              bool report_snr) {
+  auto rng = std::mt19937{42};
+  auto snr_noise = std::normal_distribution<double>{0.0, 1.5};
+  auto random_loss = std::uniform_real_distribution<double>{0.0, 1.0};
+
+  Subscription adr_sub;
+  if (adr != nullptr) {
+    adr_sub = adr->param_changed_event().Subscribe(
+        [&](auto const& new_psp) { psp = new_psp; });
+  }
+
+  auto result = SimResult{};
+  for (std::size_t round = 0; round < kRounds; ++round) {
+    for (auto const& link : kLinks) {
+      auto const band_width_hz = static_cast<double>(
+          LoraAirtime::BandWidthHz(psp.lora_gateway_band_width));
+      auto const snr = link.snr +
+                       (static_cast<double>(psp.lora_gateway_power) -
+                        static_cast<double>(kLoraGatewayPower::kPower22)) -
+                       (10.0 * std::log10(band_width_hz / 125000.0)) +
+                       snr_noise(rng);
+      auto const delivered =
+          (snr >= RequiredSnr(psp)) && (random_loss(rng) >= kRandomLoss);
+
+      result.sent++;
+      result.airtime += LoraAirtime::Calculate(psp, kPayloadSize);
+      if (delivered) {
+        result.delivered++;
+      }
+      if (adr == nullptr) {
+        continue;
+      }
+      if (delivered) {
+        auto const reported_snr =
+            report_snr ? std::optional{static_cast<float>(snr)} : std::nullopt;
+        adr->Delivered(link.id, reported_snr);
+      } else {
+        adr->Lost(link.id);
+      }
+    }
+  }
+  return result;
+}
+
+std::size_t Goodput(SimResult const& result) {
+  auto const seconds = std::chrono::duration<double>{result.airtime}.count();
+  return static_cast<std::size_t>(
+      static_cast<double>(result.delivered * kPayloadSize) / seconds);
+}
+
+void Print(std::string_view name, SimResult const& result) {
+  std::cout << Format("{}: sent {} delivered {} airtime {} ms goodput {} B/s\n",
+                      name, result.sent, result.delivered,
+                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                          result.airtime)
+                          .count(),
+                      Goodput(result));
+}
+
+int SimLoraAdr() {
+  // the slowest default settings
+  auto const psp = LoraGatewayPowerSaveParam{};
+  auto config = LoraGatewayAdr::Config{};
+  config.snr_margin = 5.0F;
+
+  auto fixed = Run(psp, nullptr, false);
+  Print("Fixed SF12", fixed);
+
+  auto snr_adr = LoraGatewayAdr{config, psp};
+  auto with_snr = Run(psp, &snr_adr, true);
+  Print("ADR with SNR", with_snr);
+
+  auto loss_adr = LoraGatewayAdr{config, psp};
+  auto loss_only = Run(psp, &loss_adr, false);
+  Print("ADR loss only", loss_only);
+
+  auto loss_ok = [&](SimResult const& result) {
+    return static_cast<double>(result.sent - result.delivered) <=
+           (static_cast<double>(result.sent) * config.target_loss);
+  };
+
+  if (Goodput(with_snr) < 2 * Goodput(fixed) || !loss_ok(with_snr)) {
+    return 1;
+  }
+  if (Goodput(loss_only) < 2 * Goodput(fixed) || !loss_ok(loss_only)) {
+    return 2;
+  }
+
+  // operator settings replace the adapted ones
+  loss_adr.Reset(psp);
+  if ((loss_adr.data_rate() != LoraGatewayAdr{config, psp}.data_rate()) ||
+      (loss_adr.psp().lora_gateway_power != psp.lora_gateway_power)) {
+    return 3;
+  }
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimLoraAdr(); }
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "lora_gateways/lora_crc32.h"
+#include "lora_gateways/lora_gateway_frame.h"
+
+namespace ae::gw::sim {
+static constexpr std::size_t kMaxSize = 4096;
+static constexpr std::size_t kBenchBytes = 64 * 1024 * 1024;
+static constexpr std::array<std::size_t, 4> kSizes{16, 64, 406, kMaxSize};
+static constexpr std::size_t kFrames = 100;
+
+using CrcFunction =
+    std::function<std::uint32_t(std::uint8_t const*, std::size_t)>;
+
+bool CheckValues(DataBuffer const& data) {
+  auto const* check = reinterpret_cast<std::uint8_t const*>("123456789");
+  if ((LoraCrc32::Calculate(check, 9) != 0xCBF43926) ||
+      (LoraCrc32::CalculateSoftware(check, 9) != 0xCBF43926)) {
+    return false;
+  }
+  // all sizes, unaligned data and continuation
+  for (std::size_t size = 0; size < 1024; ++size) {
+    auto const* p = data.data() + (size % 7);
+    auto const crc = LoraCrc32::CalculateSoftware(p, size);
+    auto const half = size / 2;
+    if ((LoraCrc32::Calculate(p, size) != crc) ||
+        (LoraCrc32::Calculate(p + half, size - half,
+                              LoraCrc32::Calculate(p, half)) != crc)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// benchmark results are stored to keep them from being optimized out
+static volatile std::uint32_t bench_sink{};
+
+// nanoseconds per KB
+double Bench(CrcFunction const& crc, DataBuffer const& data,
+             std::size_t size) {
+  std::uint32_t result = 0;
+  auto const rounds = kBenchBytes / size;
+  auto const start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < rounds; ++i) {
+    result ^= crc(data.data(), size);
+  }
+  auto const time = std::chrono::duration<double, std::nano>{
+      std::chrono::steady_clock::now() - start};
+  bench_sink = result;
+  return (time.count() * 1024.0) / static_cast<double>(rounds * size);
+}
+
+// encode frames, corrupt every 10th and check only good ones are decoded
+bool CheckFrames(DataBuffer const& data) {
+  auto rng = std::mt19937{7};
+  auto stream = DataBuffer{};
+  std::size_t corrupted = 0;
+  for (std::size_t i = 0; i < kFrames; ++i) {
+    LoraGatewayPacket packet{};
+    packet.connection.connect_index =
+        static_cast<ConnectionLoraGatewayIndex>(i);
+    packet.data = DataBuffer{data.data(), data.data() + 1 + (i * 3)};
+    auto frame = LoraGatewayFrame::Encode(packet);
+    if ((i % 10) == 0) {
+      // single bit error in data or crc
+      auto const pos = LoraGatewayFrame::kHeaderSize +
+                       (rng() % (frame.size() - LoraGatewayFrame::kHeaderSize));
+      frame[pos] ^= static_cast<std::uint8_t>(1U << (rng() % 8));
+      ++corrupted;
+    }
+    stream.insert(std::end(stream), std::begin(frame), std::end(frame));
+  }
+
+  auto decoder = LoraGatewayFrameDecoder{kMaxSize};
+  std::size_t decoded = 0;
+  bool valid = true;
+  auto sub = decoder.packet_event().Subscribe([&](auto const& packet) {
+    auto const i = static_cast<std::size_t>(packet.connection.connect_index);
+    valid = valid && ((i % 10) != 0) && (packet.data.size() == 1 + (i * 3));
+    ++decoded;
+  });
+  decoder.Push(stream);
+
+  std::cout << Format("Frames {} decoded {} dropped {}\n", kFrames, decoded,
+                      decoder.crc_errors());
+  return valid && (decoded == (kFrames - corrupted)) &&
+         (decoder.crc_errors() >= corrupted);
+}
+
+int SimLoraCrc() {
+  auto rng = std::mt19937{42};
+  auto data = DataBuffer(kMaxSize + 8);
+  for (auto& b : data) {
+    b = static_cast<std::uint8_t>(rng());
+  }
+
+  if (!CheckValues(data)) {
+    std::cerr << "CRC mismatch\n";
+    return 1;
+  }
+  if (!CheckFrames(data)) {
+    std::cerr << "Corrupted frames are not dropped\n";
+    return 2;
+  }
+
+  auto const software = CrcFunction{[](auto const* p, auto size) {
+    return LoraCrc32::CalculateSoftware(p, size);
+  }};
+  auto const selected = CrcFunction{
+      [](auto const* p, auto size) { return LoraCrc32::Calculate(p, size); }};
+
+  std::cout << Format("Accelerated CRC {}\n",
+                      LoraCrc32::accelerated() ? "yes" : "no");
+  for (auto size : kSizes) {
+    std::cout << Format("{} bytes: slice-by-8 {} ns/KB, selected {} ns/KB\n",
+                        size, static_cast<int>(Bench(software, data, size)),
+                        static_cast<int>(Bench(selected, data, size)));
+  }
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimLoraCrc(); }
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <vector>
+#include <iostream>
+#include <optional>
+#include <algorithm>
+
+#include "aether/all.h"
+
+#include "lora_gateways/dx_smart_lr02_gw.h"
+
+#include "sim-lora/lora-sim-lr02.h"
+
+namespace ae::gw::sim {
+static constexpr std::size_t kPackets = 20;
+static constexpr std::size_t kPayloadSize = 200;
+static constexpr auto kTimeout = std::chrono::seconds{120};
+// minimal echo throughput of the pipelined path relative to the serial one
+static constexpr double kMinPipelineGain = 1.2;
+
+/**
+ * \brief kSerial writes the next packet after the echo of the previous one,
+ * kPipelined writes all the packets at once.
+ */
+enum class Mode : std::uint8_t {
+  kSerial,
+  kPipelined,
+};
+
+struct BenchResult {
+  std::optional<Duration> startup;
+  std::optional<Duration> configure;
+  std::optional<Duration> write;
+  std::optional<Duration> echo;
+  std::vector<Duration> latencies;
+};
+
+Duration Since(TimePoint time_point) {
+  return std::chrono::duration_cast<Duration>(Now() - time_point);
+}
+
+std::int64_t Ms(Duration duration) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+      .count();
+}
+
+void PrintQueue(DxSmartLr02LoraGateway const& driver) {
+  static constexpr std::array<char const*, LoraOperationQueue::kLanes> kNames{
+      "data", "control", "maintenance"};
+  for (std::size_t i = 0; i < LoraOperationQueue::kLanes; ++i) {
+    auto const& stats =
+        driver.queue_stats(static_cast<LoraOperationQueue::Lane>(i));
+    std::cout << Format("Queue {}: {} operations, max wait {} ms\n",
+                        kNames[i], stats.operations, Ms(stats.max_wait));
+  }
+}
+
+void Print(Mode mode, LoraSimLr02 const& module, BenchResult const& result) {
+  std::cout << Format("{} mode\n",
+                      mode == Mode::kSerial ? "Serial" : "Pipelined");
+  std::cout << Format("Module baud rate {} AT commands {}\n",
+                      LoraSimLr02::BaudRateValue(module.baud_rate()),
+                      module.at_commands());
+  std::cout << Format("Startup {} ms, configure {} ms\n", Ms(*result.startup),
+                      Ms(*result.configure));
+
+  auto const bytes = kPackets * kPayloadSize;
+  std::cout << Format(
+      "{} packets {} bytes: written in {} ms {} B/s, echoed in {} ms {} B/s\n",
+      kPackets, bytes, Ms(*result.write),
+      (bytes * 1000) / std::max<std::int64_t>(Ms(*result.write), 1),
+      Ms(*result.echo),
+      (bytes * 1000) / std::max<std::int64_t>(Ms(*result.echo), 1));
+
+  auto latencies = result.latencies;
+  std::sort(std::begin(latencies), std::end(latencies));
+  std::cout << Format("Echo latency min {} ms median {} ms max {} ms\n",
+                      Ms(latencies.front()),
+                      Ms(latencies[latencies.size() / 2]),
+                      Ms(latencies.back()));
+}
+
+/**
+ * \brief Driver startup, configuration and data path over the emulated
+ * module. Each packet transmitted to the air is received back, so the data
+ * path includes both serial directions and two times on air.
+ */
+int RunBench(AetherApp& app, Mode mode, BenchResult& result) {
+  auto action_context = ActionContext{*app.aether()};
+
+  auto module_config = LoraSimLr02::Config{};
+  // the host starts with the default rate, the fastest one is not supported
+  module_config.baud_rate = kBaudRate::kBaudRate9600;
+  module_config.max_baud_rate = kBaudRate::kBaudRate115200;
+  auto module = LoraSimLr02{action_context, module_config};
+
+  auto air_sub = module.air_event().Subscribe(
+      [&](auto const& /* target */, auto const& data) {
+        module.AirReceive(data);
+      });
+
+  auto lora_gateway_init = LoraGatewayInit{};
+  lora_gateway_init.serial_init.baud_rate = kBaudRate::kBaudRate9600;
+
+  std::optional<int> exit_code;
+  auto sent_at = std::vector<TimePoint>(kPackets);
+  std::size_t written = 0;
+  std::size_t echoed = 0;
+  auto const started_at = Now();
+
+  auto driver = DxSmartLr02LoraGateway{
+      action_context,
+      [&](auto const& serial_init) { return module.OpenPort(serial_init); },
+      lora_gateway_init};
+
+  auto data_sub = driver.data_event().Subscribe(
+      [&](auto /* connection */, DataBuffer const& data) {
+        if ((data.size() != kPayloadSize) || (data[0] >= kPackets)) {
+          AE_TELED_ERROR("Unexpected echo of {} bytes", data.size());
+          exit_code = 3;
+          return;
+        }
+        result.latencies.push_back(Since(sent_at[data[0]]));
+        if (++echoed == kPackets) {
+          result.echo = Since(sent_at[0]);
+          exit_code = 0;
+        }
+      });
+
+  auto send_packet = [&](std::size_t i) {
+    auto data = DataBuffer(kPayloadSize, static_cast<std::uint8_t>(i));
+    sent_at[i] = Now();
+    driver.WritePacket(ConnectionLoraGatewayIndex{0}, data)
+        ->StatusEvent()
+        .Subscribe(ActionHandler{
+            OnResult{[&]() {
+              if (++written == kPackets) {
+                result.write = Since(sent_at[0]);
+              }
+            }},
+            OnError{[&]() { exit_code = 4; }},
+        });
+  };
+
+  // serial mode sends the next packet on the echo of the previous one
+  auto echo_sub = driver.data_event().Subscribe(
+      [&](auto /* connection */, DataBuffer const& /* data */) {
+        if ((mode == Mode::kSerial) && (echoed < kPackets)) {
+          send_packet(echoed);
+        }
+      });
+
+  auto send_packets = [&]() {
+    if (mode == Mode::kSerial) {
+      send_packet(0);
+      return;
+    }
+    for (std::size_t i = 0; i < kPackets; ++i) {
+      send_packet(i);
+    }
+  };
+
+  auto configure = [&]() {
+    auto const configure_at = Now();
+    auto psp = LoraGatewayPowerSaveParam{};
+    psp.lora_gateway_spreading_factor = kLoraGatewaySpreadingFactor::kSF7;
+    psp.lora_gateway_band_width = kLoraGatewayBandWidth::kBandWidth500K;
+    psp.lora_gateway_coding_rate = kLoraGatewayCodingRate::kCR4_5;
+    driver.SetPowerSaveParam(psp)->StatusEvent().Subscribe(ActionHandler{
+        OnResult{[&, configure_at]() {
+          result.configure = Since(configure_at);
+          send_packets();
+        }},
+        OnError{[&]() { exit_code = 2; }},
+    });
+  };
+
+  driver.Start()->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[&]() {
+        result.startup = Since(started_at);
+        configure();
+      }},
+      OnError{[&]() { exit_code = 1; }},
+  });
+
+  while (!exit_code) {
+    auto next_time = app.Update(Now());
+    app.WaitUntil(std::min(next_time, started_at + kTimeout));
+    if (Now() >= started_at + kTimeout) {
+      AE_TELED_ERROR("Benchmark timeout");
+      exit_code = 5;
+    }
+  }
+
+  if (*exit_code != 0) {
+    return *exit_code;
+  }
+  Print(mode, module, result);
+  PrintQueue(driver);
+  return 0;
+}
+
+int SimLr02Bench() {
+  auto app = AetherApp::Construct(AetherAppContext{});
+
+  auto serial = BenchResult{};
+  auto res = RunBench(*app, Mode::kSerial, serial);
+  if (res != 0) {
+    return res;
+  }
+  auto pipelined = BenchResult{};
+  res = RunBench(*app, Mode::kPipelined, pipelined);
+  if (res != 0) {
+    return res;
+  }
+
+  auto const gain = static_cast<double>(Ms(*serial.echo)) /
+                    static_cast<double>(std::max<std::int64_t>(
+                        Ms(*pipelined.echo), 1));
+  std::cout << Format("Pipelined throughput gain {}%\n",
+                      static_cast<int>(gain * 100));
+  if (gain < kMinPipelineGain) {
+    std::cerr << Format("Pipelined throughput gain is below {}%\n",
+                        static_cast<int>(kMinPipelineGain * 100));
+    return 6;
+  }
+  return 0;
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimLr02Bench(); }
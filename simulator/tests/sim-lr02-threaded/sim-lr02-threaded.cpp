@@ -0,0 +1,149 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <thread>
+#include <iostream>
+
+#include "aether/all.h"
+
+#include "lora_gateways/dx_smart_lr02_gw.h"
+#include "lora_gateways/threaded_lora_gateway.h"
+
+#include "sim-lora/lora-sim-lr02.h"
+
+namespace ae::gw::sim {
+static constexpr std::size_t kPackets = 10;
+static constexpr auto kTimeout = std::chrono::seconds{60};
+
+/**
+ * \brief Emulated module echoing each air packet back, lives on the radio
+ * thread with the driver.
+ */
+struct EchoModule {
+  explicit EchoModule(ActionContext action_context)
+      : module{action_context, LoraSimLr02::Config{}} {
+    air_sub = module.air_event().Subscribe(
+        [this](auto const& /* target */, auto const& data) {
+          module.AirReceive(data);
+        });
+  }
+
+  LoraSimLr02 module;
+  Subscription air_sub;
+};
+
+/**
+ * \brief LR02 driver on the radio thread of ThreadedLoraGateway.
+ * The packets written on the gateway loop are echoed by the module, the
+ * write operations must complete and the echoes must be received on the
+ * gateway loop.
+ */
+int SimLr02Threaded() {
+  auto app = AetherApp::Construct(AetherAppContext{});
+  auto action_context = ActionContext{*app->aether()};
+  auto const gateway_thread = std::this_thread::get_id();
+
+  auto lora_gateway_init = LoraGatewayInit{};
+  lora_gateway_init.serial_init.baud_rate = kBaudRate::kBaudRate9600;
+
+  auto lora_gateway = ThreadedLoraGateway{
+      action_context, app->aether()->action_processor->get_trigger(),
+      [&](ActionContext radio_context) -> std::unique_ptr<ILoraGatewayDriver> {
+        // the driver owns the module through the port creator, both are
+        // destroyed on the radio thread
+        auto echo_module = std::make_shared<EchoModule>(radio_context);
+        return std::make_unique<DxSmartLr02LoraGateway>(
+            radio_context,
+            [echo_module](auto const& serial_init) {
+              return echo_module->module.OpenPort(serial_init);
+            },
+            lora_gateway_init);
+      }};
+
+  auto on_gateway_loop = [&](int error_code) {
+    if (std::this_thread::get_id() != gateway_thread) {
+      AE_TELED_ERROR("Radio thread event is not on the gateway loop");
+      app->Exit(error_code);
+      return false;
+    }
+    return true;
+  };
+
+  std::size_t written = 0;
+  std::size_t echoed = 0;
+  auto check_done = [&]() {
+    if ((written == kPackets) && (echoed == kPackets)) {
+      app->Exit(0);
+    }
+  };
+
+  auto data_sub = lora_gateway.data_event().Subscribe(
+      [&](auto /* connection */, DataBuffer const& data) {
+        if (!on_gateway_loop(3)) {
+          return;
+        }
+        if ((data.size() != 1) || (data[0] != echoed)) {
+          AE_TELED_ERROR("Unexpected echo of {} bytes", data.size());
+          app->Exit(4);
+          return;
+        }
+        ++echoed;
+        check_done();
+      });
+
+  lora_gateway.Start()->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[&]() {
+        if (!on_gateway_loop(2)) {
+          return;
+        }
+        for (std::size_t i = 0; i < kPackets; ++i) {
+          auto data = DataBuffer{static_cast<std::uint8_t>(i)};
+          lora_gateway.WritePacket(ConnectionLoraGatewayIndex{0}, data)
+              ->StatusEvent()
+              .Subscribe(ActionHandler{
+                  OnResult{[&]() {
+                    if (on_gateway_loop(5)) {
+                      ++written;
+                      check_done();
+                    }
+                  }},
+                  OnError{[&]() { app->Exit(6); }},
+              });
+        }
+      }},
+      OnError{[&]() { app->Exit(1); }},
+  });
+
+  auto const started_at = Now();
+  while (!app->IsExited()) {
+    lora_gateway.Poll();
+    auto next_time = app->Update(Now());
+    app->WaitUntil(std::min(next_time, started_at + kTimeout));
+    if (Now() >= started_at + kTimeout) {
+      AE_TELED_ERROR("Threaded gateway scenario timeout");
+      app->Exit(7);
+    }
+  }
+
+  auto const stats = lora_gateway.stats();
+  std::cout << Format("Written {} echoed {} rx overruns {} tx rejected {}\n",
+                      written, echoed, stats.rx_overruns, stats.tx_rejected);
+  return app->ExitCode();
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimLr02Threaded(); }
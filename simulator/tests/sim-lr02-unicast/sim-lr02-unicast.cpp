@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <iostream>
+
+#include "aether/all.h"
+
+#include "lora_gateways/dx_smart_lr02_gw.h"
+#include "lora_gateways/lora_gateway_frame.h"
+
+#include "sim-lora/lora-sim-lr02.h"
+
+namespace ae::gw::sim {
+static constexpr auto kTimeout = std::chrono::seconds{30};
+static constexpr std::uint8_t kBoundDevice = 1;
+static constexpr std::uint8_t kUnboundDevice = 2;
+
+struct Expected {
+  LoraDeviceAddress target;
+  DataBuffer air_data;
+};
+
+DataBuffer Frame(std::uint8_t device_id, DataBuffer const& data) {
+  LoraGatewayPacket lora_packet{};
+  lora_packet.connection.connect_index =
+      static_cast<ConnectionLoraGatewayIndex>(device_id);
+  lora_packet.length = data.size();
+  lora_packet.data = data;
+  return LoraGatewayFrame::Encode(lora_packet);
+}
+
+/**
+ * \brief Downlink addressing of the LR02 driver.
+ * A packet written while the switch to fixed-point mode is still queued goes
+ * without the target prefix, then the bound device is sent to as unicast and
+ * the unbound one as broadcast on the gateway channel.
+ */
+int SimLr02Unicast() {
+  auto app = AetherApp::Construct(AetherAppContext{});
+  auto action_context = ActionContext{*app->aether()};
+
+  auto module_config = LoraSimLr02::Config{};
+  module_config.baud_rate = kBaudRate::kBaudRate9600;
+  auto module = LoraSimLr02{action_context, module_config};
+
+  auto const bound_address = LoraDeviceAddress{0x1234, 5};
+  auto const data = DataBuffer{'u', 'n', 'i', 'c', 'a', 's', 't'};
+  auto expected = std::vector<Expected>{
+      // transparent mode, whatever the target
+      {LoraDeviceAddress{}, Frame(kBoundDevice, data)},
+      {bound_address, Frame(kBoundDevice, data)},
+      {LoraDeviceAddress{LoraDeviceAddress::kBroadcast, 0},
+       Frame(kUnboundDevice, data)},
+  };
+  std::size_t received = 0;
+
+  auto air_sub = module.air_event().Subscribe(
+      [&](auto const& target, auto const& air_data) {
+        if (received >= expected.size()) {
+          AE_TELED_ERROR("Unexpected air packet");
+          app->Exit(3);
+          return;
+        }
+        auto const& exp = expected[received++];
+        if ((target != exp.target) || (air_data != exp.air_data)) {
+          std::cerr << Format(
+              "Packet {} sent to {}:{} with {} bytes, expected {}:{} with {} "
+              "bytes\n",
+              received, target.address, static_cast<int>(target.channel),
+              air_data.size(), exp.target.address,
+              static_cast<int>(exp.target.channel), exp.air_data.size());
+          app->Exit(4);
+          return;
+        }
+        if (received == expected.size()) {
+          app->Exit(0);
+        }
+      });
+
+  auto lora_gateway_init = LoraGatewayInit{};
+  lora_gateway_init.serial_init.baud_rate = kBaudRate::kBaudRate9600;
+  auto driver = DxSmartLr02LoraGateway{
+      action_context,
+      [&](auto const& serial_init) { return module.OpenPort(serial_init); },
+      lora_gateway_init};
+  driver.BindDevice(kBoundDevice, bound_address);
+
+  auto write = [&](std::uint8_t device_id) {
+    driver
+        .WritePacket(static_cast<ConnectionLoraGatewayIndex>(device_id), data)
+        ->StatusEvent()
+        .Subscribe(OnError{[&]() { app->Exit(5); }});
+  };
+
+  driver.Start()->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[&]() {
+        auto psp = LoraGatewayPowerSaveParam{};
+        psp.lora_gateway_mode = kLoraGatewayMode::kFixedPointTransmission;
+        driver.SetPowerSaveParam(psp)->StatusEvent().Subscribe(ActionHandler{
+            OnResult{[&]() {
+              write(kBoundDevice);
+              write(kUnboundDevice);
+            }},
+            OnError{[&]() { app->Exit(2); }},
+        });
+        // the data lane goes before the configuration
+        write(kBoundDevice);
+      }},
+      OnError{[&]() { app->Exit(1); }},
+  });
+
+  auto const started_at = Now();
+  while (!app->IsExited()) {
+    auto next_time = app->Update(Now());
+    app->WaitUntil(std::min(next_time, started_at + kTimeout));
+    if (Now() >= started_at + kTimeout) {
+      AE_TELED_ERROR("Unicast scenario timeout");
+      app->Exit(6);
+    }
+  }
+  return app->ExitCode();
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimLr02Unicast(); }
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <iostream>
+
+#include "aether/all.h"
+
+#include "lora_gateways/dx_smart_lr02_gw.h"
+#include "lora_gateways/multi_lora_gateway.h"
+#include "lora_gateways/lora_gateway_frame.h"
+
+#include "sim-lora/lora-sim-lr02.h"
+
+namespace ae::gw::sim {
+static constexpr auto kTimeout = std::chrono::seconds{60};
+static constexpr std::uint8_t kChannelA = 1;
+static constexpr std::uint8_t kChannelB = 2;
+// devices bound to the channels
+static constexpr std::uint8_t kDeviceA = 1;
+static constexpr std::uint8_t kDeviceB = 2;
+// devices not bound, heard by one of the radios
+static constexpr std::uint8_t kHeardA = 3;
+static constexpr std::uint8_t kHeardB = 4;
+
+DataBuffer Frame(std::uint8_t device_id, DataBuffer const& data) {
+  LoraGatewayPacket lora_packet{};
+  lora_packet.connection.connect_index =
+      static_cast<ConnectionLoraGatewayIndex>(device_id);
+  lora_packet.length = data.size();
+  lora_packet.data = data;
+  return LoraGatewayFrame::Encode(lora_packet);
+}
+
+/**
+ * \brief Two LR02 modules on different channels behind MultiLoraGateway.
+ * Uplink of both modules comes through the aggregated data event. Downlink
+ * to a bound device goes through the radio on its channel and downlink to an
+ * unbound device through the radio it was heard by.
+ */
+int SimMultiLora() {
+  auto app = AetherApp::Construct(AetherAppContext{});
+  auto action_context = ActionContext{*app->aether()};
+
+  auto module_a = LoraSimLr02{action_context, LoraSimLr02::Config{}};
+  auto module_b = LoraSimLr02{action_context, LoraSimLr02::Config{}};
+
+  auto make_radio = [&](LoraSimLr02& module, std::uint8_t channel) {
+    auto lora_gateway_init = LoraGatewayInit{};
+    lora_gateway_init.serial_init.baud_rate = kBaudRate::kBaudRate9600;
+    lora_gateway_init.lora_gateway_channel = channel;
+    return MultiLoraGateway::RadioInit{
+        std::make_unique<DxSmartLr02LoraGateway>(
+            action_context,
+            [&module](auto const& serial_init) {
+              return module.OpenPort(serial_init);
+            },
+            lora_gateway_init),
+        channel};
+  };
+  auto radios = std::vector<MultiLoraGateway::RadioInit>{};
+  radios.push_back(make_radio(module_a, kChannelA));
+  radios.push_back(make_radio(module_b, kChannelB));
+  auto lora_gateway = MultiLoraGateway{action_context, std::move(radios)};
+  lora_gateway.BindDevice(kDeviceA, LoraDeviceAddress{0x0001, kChannelA});
+  lora_gateway.BindDevice(kDeviceB, LoraDeviceAddress{0x0002, kChannelB});
+
+  auto const data = DataBuffer{'m', 'u', 'l', 't', 'i'};
+  // downlink of each device and the module it must go through
+  auto const expected = std::map<std::uint8_t, LoraSimLr02 const*>{
+      {kDeviceA, &module_a},
+      {kDeviceB, &module_b},
+      {kHeardA, &module_a},
+      {kHeardB, &module_b},
+  };
+  std::map<std::uint8_t, LoraSimLr02 const*> sent;
+
+  auto on_air = [&](LoraSimLr02 const& module, DataBuffer const& air_data) {
+    for (auto const& [device_id, exp_module] : expected) {
+      if (air_data != Frame(device_id, data)) {
+        continue;
+      }
+      if (exp_module != &module) {
+        AE_TELED_ERROR("Downlink to device {} is sent by wrong radio",
+                       static_cast<int>(device_id));
+        app->Exit(4);
+        return;
+      }
+      sent.emplace(device_id, &module);
+      if (sent.size() == expected.size()) {
+        app->Exit(0);
+      }
+      return;
+    }
+    AE_TELED_ERROR("Unexpected air packet of {} bytes", air_data.size());
+    app->Exit(5);
+  };
+  auto air_a_sub = module_a.air_event().Subscribe(
+      [&](auto const& /* target */, auto const& air_data) {
+        on_air(module_a, air_data);
+      });
+  auto air_b_sub = module_b.air_event().Subscribe(
+      [&](auto const& /* target */, auto const& air_data) {
+        on_air(module_b, air_data);
+      });
+
+  auto write_all = [&]() {
+    for (auto const& [device_id, _] : expected) {
+      lora_gateway
+          .WritePacket(static_cast<ConnectionLoraGatewayIndex>(device_id),
+                       data)
+          ->StatusEvent()
+          .Subscribe(OnError{[&]() { app->Exit(6); }});
+    }
+  };
+
+  // uplink of both radios comes through the one data event
+  std::vector<ConnectionLoraGatewayIndex> heard;
+  auto data_sub = lora_gateway.data_event().Subscribe(
+      [&](auto connect_index, DataBuffer const& uplink) {
+        if (uplink != data) {
+          AE_TELED_ERROR("Unexpected uplink of {} bytes", uplink.size());
+          app->Exit(3);
+          return;
+        }
+        heard.push_back(connect_index);
+        if (heard.size() == 2) {
+          write_all();
+        }
+      });
+
+  lora_gateway.Start()->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[&]() {
+        module_a.AirReceive(Frame(kHeardA, data));
+        module_b.AirReceive(Frame(kHeardB, data));
+      }},
+      OnError{[&]() { app->Exit(1); }},
+  });
+
+  auto const started_at = Now();
+  while (!app->IsExited()) {
+    auto next_time = app->Update(Now());
+    app->WaitUntil(std::min(next_time, started_at + kTimeout));
+    if (Now() >= started_at + kTimeout) {
+      AE_TELED_ERROR("Multi radio scenario timeout");
+      app->Exit(7);
+    }
+  }
+
+  std::cout << Format("Radios {} heard {} downlink {}\n",
+                      lora_gateway.radio_count(), heard.size(), sent.size());
+  return app->ExitCode();
+}
+}  // namespace ae::gw::sim
+
+int main() { return ae::gw::sim::SimMultiLora(); }
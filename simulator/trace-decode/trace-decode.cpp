@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "aether/all.h"
+
+#include "gateway/trace_ring.h"
+
+namespace ae::gw {
+/**
+ * \brief Print the binary dump of TraceRing as text, a line per record.
+ */
+int TraceDecode(char const* path) {
+  auto file = std::ifstream{path, std::ios::binary};
+  if (!file) {
+    std::cerr << Format("Unable to open {}\n", path);
+    return 1;
+  }
+  auto const dump = DataBuffer{std::istreambuf_iterator<char>{file},
+                               std::istreambuf_iterator<char>{}};
+  auto const dumped = TraceRing::Parse(dump);
+  if (!dumped) {
+    std::cerr << Format("{} is not a trace dump\n", path);
+    return 1;
+  }
+
+  std::cout << Format("# {} events traced, 1 in {} sampled, {} records\n",
+                      dumped->events, dumped->sample_every,
+                      dumped->records.size());
+  std::cout << "# time_us event device size client server\n";
+  // record time wraps at 2^32 us, records are in time order
+  std::uint64_t epoch = 0;
+  std::uint32_t last_time = 0;
+  for (auto const& record : dumped->records) {
+    if (record.time_us < last_time) {
+      epoch += std::uint64_t{1} << 32;
+    }
+    last_time = record.time_us;
+    std::cout << Format("{} {} {} {} {} {}\n", epoch + record.time_us,
+                        TraceRing::EventName(record.event),
+                        static_cast<int>(record.device_id), record.size,
+                        record.client_id, record.server_id);
+  }
+  return 0;
+}
+}  // namespace ae::gw
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: trace-decode <trace dump>\n";
+    return 2;
+  }
+  return ae::gw::TraceDecode(argv[1]);
+}
@@ -17,19 +17,26 @@
 #ifndef AETHER_CONSTRUCT_LORA_GATEWAY_H_
 #define AETHER_CONSTRUCT_LORA_GATEWAY_H_
 
+#include <array>
+
 #include "aether_construct.h"
+#include "lora_gateways/lora_device_registry.h"
 #include "lora_gateways/lora_gateway_driver_types.h"
 
 #if CLOUD_TEST_LORA_GATEWAY
 
 namespace ae::gateway_server {
+// parent of the gateway client
+static constexpr Uid kParentUid =
+    Uid::FromString("3ac93165-3d37-4970-87a6-fa4ee27744e4");
+
 static constexpr std::string_view kSerialPortLoraGateway =
     "COM1";  // Lora gateway serial port
 SerialInit serial_init_lora_gateway = {std::string(kSerialPortLoraGateway),
                                        kBaudRate::kBaudRate9600};
 
 ae::LoraGatewayPowerSaveParam psp{
-    {kLoraGatewayMode::kTransparentTransmission},  // kLoraGatewayMode
+    {kLoraGatewayMode::kFixedPointTransmission},   // kLoraGatewayMode
     {kLoraGatewayLevel::kLevel0},                  // kLoraGatewayLevel
     {kLoraGatewayPower::kPower22},                 // kLoraGatewayPower
     {kLoraGatewayBandWidth::kBandWidth125K},       // kLoraGatewayBandWidth
@@ -46,6 +53,66 @@ ae::LoraGatewayInit const lora_gateway_init{
     {kLoraGatewayCRCCheck::kCRCOff},           // CRC check
     {kLoraGatewayIQSignalInversion::kIQoff}};  // Signal inversion
 
+// radio modules served together with the configured one, each on its own
+// serial port and channel, none by default
+struct LoraRadio {
+  std::string_view serial_port;
+  std::uint8_t channel;
+};
+
+static constexpr std::array<LoraRadio, 0> kLoraExtraRadios{};
+
+// runtime config, a file path on hosts and an NVS namespace on ESP32
+#  if defined(ESP_PLATFORM)
+static constexpr std::string_view kConfigLocation = "gateway";
+#  else
+static constexpr std::string_view kConfigLocation = "gateway.conf";
+#  endif
+
+// metrics dump, a prometheus text file on hosts and the log on ESP32
+#  if defined(ESP_PLATFORM)
+static constexpr std::string_view kMetricsLocation = "";
+#  else
+static constexpr std::string_view kMetricsLocation = "gateway.prom";
+#  endif
+
+// packet trace dump with the metrics, for the trace decoder, none on ESP32
+#  if defined(ESP_PLATFORM)
+static constexpr std::string_view kTraceLocation = "";
+#  else
+static constexpr std::string_view kTraceLocation = "gateway.trace";
+#  endif
+
+// selective repeat ARQ between the gateway and the devices, off by default,
+// it adds its header to each frame and the devices have to speak it too
+static constexpr bool kLoraArq = false;
+
+// adaptive data rate of the gateway radio, fed by the ARQ acknowledgements,
+// off by default, the devices are not told to follow the gateway data rate
+static constexpr bool kLoraAdr = false;
+
+// serve the radio on its own thread, apart from the cloud streams, on hosts
+// only, ESP32 serves everything on the one loop
+#  if defined(ESP_PLATFORM)
+static constexpr bool kLoraRadioThread = false;
+#  else
+static constexpr bool kLoraRadioThread = true;
+#  endif
+
+// device module known to the gateway, downlink to it is unicast
+struct LoraDevice {
+  std::uint8_t device_id;
+  LoraDeviceAddress address;
+  // the module listens all the time, downlink is not held until the receive
+  // window after its uplink, false for sleeping battery devices
+  bool always_listening;
+};
+
+LoraDevice const lora_devices[] = {
+    {1, {0x0001, 0}, true},  // Device 1
+    {2, {0x0002, 0}, true},  // Device 2
+};
+
 static RcPtr<AetherApp> construct_aether_app() {
   return AetherApp::Construct(
       AetherAppContext()
@@ -0,0 +1,566 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway_config.h"
+
+#include <tuple>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+
+#if defined(ESP_PLATFORM)
+#  include <nvs.h>
+#elif defined(__linux__)
+#  include <poll.h>
+#  include <unistd.h>
+#  include <sys/eventfd.h>
+#  include <sys/inotify.h>
+
+#  include <array>
+#  include <cerrno>
+#  include <thread>
+#  define GATEWAY_CONFIG_INOTIFY 1
+#endif
+
+#include "aether/tele/tele.h"
+
+namespace ae::gateway_server {
+namespace {
+std::string_view Trim(std::string_view str) {
+  auto const begin = str.find_first_not_of(" \t\r");
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  auto const end = str.find_last_not_of(" \t\r");
+  return str.substr(begin, end - begin + 1);
+}
+
+std::optional<std::int64_t> ParseInt(std::string_view value) {
+  std::int64_t result{};
+  auto const* end = value.data() + value.size();
+  auto [ptr, ec] = std::from_chars(value.data(), end, result);
+  if ((ec != std::errc{}) || (ptr != end)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+template <typename T>
+bool SetInt(T& field, std::string_view value, std::int64_t min,
+            std::int64_t max) {
+  auto number = ParseInt(value);
+  if (!number || (*number < min) || (*number > max)) {
+    return false;
+  }
+  field = static_cast<T>(*number);
+  return true;
+}
+
+template <typename T>
+bool SetInt(T& field, std::string_view value) {
+  return SetInt(field, value, std::numeric_limits<T>::min(),
+                static_cast<std::int64_t>(std::numeric_limits<T>::max()));
+}
+
+template <typename E>
+bool SetEnum(E& field, std::string_view value, std::int64_t min,
+             std::int64_t max) {
+  auto raw = static_cast<std::underlying_type_t<E>>(field);
+  if (!SetInt(raw, value, min, max)) {
+    return false;
+  }
+  field = static_cast<E>(raw);
+  return true;
+}
+
+template <typename D>
+bool SetMilliseconds(D& field, std::string_view value) {
+  std::uint32_t ms{};
+  if (!SetInt(ms, value)) {
+    return false;
+  }
+  field = std::chrono::duration_cast<D>(std::chrono::milliseconds{ms});
+  return true;
+}
+
+bool SetBaudRate(kBaudRate& field, std::string_view value) {
+  static constexpr std::pair<std::int64_t, kBaudRate> kBaudRates[] = {
+      {1200, kBaudRate::kBaudRate1200},
+      {2400, kBaudRate::kBaudRate2400},
+      {4800, kBaudRate::kBaudRate4800},
+      {9600, kBaudRate::kBaudRate9600},
+      {19200, kBaudRate::kBaudRate19200},
+      {38400, kBaudRate::kBaudRate38400},
+      {57600, kBaudRate::kBaudRate57600},
+      {115200, kBaudRate::kBaudRate115200},
+      {128000, kBaudRate::kBaudRate128000},
+  };
+  auto number = ParseInt(value);
+  if (!number) {
+    return false;
+  }
+  for (auto const& [bits, baud_rate] : kBaudRates) {
+    if (bits == *number) {
+      field = baud_rate;
+      return true;
+    }
+  }
+  return false;
+}
+
+struct ConfigField {
+  std::string_view key;
+  bool (*set)(GatewayConfig& config, std::string_view value);
+};
+
+constexpr ConfigField kConfigFields[] = {
+    {"serial_port",
+     [](auto& config, auto value) {
+       config.lora_gateway_init.serial_init.port_name = std::string{value};
+       return !value.empty();
+     }},
+    {"baud_rate",
+     [](auto& config, auto value) {
+       return SetBaudRate(config.lora_gateway_init.serial_init.baud_rate,
+                          value);
+     }},
+    {"lora_mode",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.psp.lora_gateway_mode, value, 0,
+                      2);
+     }},
+    {"lora_level",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.psp.lora_gateway_level, value,
+                      0, 7);
+     }},
+    {"lora_power",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.psp.lora_gateway_power, value,
+                      0, 22);
+     }},
+    {"lora_bw",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.psp.lora_gateway_band_width,
+                      value, 0, 9);
+     }},
+    {"lora_cr",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.psp.lora_gateway_coding_rate,
+                      value, 1, 4);
+     }},
+    {"lora_sf",
+     [](auto& config, auto value) {
+       return SetEnum(
+           config.lora_gateway_init.psp.lora_gateway_spreading_factor, value,
+           5, 12);
+     }},
+    {"lora_freq",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.lora_gateway_freq_range, value,
+                      -1, 7);
+     }},
+    {"lora_address",
+     [](auto& config, auto value) {
+       return SetInt(config.lora_gateway_init.lora_gateway_my_adress, value);
+     }},
+    {"lora_channel",
+     [](auto& config, auto value) {
+       return SetInt(config.lora_gateway_init.lora_gateway_channel, value);
+     }},
+    {"lora_crc",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.lora_gateway_crc_check, value,
+                      0, 1);
+     }},
+    {"lora_iq",
+     [](auto& config, auto value) {
+       return SetEnum(config.lora_gateway_init.lora_gateway_signal_inversion,
+                      value, 0, 1);
+     }},
+    {"mux_enabled",
+     [](auto& config, auto value) {
+       return SetInt(config.multiplex_config.enabled, value, 0, 1);
+     }},
+    {"mux_window_ms",
+     [](auto& config, auto value) {
+       return SetMilliseconds(config.multiplex_config.flush_window, value);
+     }},
+    {"mux_max_size",
+     [](auto& config, auto value) {
+       return SetInt(config.multiplex_config.max_packet_size, value, 1,
+                     std::numeric_limits<std::uint16_t>::max());
+     }},
+    {"ss_window",
+     [](auto& config, auto value) {
+       return SetInt(config.safe_stream_config.window_size, value);
+     }},
+    {"ss_max_repeat",
+     [](auto& config, auto value) {
+       return SetInt(config.safe_stream_config.max_repeat_count, value);
+     }},
+    {"ss_confirm_ms",
+     [](auto& config, auto value) {
+       return SetMilliseconds(config.safe_stream_config.wait_confirm_timeout,
+                              value);
+     }},
+    {"ss_repeat_ms",
+     [](auto& config, auto value) {
+       return SetMilliseconds(config.safe_stream_config.send_repeat_timeout,
+                              value);
+     }},
+};
+
+auto PowerSaveParamTie(LoraGatewayPowerSaveParam const& psp) {
+  return std::tie(psp.lora_gateway_mode, psp.lora_gateway_level,
+                  psp.lora_gateway_power, psp.lora_gateway_band_width,
+                  psp.lora_gateway_coding_rate,
+                  psp.lora_gateway_spreading_factor);
+}
+
+auto SerialInitTie(SerialInit const& init) {
+  return std::tie(init.port_name, init.baud_rate, init.parity,
+                  init.stop_bits);
+}
+
+auto ModuleInitTie(LoraGatewayInit const& init) {
+  return std::tie(init.lora_gateway_freq_range, init.lora_gateway_my_adress,
+                  init.lora_gateway_channel, init.lora_gateway_crc_check,
+                  init.lora_gateway_signal_inversion);
+}
+
+auto MultiplexConfigTie(gw::MultiplexConfig const& config) {
+  return std::tie(config.enabled, config.flush_window,
+                  config.max_packet_size);
+}
+
+auto SafeStreamConfigTie(SafeStreamConfig const& config) {
+  return std::tie(config.window_size, config.max_repeat_count,
+                  config.wait_confirm_timeout, config.send_repeat_timeout);
+}
+}  // namespace
+
+ConfigValues ParseConfigText(std::string_view text) {
+  ConfigValues values;
+  while (!text.empty()) {
+    auto const line_end = text.find('\n');
+    auto line = text.substr(0, line_end);
+    text.remove_prefix(
+        line_end == std::string_view::npos ? text.size() : line_end + 1);
+
+    line = line.substr(0, line.find('#'));
+    auto const eq = line.find('=');
+    if (eq == std::string_view::npos) {
+      if (!Trim(line).empty()) {
+        AE_TELED_ERROR("Config line without value: {}", std::string{line});
+      }
+      continue;
+    }
+    values.insert_or_assign(std::string{Trim(line.substr(0, eq))},
+                            std::string{Trim(line.substr(eq + 1))});
+  }
+  return values;
+}
+
+GatewayConfig ApplyConfigValues(GatewayConfig config,
+                                ConfigValues const& values) {
+  for (auto const& [key, value] : values) {
+    auto const* field = std::find_if(
+        std::begin(kConfigFields), std::end(kConfigFields),
+        [&key = key](auto const& f) { return f.key == key; });
+    if (field == std::end(kConfigFields)) {
+      AE_TELED_ERROR("Unknown config key {}", key);
+      continue;
+    }
+    auto updated = config;
+    if (!field->set(updated, value)) {
+      AE_TELED_ERROR("Invalid config value {} = {}", key, value);
+      continue;
+    }
+    config = std::move(updated);
+  }
+  return config;
+}
+
+std::vector<std::string_view> ConfigKeys() {
+  std::vector<std::string_view> keys;
+  keys.reserve(std::size(kConfigFields));
+  for (auto const& field : kConfigFields) {
+    keys.push_back(field.key);
+  }
+  return keys;
+}
+
+GatewayConfigChanges CompareConfigs(GatewayConfig const& old_config,
+                                    GatewayConfig const& new_config) {
+  auto const& old_init = old_config.lora_gateway_init;
+  auto const& new_init = new_config.lora_gateway_init;
+  return GatewayConfigChanges{
+      PowerSaveParamTie(old_init.psp) != PowerSaveParamTie(new_init.psp),
+      SerialInitTie(old_init.serial_init) !=
+          SerialInitTie(new_init.serial_init),
+      ModuleInitTie(old_init) != ModuleInitTie(new_init),
+      MultiplexConfigTie(old_config.multiplex_config) !=
+          MultiplexConfigTie(new_config.multiplex_config),
+      SafeStreamConfigTie(old_config.safe_stream_config) !=
+          SafeStreamConfigTie(new_config.safe_stream_config),
+  };
+}
+
+GatewayConfigStore::GatewayConfigStore(std::string location)
+    : location_{std::move(location)} {}
+
+#if defined(ESP_PLATFORM)
+std::optional<ConfigValues> GatewayConfigStore::Load() const {
+  nvs_handle_t handle{};
+  if (nvs_open(location_.c_str(), NVS_READONLY, &handle) != ESP_OK) {
+    return std::nullopt;
+  }
+  ConfigValues values;
+  for (auto const& key : ConfigKeys()) {
+    auto const key_str = std::string{key};
+    std::size_t size{};
+    if (nvs_get_str(handle, key_str.c_str(), nullptr, &size) != ESP_OK) {
+      continue;
+    }
+    auto value = std::string(size, '\0');
+    if (nvs_get_str(handle, key_str.c_str(), value.data(), &size) != ESP_OK) {
+      continue;
+    }
+    // drop the terminating zero
+    value.resize(size - 1);
+    values.emplace(key_str, std::move(value));
+  }
+  nvs_close(handle);
+  return values;
+}
+
+std::optional<std::uint64_t> GatewayConfigStore::Version() const {
+  nvs_handle_t handle{};
+  if (nvs_open(location_.c_str(), NVS_READONLY, &handle) != ESP_OK) {
+    return std::nullopt;
+  }
+  std::uint32_t generation{};
+  auto res = nvs_get_u32(handle, "generation", &generation);
+  nvs_close(handle);
+  if (res != ESP_OK) {
+    return std::nullopt;
+  }
+  return generation;
+}
+#else
+std::optional<ConfigValues> GatewayConfigStore::Load() const {
+  auto file = std::ifstream{location_};
+  if (!file) {
+    return std::nullopt;
+  }
+  auto text = std::ostringstream{};
+  text << file.rdbuf();
+  return ParseConfigText(text.str());
+}
+
+std::optional<std::uint64_t> GatewayConfigStore::Version() const {
+  auto ec = std::error_code{};
+  auto const write_time = std::filesystem::last_write_time(location_, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return static_cast<std::uint64_t>(write_time.time_since_epoch().count());
+}
+#endif
+
+std::string const& GatewayConfigStore::location() const { return location_; }
+
+#if defined(GATEWAY_CONFIG_INOTIFY)
+/**
+ * \brief Watches the directory of the config file with inotify, editors
+ * often replace the file instead of writing it.
+ */
+class ConfigFileWatcher {
+ public:
+  ConfigFileWatcher(std::string const& location, ActionTrigger& trigger,
+                    std::atomic_bool& changed)
+      : trigger_{&trigger}, changed_{&changed} {
+    auto const path = std::filesystem::path{location};
+    file_name_ = path.filename().string();
+    auto directory = path.parent_path();
+    if (directory.empty()) {
+      directory = ".";
+    }
+
+    inotify_fd_ = inotify_init1(IN_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if ((inotify_fd_ < 0) || (stop_fd_ < 0) ||
+        (inotify_add_watch(inotify_fd_, directory.c_str(),
+                           IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE |
+                               IN_DELETE | IN_ATTRIB) < 0)) {
+      AE_TELED_WARNING("Config directory {} is not watched, errno {}",
+                       directory.string(), errno);
+      return;
+    }
+    thread_ = std::thread{[this]() { Run(); }};
+  }
+
+  ~ConfigFileWatcher() {
+    if (thread_.joinable()) {
+      std::uint64_t const stop = 1;
+      [[maybe_unused]] auto res = write(stop_fd_, &stop, sizeof(stop));
+      thread_.join();
+    }
+    if (inotify_fd_ >= 0) {
+      close(inotify_fd_);
+    }
+    if (stop_fd_ >= 0) {
+      close(stop_fd_);
+    }
+  }
+
+  bool ok() const { return thread_.joinable(); }
+
+ private:
+  void Run() {
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    auto fds = std::array{pollfd{inotify_fd_, POLLIN, 0},
+                          pollfd{stop_fd_, POLLIN, 0}};
+    while (true) {
+      if (poll(fds.data(), fds.size(), -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        AE_TELED_ERROR("Config watch failed, errno {}", errno);
+        return;
+      }
+      if (fds[1].revents != 0) {
+        return;
+      }
+      auto const size = read(inotify_fd_, buffer.data(), buffer.size());
+      if (size <= 0) {
+        continue;
+      }
+      bool changed = false;
+      for (auto offset = std::size_t{};
+           offset < static_cast<std::size_t>(size);) {
+        auto const* event =
+            reinterpret_cast<inotify_event const*>(buffer.data() + offset);
+        if ((event->len != 0) && (file_name_ == event->name)) {
+          changed = true;
+        }
+        offset += sizeof(inotify_event) + event->len;
+      }
+      if (changed) {
+        // the loop takes the change on its own thread
+        changed_->store(true, std::memory_order_release);
+        trigger_->Trigger();
+      }
+    }
+  }
+
+  ActionTrigger* trigger_;
+  std::atomic_bool* changed_;
+  std::string file_name_;
+  int inotify_fd_{-1};
+  int stop_fd_{-1};
+  std::thread thread_;
+};
+#else
+// no change notifications, the store is checked periodically
+class ConfigFileWatcher {
+ public:
+  ConfigFileWatcher(std::string const& /* location */,
+                    ActionTrigger& /* trigger */,
+                    std::atomic_bool& /* changed */) {}
+
+  bool ok() const { return false; }
+};
+#endif
+
+GatewayConfigReloader::GatewayConfigReloader(ActionContext action_context,
+                                             ActionTrigger& trigger,
+                                             GatewayConfigStore const& store,
+                                             GatewayConfig const& defaults)
+    : store_{&store},
+      defaults_{defaults},
+      config_{Load()},
+      check_at_{Now() + kCheckInterval},
+      check_action_{action_context, [this](auto now) { return Check(now); }} {
+  auto watcher = std::make_unique<ConfigFileWatcher>(store.location(), trigger,
+                                                     store_changed_);
+  if (watcher->ok()) {
+    watcher_ = std::move(watcher);
+  }
+}
+
+GatewayConfigReloader::~GatewayConfigReloader() = default;
+
+GatewayConfig const& GatewayConfigReloader::config() const { return config_; }
+
+GatewayConfigReloader::ChangedEvent::Subscriber
+GatewayConfigReloader::changed_event() {
+  return EventSubscriber{changed_event_};
+}
+
+void GatewayConfigReloader::Poll() {
+  if (store_changed_.exchange(false, std::memory_order_acq_rel)) {
+    Reload();
+  }
+}
+
+void GatewayConfigReloader::Reload() {
+  if (store_->Version() == version_) {
+    return;
+  }
+
+  auto new_config = Load();
+  auto const changes = CompareConfigs(config_, new_config);
+  if (!changes.power_save_param && !changes.serial_init &&
+      !changes.module_init && !changes.multiplex_config &&
+      !changes.safe_stream_config) {
+    return;
+  }
+  AE_TELED_INFO("Gateway config is reloaded");
+  auto old_config = std::exchange(config_, std::move(new_config));
+  changed_event_.Emit(old_config, config_);
+}
+
+bool GatewayConfigReloader::watched() const { return watcher_ != nullptr; }
+
+TimePoint GatewayConfigReloader::Check(TimePoint now) {
+  // the watcher tells about the changes
+  if (watcher_) {
+    return TimePoint::max();
+  }
+  if (now < check_at_) {
+    return check_at_;
+  }
+  check_at_ = now + kCheckInterval;
+  Reload();
+  return check_at_;
+}
+
+GatewayConfig GatewayConfigReloader::Load() {
+  version_ = store_->Version();
+  auto values = store_->Load();
+  if (!values) {
+    return defaults_;
+  }
+  return ApplyConfigValues(defaults_, *values);
+}
+}  // namespace ae::gateway_server
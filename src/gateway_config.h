@@ -0,0 +1,178 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_CONFIG_H_
+#define GATEWAY_CONFIG_H_
+
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "gateway/server_stream.h"
+#include "gateway/deadline_action.h"
+
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae::gateway_server {
+/**
+ * \brief Settings of the gateway server which may be changed at runtime.
+ */
+struct GatewayConfig {
+  LoraGatewayInit lora_gateway_init;
+  // for new server streams
+  gw::MultiplexConfig multiplex_config;
+  // not used by the gateway yet, changes are only logged
+  SafeStreamConfig safe_stream_config;
+};
+
+/**
+ * \brief Parts of GatewayConfig differing between two configs.
+ */
+struct GatewayConfigChanges {
+  // applied by the driver SetPowerSaveParam
+  bool power_save_param;
+  // serial port settings, applied on restart
+  bool serial_init;
+  // module settings, applied by the driver Configure
+  bool module_init;
+  bool multiplex_config;
+  bool safe_stream_config;
+};
+
+/**
+ * \brief Config values by key.
+ * Keys are short enough to be NVS keys.
+ * serial_port, baud_rate - serial port name and baud rate in bits/s
+ * lora_mode, lora_level, lora_power, lora_bw, lora_cr, lora_sf, lora_freq,
+ * lora_address, lora_channel, lora_crc, lora_iq - values of LoraGatewayInit
+ * mux_enabled, mux_window_ms, mux_max_size - gw::MultiplexConfig
+ * ss_window, ss_max_repeat, ss_confirm_ms, ss_repeat_ms - SafeStreamConfig,
+ * parsed but not applied yet
+ */
+using ConfigValues = std::map<std::string, std::string, std::less<>>;
+
+/**
+ * \brief Parse "key = value" lines, # starts a comment.
+ */
+ConfigValues ParseConfigText(std::string_view text);
+/**
+ * \brief Config with values applied over base config.
+ * Unknown keys and invalid values are logged and skipped.
+ */
+GatewayConfig ApplyConfigValues(GatewayConfig config,
+                                ConfigValues const& values);
+std::vector<std::string_view> ConfigKeys();
+GatewayConfigChanges CompareConfigs(GatewayConfig const& old_config,
+                                    GatewayConfig const& new_config);
+
+/**
+ * \brief Storage of config values.
+ * A text file on hosts and an NVS namespace of string values on ESP32.
+ */
+class GatewayConfigStore {
+ public:
+  /**
+   * \brief location is the file path or the NVS namespace.
+   */
+  explicit GatewayConfigStore(std::string location);
+
+  /**
+   * \brief Stored values, nullopt if there is no stored config.
+   */
+  std::optional<ConfigValues> Load() const;
+  /**
+   * \brief Changes on each update of the stored config.
+   * Modification time of the file, generation value in NVS.
+   */
+  std::optional<std::uint64_t> Version() const;
+
+  std::string const& location() const;
+
+ private:
+  std::string location_;
+};
+
+class ConfigFileWatcher;
+
+/**
+ * \brief Config of the store over the defaults, reloaded on store updates.
+ * On Linux the config file is watched with inotify on a thread of its own,
+ * the thread only sets a flag and triggers the loop, Poll takes it on the
+ * loop. Otherwise the store version is checked every kCheckInterval.
+ * changed_event is emitted if reloaded config differs from the current one.
+ */
+class GatewayConfigReloader {
+ public:
+  using ChangedEvent = Event<void(GatewayConfig const& old_config,
+                                  GatewayConfig const& new_config)>;
+
+  // the store is not watched, long enough to let an idle gateway sleep
+  static constexpr auto kCheckInterval = std::chrono::minutes{5};
+
+  /**
+   * \brief trigger is the trigger of the action processor of action_context.
+   */
+  GatewayConfigReloader(ActionContext action_context, ActionTrigger& trigger,
+                        GatewayConfigStore const& store,
+                        GatewayConfig const& defaults);
+  ~GatewayConfigReloader();
+
+  GatewayConfig const& config() const;
+  ChangedEvent::Subscriber changed_event();
+
+  /**
+   * \brief Reload if the store is changed, call it on the loop before each
+   * update.
+   */
+  void Poll();
+  /**
+   * \brief Check the store now, e.g. after the config is written.
+   */
+  void Reload();
+  /**
+   * \brief The store changes are watched, not checked periodically.
+   */
+  bool watched() const;
+
+ private:
+  TimePoint Check(TimePoint now);
+  GatewayConfig Load();
+
+  GatewayConfigStore const* store_;
+  GatewayConfig defaults_;
+  // set by Load, so goes before config_
+  std::optional<std::uint64_t> version_;
+  GatewayConfig config_;
+  TimePoint check_at_;
+  ChangedEvent changed_event_;
+  OwnActionPtr<gw::DeadlineAction> check_action_;
+  // set by the watcher thread, cleared by Poll
+  std::atomic_bool store_changed_{};
+  // the thread is stopped first
+  std::unique_ptr<ConfigFileWatcher> watcher_;
+};
+}  // namespace ae::gateway_server
+
+#endif  // GATEWAY_CONFIG_H_
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gateway_metrics.h"
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include "aether/tele/tele.h"
+
+namespace ae::gateway_server {
+namespace {
+/**
+ * \brief Replace the file by rename, so its readers never see it half
+ * written.
+ */
+bool ReplaceFile(std::string const& location, char const* data,
+                 std::size_t size) {
+  auto const temp_location = location + ".tmp";
+  {
+    auto file =
+        std::ofstream{temp_location, std::ios::trunc | std::ios::binary};
+    file.write(data, static_cast<std::streamsize>(size));
+    if (!file) {
+      AE_TELED_ERROR("Unable to write {}", temp_location);
+      return false;
+    }
+  }
+  if (std::rename(temp_location.c_str(), location.c_str()) != 0) {
+    AE_TELED_ERROR("Unable to replace file {}", location);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+MetricsExporter::MetricsExporter(ActionContext action_context,
+                                 gw::MetricsRegistry const& metrics,
+                                 std::string location)
+    : metrics_{&metrics},
+      location_{std::move(location)},
+      export_at_{Now() + kExportInterval},
+      export_action_{action_context,
+                     [this](auto now) { return Check(now); }} {}
+
+void MetricsExporter::SetTraceRing(gw::TraceRing const& trace_ring,
+                                   std::string trace_location) {
+  trace_ring_ = &trace_ring;
+  trace_location_ = std::move(trace_location);
+}
+
+void MetricsExporter::Export() {
+#if defined(ESP_PLATFORM)
+  AE_TELED_INFO("Metrics:\n{}", metrics_->CompactText());
+#else
+  auto const text = metrics_->PrometheusText();
+  ReplaceFile(location_, text.data(), text.size());
+#endif
+  ExportTrace();
+}
+
+void MetricsExporter::ExportTrace() {
+  if ((trace_ring_ == nullptr) || trace_location_.empty()) {
+    return;
+  }
+  auto const dump = trace_ring_->Dump();
+  ReplaceFile(trace_location_, reinterpret_cast<char const*>(dump.data()),
+              dump.size());
+}
+
+TimePoint MetricsExporter::Check(TimePoint now) {
+  if (now < export_at_) {
+    return export_at_;
+  }
+  export_at_ = now + kExportInterval;
+  Export();
+  return export_at_;
+}
+}  // namespace ae::gateway_server
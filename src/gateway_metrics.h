@@ -0,0 +1,74 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GATEWAY_METRICS_H_
+#define GATEWAY_METRICS_H_
+
+#include <chrono>
+#include <string>
+
+#include "aether/all.h"
+
+#include "gateway/trace_ring.h"
+#include "gateway/deadline_action.h"
+#include "gateway/metrics_registry.h"
+
+namespace ae::gateway_server {
+/**
+ * \brief Periodic dump of the gateway metrics.
+ * On hosts the Prometheus text is written to a file replaced by rename, so a
+ * scraper or the node exporter textfile collector never reads it half
+ * written. On ESP32 the compact text is written to the log.
+ * The packet trace ring may be dumped along with the metrics, to a binary file
+ * for the trace decoder.
+ */
+class MetricsExporter {
+ public:
+#if defined(ESP_PLATFORM)
+  static constexpr auto kExportInterval = std::chrono::minutes{1};
+#else
+  static constexpr auto kExportInterval = std::chrono::seconds{15};
+#endif
+
+  /**
+   * \brief location is the file path, unused on ESP32.
+   */
+  MetricsExporter(ActionContext action_context,
+                  gw::MetricsRegistry const& metrics, std::string location);
+
+  /**
+   * \brief Dump trace_ring to trace_location on each export.
+   */
+  void SetTraceRing(gw::TraceRing const& trace_ring,
+                    std::string trace_location);
+
+  void Export();
+
+ private:
+  TimePoint Check(TimePoint now);
+  void ExportTrace();
+
+  gw::MetricsRegistry const* metrics_;
+  std::string location_;
+  gw::TraceRing const* trace_ring_{};
+  std::string trace_location_;
+  TimePoint export_at_;
+  OwnActionPtr<gw::DeadlineAction> export_action_;
+};
+}  // namespace ae::gateway_server
+
+#endif  // GATEWAY_METRICS_H_
@@ -16,12 +16,33 @@
 
 #include "gateway_server.h"
 
+#include <ctime>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
 #define CLOUD_TEST_LORA_GATEWAY 1
 
 // IWYU pragma: begin_keeps
 #include "aether_construct_lora_gateway.h"
 // IWYU pragma: end_keeps
 
+#include "gateway/gateway.h"
+#include "gateway/arq_link.h"
+#include "gateway/fragment_link.h"
+#include "gateway/downlink_scheduler.h"
+
+#include "gateway_config.h"
+#include "gateway_metrics.h"
+
+#include "lora_gateways/lora_gateway_adr.h"
+#include "lora_gateways/lora_device_port.h"
+#include "lora_gateways/lora_gateway_factory.h"
+#include "lora_gateways/threaded_lora_gateway.h"
+
 namespace ae::gateway_server {
 constexpr ae::SafeStreamConfig kSafeStreamConfig{
     std::numeric_limits<std::uint16_t>::max(),                // buffer_capacity
@@ -32,6 +53,88 @@ constexpr ae::SafeStreamConfig kSafeStreamConfig{
     {},                              // send_confirm_timeout
     std::chrono::milliseconds{400},  // send_repeat_timeout
 };
+
+// domain object of the gateway, its state is loaded by this id
+constexpr ae::ObjId kGatewayObjId{1337};
+
+// payload of a radio frame, kLoraGatewayMTU of the LR02 driver
+constexpr std::uint16_t kLoraLinkMtu = 400;
+constexpr gw::Reassembler::Limits kLoraReassemblyLimits{
+    std::chrono::seconds{30},  // timeout
+    32 * 1024,                 // max_size
+    4,                         // max_messages
+};
+// a frame takes up to seconds on the air at the slow data rates
+constexpr gw::SelectiveRepeat::Config kLoraArqConfig{
+    std::chrono::seconds{2},         // initial_rto
+    std::chrono::milliseconds{200},  // min_rto
+    std::chrono::seconds{30},        // max_rto
+    8,                               // max_retries
+    64,                              // max_pending
+};
+// devices listen right after their uplink
+constexpr gw::DownlinkScheduler::Config kLoraDownlinkConfig{
+    std::chrono::milliseconds{0},  // rx_delay
+    std::chrono::seconds{2},       // rx_window
+    std::chrono::minutes{5},       // message_ttl
+    32,                            // max_queue_size
+};
+
+/**
+ * \brief Run loop load, reported at most once a minute on a natural wakeup.
+ * Busy time of a wakeup is the time to forward everything that woke the
+ * loop, CPU use is the process CPU time per wall time.
+ */
+class RunLoopStats {
+ public:
+  static constexpr auto kReportInterval = std::chrono::minutes{1};
+
+  RunLoopStats() : started_at_{Now()}, cpu_started_{std::clock()} {
+    report_at_ = started_at_ + kReportInterval;
+  }
+
+  void Update(TimePoint wake_time, TimePoint done_time) {
+    auto const busy =
+        std::chrono::duration_cast<Duration>(done_time - wake_time);
+    ++wakeups_;
+    busy_time_ += busy;
+    max_busy_ = std::max(max_busy_, busy);
+    if (done_time >= report_at_) {
+      Report(done_time);
+    }
+  }
+
+  void Report(TimePoint now) {
+    auto const wall = std::chrono::duration<double>{now - started_at_};
+    auto const cpu = static_cast<double>(std::clock() - cpu_started_) /
+                     CLOCKS_PER_SEC;
+    auto const to_us = [](Duration d) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    AE_TELED_INFO(
+        "Run loop: {} wakeups in {} s, busy avg {} us max {} us, cpu {}%",
+        wakeups_, static_cast<std::int64_t>(wall.count()),
+        wakeups_ != 0 ? to_us(busy_time_) / static_cast<std::int64_t>(wakeups_)
+                      : 0,
+        to_us(max_busy_),
+        wall.count() > 0 ? (100.0 * cpu) / wall.count() : 0.0);
+
+    started_at_ = now;
+    cpu_started_ = std::clock();
+    report_at_ = now + kReportInterval;
+    wakeups_ = 0;
+    busy_time_ = {};
+    max_busy_ = {};
+  }
+
+ private:
+  TimePoint started_at_;
+  TimePoint report_at_;
+  std::clock_t cpu_started_;
+  std::size_t wakeups_{};
+  Duration busy_time_{};
+  Duration max_busy_{};
+};
 }  // namespace ae::gateway_server
 
 int AetherGatewayServer() {
@@ -45,23 +148,202 @@ int AetherGatewayServer() {
    */
   auto aether_app = ae::gateway_server::construct_aether_app();
 
+  /**
+   * Register the gateway client, it opens the streams to the servers for the
+   * local devices.
+   */
+  auto select_gw_client =
+      aether_app->aether()->SelectClient(ae::gateway_server::kParentUid, 0);
+  aether_app->WaitActions(select_gw_client);
+  auto gw_client = select_gw_client->client();
+  if (!gw_client) {
+    AE_TELED_ERROR("Gateway client is not selected");
+    return 1;
+  }
+  auto gateway = aether_app->domain().CreateObj<ae::gw::Gateway>(
+      ae::gateway_server::kGatewayObjId, aether_app->aether(),
+      std::move(gw_client));
+  auto action_context = ae::ActionContext{*aether_app->aether()};
+
+  /**
+   * Runtime config over the compiled in defaults.
+   * It's reloaded on change, the radio module settings are applied to the
+   * driver and the multiplex settings to the new server streams. Serial port
+   * settings need a restart.
+   */
+  auto config_store = ae::gateway_server::GatewayConfigStore{
+      std::string{ae::gateway_server::kConfigLocation}};
+  auto const config_defaults =
+      ae::gateway_server::GatewayConfig{ae::gateway_server::lora_gateway_init,
+                                        {},
+                                        ae::gateway_server::kSafeStreamConfig};
+  auto config_reloader = ae::gateway_server::GatewayConfigReloader{
+      action_context, aether_app->aether()->action_processor->get_trigger(),
+      config_store, config_defaults};
+  auto const& config = config_reloader.config();
+  if (ae::gateway_server::CompareConfigs(config_defaults, config)
+          .safe_stream_config) {
+    AE_TELED_WARNING("Safe stream settings are not applied");
+  }
+  gateway->server_stream_manager().SetMultiplexConfig(config.multiplex_config);
+
+  /**
+   * Link layers between the local port and the radio.
+   * Frames to the devices are split to the radio MTU and the fragments from
+   * the devices are reassembled. Downlink to sleeping devices waits for their
+   * receive windows. Optional ARQ repairs radio losses hop by hop below the
+   * scheduler, so its retransmissions are not queued for the windows again,
+   * its header is taken from the MTU.
+   */
+  auto fragment_link = ae::gw::FragmentLink{
+      gateway->local_port(),
+      {static_cast<std::uint16_t>(
+           ae::gateway_server::kLoraLinkMtu -
+           (ae::gateway_server::kLoraArq
+                ? ae::gw::SelectiveRepeat::kDataHeaderSize
+                : 0)),
+       ae::gateway_server::kLoraReassemblyLimits}};
+  auto downlink_scheduler = ae::gw::DownlinkScheduler{
+      action_context, fragment_link, ae::gateway_server::kLoraDownlinkConfig};
+  std::optional<ae::gw::ArqLink> arq_link;
+  if constexpr (ae::gateway_server::kLoraArq) {
+    arq_link.emplace(action_context, downlink_scheduler,
+                     ae::gateway_server::kLoraArqConfig);
+    arq_link->SetMetrics(gateway->metrics());
+  }
+  ae::gw::ILocalLink& radio_link =
+      arq_link ? static_cast<ae::gw::ILocalLink&>(*arq_link)
+               : downlink_scheduler;
+
+  /**
+   * LoRa radios and their bridge to the gateway link layers.
+   * The extra radios share the settings of the configured one except for the
+   * serial port and the channel, all of them are served as one driver.
+   * Downlink to the known devices is unicast.
+   */
+  auto create_lora_gateway =
+      [poller{aether_app->aether()->poller},
+       lora_gateway_init{config.lora_gateway_init},
+       metrics{&gateway->metrics()}](ae::ActionContext radio_context) {
+        auto lora_gateway_inits =
+            std::vector<ae::LoraGatewayInit>{lora_gateway_init};
+        for (auto const& radio : ae::gateway_server::kLoraExtraRadios) {
+          auto radio_init = lora_gateway_init;
+          radio_init.serial_init =
+              ae::SerialInit{std::string{radio.serial_port},
+                             lora_gateway_init.serial_init.baud_rate};
+          radio_init.lora_gateway_channel = radio.channel;
+          lora_gateway_inits.push_back(std::move(radio_init));
+        }
+        return ae::LoraGatewayDriverFactory::CreateLoraGateway(
+            radio_context, poller, std::move(lora_gateway_inits), metrics);
+      };
+  std::unique_ptr<ae::ILoraGatewayDriver> lora_gateway;
+  ae::ThreadedLoraGateway* threaded_lora_gateway = nullptr;
+  if constexpr (ae::gateway_server::kLoraRadioThread) {
+    auto threaded = std::make_unique<ae::ThreadedLoraGateway>(
+        action_context, aether_app->aether()->action_processor->get_trigger(),
+        std::move(create_lora_gateway));
+    threaded_lora_gateway = threaded.get();
+    lora_gateway = std::move(threaded);
+  } else {
+    lora_gateway = create_lora_gateway(action_context);
+  }
+  for (auto const& device : ae::gateway_server::lora_devices) {
+    lora_gateway->BindDevice(device.device_id, device.address);
+    downlink_scheduler.SetAlwaysListening(device.device_id,
+                                          device.always_listening);
+  }
+  auto lora_device_port =
+      ae::LoraDevicePort{*lora_gateway, radio_link, gateway->buffer_pool(),
+                         config.lora_gateway_init.psp};
+  lora_gateway->Start();
+
+  /**
+   * Adaptive data rate of the radio.
+   * Each ARQ acknowledgement is a delivered frame and each frame given up
+   * after the retries a lost one, the radio settings follow the worst device
+   * link. Downlink held by the scheduler for sleeping devices is not sent
+   * to the ARQ link yet and is not counted.
+   */
+  auto lora_adr = ae::LoraGatewayAdr{{}, config.lora_gateway_init.psp};
+  ae::Subscription adr_delivery_sub;
+  ae::Subscription adr_param_sub;
+  if (ae::gateway_server::kLoraAdr && arq_link) {
+    adr_delivery_sub = arq_link->delivery_event().Subscribe(
+        [&](auto device_id, auto delivered) {
+          if (delivered) {
+            lora_adr.Delivered(device_id);
+          } else {
+            lora_adr.Lost(device_id);
+          }
+        });
+    adr_param_sub =
+        lora_adr.param_changed_event().Subscribe([&](auto const& psp) {
+          lora_gateway->SetPowerSaveParam(psp);
+          lora_device_port.SetPowerSaveParam(psp);
+        });
+  }
+
+  auto config_sub = config_reloader.changed_event().Subscribe(
+      [&](auto const& old_config, auto const& new_config) {
+        auto const changes =
+            ae::gateway_server::CompareConfigs(old_config, new_config);
+        if (changes.module_init) {
+          // the power save param goes with the other module settings
+          lora_gateway->Configure(new_config.lora_gateway_init);
+        } else if (changes.power_save_param) {
+          lora_gateway->SetPowerSaveParam(new_config.lora_gateway_init.psp);
+        }
+        if (changes.power_save_param) {
+          lora_device_port.SetPowerSaveParam(new_config.lora_gateway_init.psp);
+          // adapt from the operator settings, not over them
+          lora_adr.Reset(new_config.lora_gateway_init.psp);
+        }
+        if (changes.multiplex_config) {
+          gateway->server_stream_manager().SetMultiplexConfig(
+              new_config.multiplex_config);
+        }
+        if (changes.serial_init) {
+          AE_TELED_WARNING("Serial port settings are applied on restart");
+        }
+        if (changes.safe_stream_config) {
+          AE_TELED_WARNING("Safe stream settings are not applied");
+        }
+      });
+
+  /**
+   * Counters and gauges of the gateway and the packet trace, dumped
+   * periodically.
+   */
+  auto metrics_exporter = ae::gateway_server::MetricsExporter{
+      action_context, gateway->metrics(),
+      std::string{ae::gateway_server::kMetricsLocation}};
+  metrics_exporter.SetTraceRing(
+      gateway->trace_ring(), std::string{ae::gateway_server::kTraceLocation});
+
   /**
    * Application loop.
    * All the asynchronous actions are updated on this loop.
    * WaitUntil either waits until the next selected time or some action
    * triggers new event.
    */
+  auto run_loop_stats = ae::gateway_server::RunLoopStats{};
   while (!aether_app->IsExited()) {
-    if (true) {
-      aether_app->Exit(0);
-      continue;
+    // serial port and sockets are in the poller, their events trigger the
+    // wakeup, so sleep until the next action deadline without a timeout
+    auto const wake_time = ae::Now();
+    config_reloader.Poll();
+    if (threaded_lora_gateway != nullptr) {
+      // frames and completions of the radio thread
+      threaded_lora_gateway->Poll();
     }
-    // Wait for next event or timeout
-    auto current_time = ae::Now();
-    auto next_time = aether_app->Update(current_time);
-    aether_app->WaitUntil(
-        std::min(next_time, current_time + std::chrono::seconds{5}));
+    auto next_time = aether_app->Update(wake_time);
+    run_loop_stats.Update(wake_time, ae::Now());
+    aether_app->WaitUntil(next_time);
   }
+  run_loop_stats.Report(ae::Now());
+  metrics_exporter.Export();
 
   return aether_app->ExitCode();
 }
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/dx_smart_lr02_config.h"
+
+#include <cstdio>
+#include <utility>
+
+namespace ae {
+namespace {
+template <typename T>
+std::string EnumCommand(char const* command, T value) {
+  return command + std::to_string(static_cast<int>(value));
+}
+}  // namespace
+
+std::optional<std::vector<std::string>> DxSmartLr02Config::Diff(
+    std::optional<LoraGatewayInit> const& applied,
+    LoraGatewayInit const& desired) {
+  std::vector<std::string> commands;
+  bool supported = true;
+
+  // add command if the value is changed or applied settings are unknown
+  auto diff = [&](auto get, auto make_command) {
+    auto const& value = get(desired);
+    if (applied && (get(*applied) == value)) {
+      return;
+    }
+    std::optional<std::string> command = make_command(value);
+    if (!command) {
+      supported = false;
+      return;
+    }
+    commands.emplace_back(std::move(*command));
+  };
+
+  // serial port
+  diff([](auto const& c) { return c.serial_init.baud_rate; }, BaudRateCommand);
+  diff([](auto const& c) { return c.serial_init.parity; }, ParityCommand);
+  diff([](auto const& c) { return c.serial_init.stop_bits; }, StopBitsCommand);
+
+  // radio
+  diff([](auto const& c) { return c.psp.lora_gateway_mode; },
+       [](auto mode) { return EnumCommand("AT+MODE", mode); });
+  diff([](auto const& c) { return c.psp.lora_gateway_level; },
+       [](auto level) { return EnumCommand("AT+LEVEL", level); });
+  diff([](auto const& c) { return c.psp.lora_gateway_power; },
+       [](auto power) { return EnumCommand("AT+POWE", power); });
+  diff([](auto const& c) { return c.psp.lora_gateway_band_width; },
+       BandWidthCommand);
+  diff([](auto const& c) { return c.psp.lora_gateway_coding_rate; },
+       [](auto coding_rate) { return EnumCommand("AT+CR", coding_rate); });
+  diff([](auto const& c) { return c.psp.lora_gateway_spreading_factor; },
+       [](auto spreading_factor) {
+         return EnumCommand("AT+SF", spreading_factor);
+       });
+
+  // lora net
+  diff([](auto const& c) { return c.lora_gateway_my_adress; }, AddressCommand);
+  diff([](auto const& c) { return c.lora_gateway_channel; }, ChannelCommand);
+  diff([](auto const& c) { return c.lora_gateway_crc_check; },
+       [](auto crc_check) { return EnumCommand("AT+CRC", crc_check); });
+  diff([](auto const& c) { return c.lora_gateway_signal_inversion; },
+       [](auto signal_inversion) {
+         return EnumCommand("AT+IQ", signal_inversion);
+       });
+
+  if (!supported) {
+    return std::nullopt;
+  }
+  return commands;
+}
+
+std::optional<std::string> DxSmartLr02Config::BaudRateCommand(
+    kBaudRate baud_rate) {
+  switch (baud_rate) {
+    case kBaudRate::kBaudRate1200:
+      return "AT+BAUD1";
+    case kBaudRate::kBaudRate2400:
+      return "AT+BAUD2";
+    case kBaudRate::kBaudRate4800:
+      return "AT+BAUD3";
+    case kBaudRate::kBaudRate9600:
+      return "AT+BAUD4";
+    case kBaudRate::kBaudRate19200:
+      return "AT+BAUD5";
+    case kBaudRate::kBaudRate38400:
+      return "AT+BAUD6";
+    case kBaudRate::kBaudRate57600:
+      return "AT+BAUD7";
+    case kBaudRate::kBaudRate115200:
+      return "AT+BAUD8";
+    case kBaudRate::kBaudRate128000:
+      return "AT+BAUD9";
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<std::string> DxSmartLr02Config::ParityCommand(kParity parity) {
+  switch (parity) {
+    case kParity::kNoParity:
+      return "AT+PARI0";  // Set no parity
+    case kParity::kOddParity:
+      return "AT+PARI1";  // Set odd parity
+    case kParity::kEvenParity:
+      return "AT+PARI2";  // Set even parity
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<std::string> DxSmartLr02Config::StopBitsCommand(
+    kStopBits stop_bits) {
+  switch (stop_bits) {
+    case kStopBits::kOneStopBit:
+      return "AT+STOP1";  // 1 stop bit
+    case kStopBits::kTwoStopBit:
+      return "AT+STOP2";  // 2 stop bits
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<std::string> DxSmartLr02Config::BandWidthCommand(
+    kLoraGatewayBandWidth band_width) {
+  // AT+BW argument for each bandwidth, the module has no narrow bandwidths
+  switch (band_width) {
+    case kLoraGatewayBandWidth::kBandWidth125K:
+      return "AT+BW0";
+    case kLoraGatewayBandWidth::kBandWidth250K:
+      return "AT+BW1";
+    case kLoraGatewayBandWidth::kBandWidth500K:
+      return "AT+BW2";
+    case kLoraGatewayBandWidth::kBandWidth7K81:
+    case kLoraGatewayBandWidth::kBandWidth10K42:
+    case kLoraGatewayBandWidth::kBandWidth15K63:
+    case kLoraGatewayBandWidth::kBandWidth20K83:
+    case kLoraGatewayBandWidth::kBandWidth31K25:
+    case kLoraGatewayBandWidth::kBandWidth41K67:
+    case kLoraGatewayBandWidth::kBandWidth62K5:
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<std::string> DxSmartLr02Config::ChannelCommand(
+    std::uint8_t channel) {
+  if (channel > 0x1E) {
+    return std::nullopt;
+  }
+  char buffer[5];  // Buffer for string
+
+  // Formatting hex string
+  std::snprintf(buffer, sizeof(buffer), "%02x", channel);
+  return "AT+CHANNEL" + std::string(buffer);
+}
+
+std::string DxSmartLr02Config::AddressCommand(std::uint16_t address) {
+  auto high = static_cast<std::uint8_t>(address >> 8);  // High byte
+  auto low = static_cast<std::uint8_t>(address & 0xFF);  // Low byte
+  char buffer[7];                                        // Buffer for string
+
+  // Formatting hex string
+  std::snprintf(buffer, sizeof(buffer), "%02x,%02x", high, low);
+  return "AT+MAC" + std::string(buffer);
+}
+}  // namespace ae
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_DX_SMART_LR02_CONFIG_H_
+#define LORA_GATEWAYS_DX_SMART_LR02_CONFIG_H_
+
+#include <string>
+#include <vector>
+#include <optional>
+
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae {
+/**
+ * \brief AT commands of the DX-SMART LR02 module settings.
+ * Diff makes the commands to bring the module from applied settings to the
+ * desired ones. Only changed parameters produce a command, all of them if
+ * applied settings are unknown.
+ */
+class DxSmartLr02Config {
+ public:
+  /**
+   * \brief Commands for changed parameters in order of application.
+   * Returns nullopt if desired settings are not supported by the module.
+   */
+  static std::optional<std::vector<std::string>> Diff(
+      std::optional<LoraGatewayInit> const& applied,
+      LoraGatewayInit const& desired);
+
+  static std::optional<std::string> BaudRateCommand(kBaudRate baud_rate);
+
+ private:
+  static std::optional<std::string> ParityCommand(kParity parity);
+  static std::optional<std::string> StopBitsCommand(kStopBits stop_bits);
+  static std::optional<std::string> BandWidthCommand(
+      kLoraGatewayBandWidth band_width);
+  static std::optional<std::string> ChannelCommand(std::uint8_t channel);
+  static std::string AddressCommand(std::uint16_t address);
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_DX_SMART_LR02_CONFIG_H_
@@ -17,10 +17,13 @@
 #include "lora_gateways/dx_smart_lr02_gw.h"
 
 #include <bitset>
-#include <string_view>
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <initializer_list>
 
 #include "aether/misc/defer.h"
-#include "aether/misc/from_chars.h"
 #include "aether/actions/pipeline.h"
 #include "aether/actions/gen_action.h"
 #include "aether/mstream_buffers.h"
@@ -28,6 +31,10 @@
 
 #include "aether/lora_modules/lora_modules_tele.h"
 
+#include "lora_gateways/lora_airtime.h"
+#include "lora_gateways/lora_gateway_frame.h"
+#include "lora_gateways/dx_smart_lr02_config.h"
+
 namespace ae {
 static constexpr Duration kOneSecond = std::chrono::milliseconds{1000};
 static constexpr Duration kTwoSeconds = std::chrono::milliseconds{2000};
@@ -128,17 +135,423 @@ class DxSmartLr02UdpOpenNetwork final
   bool stop_{};
 };
 
+/**
+ * \brief Writes queued frames to the serial port.
+ * Up to kMaxInflightWrites frames are written back to back, each write
+ * completes when its bytes are transferred by the serial port.
+ * Frames are written only within the duty cycle budget, the action waits for
+ * the budget while frames are queued.
+ * The action finishes early if the operation queue asks to yield, and the
+ * rest of the frames are sent by a new transmit operation.
+ */
+class DxSmartLr02TransmitAction final
+    : public Action<DxSmartLr02TransmitAction> {
+  struct Inflight {
+    TimePoint done_at;
+    ActionPtr<DxSmartLr02LoraGateway::WriteOperation> write_operation;
+  };
+
+ public:
+  DxSmartLr02TransmitAction(ActionContext action_context,
+                            DxSmartLr02LoraGateway& lora_gw)
+      : Action{action_context}, lora_gw_{&lora_gw} {
+    lora_gw_->transmit_action_ = this;
+  }
+
+  ~DxSmartLr02TransmitAction() {
+    if (lora_gw_->transmit_action_ == this) {
+      lora_gw_->transmit_action_ = nullptr;
+    }
+  }
+
+  /**
+   * \brief New frame is queued, send it without waiting for the current
+   * delay.
+   */
+  void Wake() { Action::Trigger(); }
+
+  UpdateStatus Update() {
+    auto const now = Now();
+    while (!inflight_.empty() && (inflight_.front().done_at <= now)) {
+      inflight_.front().write_operation->Notify();
+      inflight_.pop_front();
+    }
+
+    auto& tx_queue = lora_gw_->tx_queue_;
+    // preemption point, let operations of other lanes run and continue after
+    // them with the rest of the frames
+    if (lora_gw_->operation_queue_->ShouldYield()) {
+      yield_ = true;
+    }
+    if (yield_) {
+      if (!inflight_.empty()) {
+        return UpdateStatus::Delay(inflight_.front().done_at);
+      }
+      Finish();
+      if (!tx_queue.empty()) {
+        lora_gw_->QueueTransmit();
+      }
+      return UpdateStatus::Result();
+    }
+
+    // when the next frame fits the duty cycle budget
+    auto ready_at = TimePoint::max();
+    while (inflight_.size() < DxSmartLr02LoraGateway::kMaxInflightWrites) {
+      auto it = lora_gw_->SelectTxFrame(now, ready_at);
+      if (it == std::end(tx_queue)) {
+        break;
+      }
+      auto tx_frame = std::move(*it);
+      tx_queue.erase(it);
+      lora_gw_->CountMetric(lora_gw_->tx_queue_metric_, -1);
+
+      auto const written = lora_gw_->WriteFrame(tx_frame);
+      line_free_at_ = std::max(line_free_at_, now) +
+                      lora_gw_->SerialTransferTime(written);
+      inflight_.push_back(
+          Inflight{line_free_at_, std::move(tx_frame.write_operation)});
+    }
+
+    if (inflight_.empty()) {
+      // no frame fits the duty cycle budget yet, free the queue for the
+      // other lanes and transmit again when one does
+      Finish();
+      if (!tx_queue.empty()) {
+        lora_gw_->WakeTransmitAt(ready_at);
+      }
+      return UpdateStatus::Result();
+    }
+    return UpdateStatus::Delay(std::min(ready_at, inflight_.front().done_at));
+  }
+
+ private:
+  void Finish() {
+    lora_gw_->tx_active_ = false;
+    lora_gw_->transmit_action_ = nullptr;
+  }
+
+  DxSmartLr02LoraGateway* lora_gw_;
+  std::deque<Inflight> inflight_;
+  TimePoint line_free_at_;
+  bool yield_{};
+};
+
+/**
+ * \brief Sends the configuration AT commands one by one in AT mode.
+ * Fails on the first command not confirmed by the module.
+ */
+class DxSmartLr02ConfigAction final : public Action<DxSmartLr02ConfigAction> {
+ public:
+  DxSmartLr02ConfigAction(ActionContext action_context,
+                          DxSmartLr02LoraGateway& lora_gw,
+                          std::vector<std::string> commands)
+      : Action{action_context},
+        lora_gw_{&lora_gw},
+        commands_{std::move(commands)} {}
+
+  UpdateStatus Update() {
+    if (error_) {
+      return UpdateStatus::Error();
+    }
+    if (stop_) {
+      return UpdateStatus::Stop();
+    }
+    if (!request_active_) {
+      if (next_command_ == commands_.size()) {
+        return UpdateStatus::Result();
+      }
+      SendNext();
+    }
+    return {};
+  }
+
+ private:
+  void SendNext() {
+    request_active_ = true;
+    auto request = lora_gw_->at_comm_support_->MakeRequest(
+        commands_[next_command_], kWaitOk);
+    request_sub_ = request->StatusEvent().Subscribe(ActionHandler{
+        OnResult{[this]() {
+          ++next_command_;
+          request_active_ = false;
+          Action::Trigger();
+        }},
+        OnError{[this]() {
+          AE_TELED_ERROR("Command {} failed", commands_[next_command_]);
+          error_ = true;
+          Action::Trigger();
+        }},
+        OnStop{[this]() {
+          stop_ = true;
+          Action::Trigger();
+        }}});
+  }
+
+  DxSmartLr02LoraGateway* lora_gw_;
+  std::vector<std::string> commands_;
+  std::size_t next_command_{};
+  Subscription request_sub_;
+  bool request_active_{};
+  bool error_{};
+  bool stop_{};
+};
+
+/**
+ * \brief Finds the module baud rate and switches both sides to the fastest
+ * rate passing the probe.
+ * The module rate is detected by AT mode entry and "AT" request on each rate,
+ * starting with the configured one. Then faster rates are tried from the
+ * fastest, each one is probed with several "AT" requests. A failed probe
+ * detects the module rate again and goes on with slower rates.
+ * The action ends with the module in AT mode. If the module rate is not
+ * detected, the host port is returned to the configured rate.
+ */
+class DxSmartLr02BaudRateAction final
+    : public Action<DxSmartLr02BaudRateAction> {
+  enum class Step : std::uint8_t {
+    kDetect,
+    kDetectRetry,
+    kEscalate,
+    kSwitch,
+    kProbe,
+    kDone,
+    kFailed,
+  };
+
+  static constexpr std::size_t kProbeCount = 3;
+  // from the fastest
+  static constexpr std::array kRates{
+      kBaudRate::kBaudRate128000, kBaudRate::kBaudRate115200,
+      kBaudRate::kBaudRate57600,  kBaudRate::kBaudRate38400,
+      kBaudRate::kBaudRate19200,  kBaudRate::kBaudRate9600,
+      kBaudRate::kBaudRate4800,   kBaudRate::kBaudRate2400,
+      kBaudRate::kBaudRate1200,
+  };
+
+ public:
+  DxSmartLr02BaudRateAction(ActionContext action_context,
+                            DxSmartLr02LoraGateway& lora_gw)
+      : Action{action_context},
+        lora_gw_{&lora_gw},
+        configured_{lora_gw.lora_gateway_init_.serial_init.baud_rate},
+        current_{configured_} {
+    // serial data are AT responses from now on
+    lora_gw_->at_mode_ = true;
+    lora_gw_->frame_decoder_.Reset();
+    // module starts in transparent mode
+    DetectFrom({current_}, false);
+  }
+
+  UpdateStatus Update() {
+    while (!request_active_) {
+      switch (step_) {
+        case Step::kDetect:
+          Detect();
+          break;
+        case Step::kDetectRetry:
+          DetectRetry();
+          break;
+        case Step::kEscalate:
+          Escalate();
+          break;
+        case Step::kSwitch:
+          Switch();
+          break;
+        case Step::kProbe:
+          Probe();
+          break;
+        case Step::kDone:
+          lora_gw_->lora_gateway_init_.serial_init.baud_rate = current_;
+          AE_TELED_INFO("Serial baud rate {}", static_cast<int>(current_));
+          return UpdateStatus::Result();
+        case Step::kFailed:
+          AE_TELED_ERROR("Module baud rate is not detected");
+          // the host port is left on the last rate tried
+          lora_gw_->SetHostBaudRate(configured_);
+          return UpdateStatus::Error();
+      }
+    }
+    return {};
+  }
+
+ private:
+  void DetectFrom(std::initializer_list<kBaudRate> preferred, bool at_mode) {
+    detect_order_.assign(preferred);
+    for (auto rate : kRates) {
+      if (std::find(std::begin(detect_order_), std::end(detect_order_),
+                    rate) == std::end(detect_order_)) {
+        detect_order_.push_back(rate);
+      }
+    }
+    detect_index_ = 0;
+    at_mode_ = at_mode;
+    retried_ = false;
+    step_ = Step::kDetect;
+    last_ok_.reset();
+  }
+
+  // "+++" toggles AT mode, so try it only if the module is expected to be in
+  // transparent mode and "AT" otherwise
+  void Detect() {
+    lora_gw_->SetHostBaudRate(detect_order_[detect_index_]);
+    step_ = Step::kDetectRetry;
+    RequestAtMode(at_mode_);
+  }
+
+  void DetectRetry() {
+    if (*last_ok_) {
+      Detected();
+      return;
+    }
+    if (!retried_) {
+      retried_ = true;
+      lora_gw_->CountMetric(lora_gw_->at_retries_metric_, 1);
+      RequestAtMode(!at_mode_);
+      return;
+    }
+    retried_ = false;
+    if (++detect_index_ == detect_order_.size()) {
+      step_ = Step::kFailed;
+      return;
+    }
+    lora_gw_->CountMetric(lora_gw_->at_retries_metric_, 1);
+    step_ = Step::kDetect;
+  }
+
+  void Detected() {
+    retried_ = false;
+    current_ = detect_order_[detect_index_];
+    step_ = Step::kEscalate;
+  }
+
+  void Escalate() {
+    // rates faster than the current one and not tried yet, any other rate if
+    // the current one failed the probe
+    auto const limit =
+        (unreliable_ == current_) ? kRates.size() : Index(current_);
+    if ((escalate_index_ < limit) && (kRates[escalate_index_] == current_)) {
+      ++escalate_index_;
+    }
+    if (escalate_index_ >= limit) {
+      step_ = Step::kDone;
+      return;
+    }
+    target_ = kRates[escalate_index_++];
+    step_ = Step::kSwitch;
+    Request(*DxSmartLr02Config::BaudRateCommand(target_), kWaitOk);
+  }
+
+  void Switch() {
+    if (!*last_ok_) {
+      // the module refused the rate and keeps the current one
+      step_ = Step::kEscalate;
+      return;
+    }
+    lora_gw_->SetHostBaudRate(target_);
+    probes_left_ = kProbeCount;
+    step_ = Step::kProbe;
+    Request("AT", kWaitOk);
+  }
+
+  void Probe() {
+    if (!*last_ok_) {
+      AE_TELED_WARNING("Baud rate {} is not reliable",
+                       static_cast<int>(target_));
+      unreliable_ = target_;
+      lora_gw_->CountMetric(lora_gw_->at_retries_metric_, 1);
+      // the module is most likely on the new rate and still in AT mode
+      DetectFrom({target_, current_}, true);
+      return;
+    }
+    if (--probes_left_ == 0) {
+      // the fastest reliable rate
+      current_ = target_;
+      step_ = Step::kDone;
+      return;
+    }
+    Request("AT", kWaitOk);
+  }
+
+  void RequestAtMode(bool at_mode) {
+    if (at_mode) {
+      Request("AT", kWaitOk);
+    } else {
+      Request("+++", kWaitEntryAt);
+    }
+  }
+
+  void Request(std::string const& command, AtRequest::Wait const& wait) {
+    request_active_ = true;
+    last_ok_.reset();
+    auto request = lora_gw_->at_comm_support_->MakeRequest(command, wait);
+    request_sub_ = request->StatusEvent().Subscribe(
+        ActionHandler{OnResult{[this]() { Done(true); }},
+                      OnError{[this]() { Done(false); }},
+                      OnStop{[this]() { Done(false); }}});
+  }
+
+  void Done(bool ok) {
+    // continue in Update, the serial port may be recreated there
+    last_ok_ = ok;
+    request_active_ = false;
+    Action::Trigger();
+  }
+
+  static std::size_t Index(kBaudRate rate) {
+    return static_cast<std::size_t>(
+        std::find(std::begin(kRates), std::end(kRates), rate) -
+        std::begin(kRates));
+  }
+
+  DxSmartLr02LoraGateway* lora_gw_;
+  kBaudRate configured_;
+  kBaudRate current_;
+  kBaudRate target_{};
+  std::optional<kBaudRate> unreliable_;
+  Step step_{Step::kDetect};
+  std::vector<kBaudRate> detect_order_;
+  std::size_t detect_index_{};
+  std::size_t escalate_index_{};
+  std::size_t probes_left_{};
+  std::optional<bool> last_ok_;
+  Subscription request_sub_;
+  bool request_active_{};
+  // the module is expected to be in AT mode
+  bool at_mode_{};
+  bool retried_{};
+};
+
 DxSmartLr02LoraGateway::DxSmartLr02LoraGateway(
     ActionContext action_context, IPoller::ptr const& poller,
     LoraGatewayInit lora_gateway_init)
+    : DxSmartLr02LoraGateway{
+          action_context,
+          [action_context, poller](SerialInit const& serial_init) {
+            return SerialPortFactory::CreatePort(action_context, poller,
+                                                 serial_init);
+          },
+          std::move(lora_gateway_init)} {}
+
+DxSmartLr02LoraGateway::DxSmartLr02LoraGateway(
+    ActionContext action_context, SerialPortCreator serial_port_creator,
+    LoraGatewayInit lora_gateway_init)
     : action_context_{action_context},
+      serial_port_creator_{std::move(serial_port_creator)},
       lora_gateway_init_{std::move(lora_gateway_init)},
-      serial_{SerialPortFactory::CreatePort(action_context_, poller,
-                                            lora_gateway_init_.serial_init)},
-      at_comm_support_{action_context_, *serial_},
+      serial_{serial_port_creator_(lora_gateway_init_.serial_init)},
+      at_comm_support_{std::in_place, action_context_, *serial_},
+      frame_decoder_{kLoraGatewayMTU},
       operation_queue_{action_context_},
+      duty_cycle_{lora_gateway_init_.lora_gateway_freq_range},
+      tx_wake_action_{action_context_,
+                      [this](auto now) { return WakeTransmit(now); }},
       initiated_{false},
       started_{false} {
+  // receive is driven by the serial port read events
+  serial_read_sub_ = serial_->read_event().Subscribe(
+      [this](auto const& data) { OnSerialData(data); });
+  packet_sub_ = frame_decoder_.packet_event().Subscribe(
+      [this](auto const& packet) { OnPacket(packet); });
   Init();
 }
 
@@ -149,7 +562,8 @@ DxSmartLr02LoraGateway::Start() {
   auto lora_gateway_operation =
       ActionPtr<LoraGatewayOperation>{action_context_};
   operation_queue_->Push(
-      Stage([this, lora_gateway_operation]() -> ActionPtr<IPipeline> {
+      LoraOperationQueue::Lane::kControl,
+      [this, lora_gateway_operation]() -> ActionPtr<IPipeline> {
         // if already started, notify of success and return
         if (started_) {
           return MakeActionPtr<Pipeline>(
@@ -169,7 +583,6 @@ DxSmartLr02LoraGateway::Start() {
                                     // save it's started
                                     Stage<GenAction>(action_context_, [this]() {
                                       started_ = true;
-                                      SetupPoll();
                                       return UpdateStatus::Result();
                                     }));
 
@@ -185,7 +598,7 @@ DxSmartLr02LoraGateway::Start() {
                           }}});
 
         return pipeline;
-      }));
+      });
 
   return lora_gateway_operation;
 }
@@ -195,26 +608,32 @@ DxSmartLr02LoraGateway::Stop() {
   auto lora_gateway_operation =
       ActionPtr<LoraGatewayOperation>{action_context_};
 
-  operation_queue_->Push(Stage([this, lora_gateway_operation]() {
-    auto pipeline = MakeActionPtr<Pipeline>(
-        action_context_,
-        // Enter AT command mode
-        Stage([this]() { return EnterAtMode(); }), Stage([this]() {
-          return at_comm_support_.MakeRequest("AT+RESET", kWaitOk);
-        }),
-        // Exit AT command mode
-        Stage([this]() { return ExitAtMode(); }));
+  operation_queue_->Push(
+      LoraOperationQueue::Lane::kControl, [this, lora_gateway_operation]() {
+        auto pipeline = MakeActionPtr<Pipeline>(
+            action_context_,
+            // Enter AT command mode
+            Stage([this]() { return EnterAtMode(); }), Stage([this]() {
+              return at_comm_support_->MakeRequest("AT+RESET", kWaitOk);
+            }),
+            // Exit AT command mode
+            Stage([this]() { return ExitAtMode(); }));
 
-    pipeline->StatusEvent().Subscribe(ActionHandler{
-        OnResult{
-            [lora_gateway_operation]() { lora_gateway_operation->Notify(); }},
-        OnError{
-            [lora_gateway_operation]() { lora_gateway_operation->Failed(); }},
-        OnStop{
-            [lora_gateway_operation]() { lora_gateway_operation->Stop(); }}});
+        pipeline->StatusEvent().Subscribe(ActionHandler{
+            OnResult{[lora_gateway_operation]() {
+              lora_gateway_operation->Notify();
+            }},
+            OnError{[this, lora_gateway_operation]() {
+              RestoreDataMode();
+              lora_gateway_operation->Failed();
+            }},
+            OnStop{[this, lora_gateway_operation]() {
+              RestoreDataMode();
+              lora_gateway_operation->Stop();
+            }}});
 
-    return pipeline;
-  }));
+        return pipeline;
+      });
 
   return lora_gateway_operation;
 }
@@ -226,16 +645,18 @@ DxSmartLr02LoraGateway::OpenNetwork(ae::Protocol protocol,
   auto open_network_operation =
       ActionPtr<OpenNetworkOperation>{action_context_};
 
-  operation_queue_->Push(Stage([this, open_network_operation, protocol,
-                                host{host}, port]() -> ActionPtr<IPipeline> {
-    if (protocol == Protocol::kTcp) {
-      return OpenTcpConnection(open_network_operation, host, port);
-    }
-    if (protocol == Protocol::kUdp) {
-      return OpenUdpConnection(open_network_operation, host, port);
-    }
-    return {};
-  }));
+  operation_queue_->Push(
+      LoraOperationQueue::Lane::kControl,
+      [this, open_network_operation, protocol, host{host},
+       port]() -> ActionPtr<IPipeline> {
+        if (protocol == Protocol::kTcp) {
+          return OpenTcpConnection(open_network_operation, host, port);
+        }
+        if (protocol == Protocol::kUdp) {
+          return OpenUdpConnection(open_network_operation, host, port);
+        }
+        return {};
+      });
 
   return open_network_operation;
 }
@@ -257,261 +678,332 @@ DxSmartLr02LoraGateway::CloseNetwork(
 
 ActionPtr<DxSmartLr02LoraGateway::WriteOperation>
 DxSmartLr02LoraGateway::WritePacket(
-    ae::ConnectionLoraGatewayIndex /*connect_index*/,
-    ae::DataBuffer const& /*data*/) {
-  return {};
-}
-// void DxSmartLr02LoraModule::WritePacket(
-//    ae::ConnectionLoraIndex connect_index,
-//                                        ae::DataBuffer const& data) {
-//  LoraPacket lora_packet{};
-//
-//  auto const& connection =
-//      connect_vec_.at(static_cast<std::size_t>(connect_index));
-//
-//  lora_packet.connection = connection;
-//  lora_packet.length = data.size();
-//  lora_packet.data = data;
-//  lora_packet.crc = 0;  // Not implemented yet
-//
-//  auto packet_data = std::vector<std::uint8_t>{};
-//  VectorWriter<PacketSize> vw{packet_data};
-//  auto os = omstream{vw};
-//  // copy data with size
-//  os << lora_packet;
-//
-//  serial_->Write(packet_data);
-//};
+    ae::ConnectionLoraGatewayIndex connect_index, ae::DataBuffer const& data) {
+  auto write_operation = ActionPtr<WriteOperation>{action_context_};
+  if (data.size() > kLoraGatewayMTU) {
+    AE_TELED_ERROR("Packet size {} exceeds MTU {}", data.size(),
+                   kLoraGatewayMTU);
+    write_operation->Failed();
+    return write_operation;
+  }
 
-// DataBuffer DxSmartLr02LoraModule::ReadPacket(
-//     ae::ConnectionLoraIndex /* connect_index*/, ae::Duration /* timeout*/) {
-//   LoraPacket lora_packet{};
-//   DataBuffer data{};
-//
-//   auto response = serial_->Read();
-//   std::vector<std::uint8_t> packet_data(response->begin(), response->end());
-//   VectorReader<PacketSize> vr(packet_data);
-//   auto is = imstream{vr};
-//   // copy data with size
-//   is >> lora_packet;
-//
-//   data = lora_packet.data;
-//
-//   return data;
-// };
+  LoraGatewayPacket lora_packet{};
+  lora_packet.connection.connect_index = connect_index;
+  lora_packet.length = data.size();
+  lora_packet.data = data;
+
+  auto frame = LoraGatewayFrame::Encode(lora_packet);
+  auto const air_size = frame.size();
+  // the fixed-point prefix is added on transmission, when the mode the frame
+  // is sent in is known
+  auto const target = FixedPointTarget(connect_index);
+  auto const channel =
+      target ? target->channel : applied_init().lora_gateway_channel;
+
+  if (duty_cycle_.ReadyAt(channel, FrameAirtime(air_size), Now()) ==
+      TimePoint::max()) {
+    AE_TELED_ERROR("Packet size {} exceeds duty cycle budget", data.size());
+    write_operation->Failed();
+    return write_operation;
+  }
 
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::ReadPacket(
-    ConnectionLoraGatewayIndex /* connection */) {
-  return {};
-}
+  tx_queue_.push_back(TxFrame{connect_index, channel, air_size,
+                              std::move(frame), write_operation});
+  CountMetric(tx_queue_metric_, 1);
 
-DxSmartLr02LoraGateway::DataEvent::Subscriber
-DxSmartLr02LoraGateway::data_event() {
-  return EventSubscriber{data_event_};
+  // one transmit stage in the queue serves all the frames written meanwhile
+  if (tx_active_) {
+    if (transmit_action_ != nullptr) {
+      transmit_action_->Wake();
+    }
+  } else {
+    QueueTransmit();
+  }
+  return write_operation;
 }
 
-ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
-DxSmartLr02LoraGateway::SetPowerSaveParam(
-    LoraGatewayPowerSaveParam const& psp) {
-  auto lora_gateway_operation =
-      ActionPtr<LoraGatewayOperation>{action_context_};
-
-  operation_queue_->Push(Stage([this, lora_gateway_operation, psp{psp}]() {
-    auto pipeline = MakeActionPtr<Pipeline>(
-        action_context_,
-        // Enter AT command mode
-        Stage([this]() { return EnterAtMode(); }),
-        // Configure Lora Gateway Mode
-        Stage([this, psp]() {
-          return SetLoraGatewayMode(psp.lora_gateway_mode);
-        }),
-        // Configure Lora Gateway Level
-        Stage([this, psp]() {
-          return SetLoraGatewayLevel(psp.lora_gateway_level);
-        }),
-        // Configure Lora Gateway Power
-        Stage([this, psp]() {
-          return SetLoraGatewayPower(psp.lora_gateway_power);
-        }),
-        // Configure Lora Gateway BandWidth
-        Stage([this, psp]() {
-          return SetLoraGatewayBandWidth(psp.lora_gateway_band_width);
-        }),
-        // Configure Lora Gateway Coding Rate
-        Stage([this, psp]() {
-          return SetLoraGatewayCodingRate(psp.lora_gateway_coding_rate);
-        }),
-        // Configure Lora Gateway Spreading Factor
-        Stage([this, psp]() {
-          return SetLoraGatewaySpreadingFactor(
-              psp.lora_gateway_spreading_factor);
-        }),
-        // Exit AT command mode
-        Stage([this]() { return ExitAtMode(); }));
-    pipeline->StatusEvent().Subscribe(ActionHandler{
-        OnResult{
-            [lora_gateway_operation]() { lora_gateway_operation->Notify(); }},
-        OnError{
-            [lora_gateway_operation]() { lora_gateway_operation->Failed(); }},
-        OnStop{
-            [lora_gateway_operation]() { lora_gateway_operation->Stop(); }}});
+LoraOperationQueue::LaneStats const& DxSmartLr02LoraGateway::queue_stats(
+    LoraOperationQueue::Lane lane) const {
+  return operation_queue_->stats(lane);
+}
 
-    return pipeline;
-  }));
+void DxSmartLr02LoraGateway::QueueTransmit() {
+  tx_active_ = true;
+  operation_queue_->Push(LoraOperationQueue::Lane::kData, [this]() {
+    return ActionPtr<DxSmartLr02TransmitAction>{action_context_, *this};
+  });
+}
 
-  return lora_gateway_operation;
+void DxSmartLr02LoraGateway::WakeTransmitAt(TimePoint at) {
+  tx_ready_at_ = at;
+  tx_wake_action_->Reschedule();
 }
 
-ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
-DxSmartLr02LoraGateway::PowerOff() {
-  return {};
+TimePoint DxSmartLr02LoraGateway::WakeTransmit(TimePoint now) {
+  if (tx_active_ || tx_queue_.empty()) {
+    return TimePoint::max();
+  }
+  if (tx_ready_at_ > now) {
+    return tx_ready_at_;
+  }
+  QueueTransmit();
+  return TimePoint::max();
 }
 
-ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
-DxSmartLr02LoraGateway::SetLoraGatewayAddress(std::uint16_t const& address) {
-  auto lora_gateway_operation =
-      ActionPtr<LoraGatewayOperation>{action_context_};
+Duration DxSmartLr02LoraGateway::SerialTransferTime(std::size_t size) const {
+  std::uint32_t baud_rate{9600};
+  switch (lora_gateway_init_.serial_init.baud_rate) {
+    case kBaudRate::kBaudRate1200:
+      baud_rate = 1200;
+      break;
+    case kBaudRate::kBaudRate2400:
+      baud_rate = 2400;
+      break;
+    case kBaudRate::kBaudRate4800:
+      baud_rate = 4800;
+      break;
+    case kBaudRate::kBaudRate19200:
+      baud_rate = 19200;
+      break;
+    case kBaudRate::kBaudRate38400:
+      baud_rate = 38400;
+      break;
+    case kBaudRate::kBaudRate57600:
+      baud_rate = 57600;
+      break;
+    case kBaudRate::kBaudRate115200:
+      baud_rate = 115200;
+      break;
+    case kBaudRate::kBaudRate128000:
+      baud_rate = 128000;
+      break;
+    default:
+      break;
+  }
+  // start bit, 8 data bits and stop bit for each byte
+  auto const bits = static_cast<std::uint64_t>(size) * 10;
+  return std::chrono::duration_cast<Duration>(
+      std::chrono::microseconds{(bits * 1000000) / baud_rate});
+}
 
-  operation_queue_->Push(Stage([this, lora_gateway_operation, address]() {
-    auto pipeline = MakeActionPtr<Pipeline>(
-        action_context_,
-        // Enter AT command mode
-        Stage([this]() { return EnterAtMode(); }), Stage([this, address]() {
-          return at_comm_support_.MakeRequest(
-              "AT+MAC" + AdressToString(address), kWaitOk);
-        }),
-        // Exit AT command mode
-        Stage([this]() { return ExitAtMode(); }));
+void DxSmartLr02LoraGateway::SetHostBaudRate(kBaudRate baud_rate) {
+  auto& serial_init = lora_gateway_init_.serial_init;
+  if ((serial_init.baud_rate == baud_rate) && serial_) {
+    return;
+  }
+  AE_TELED_DEBUG("Set host baud rate {}", static_cast<int>(baud_rate));
+  serial_init.baud_rate = baud_rate;
+
+  // serial port is reopened with the new rate
+  serial_read_sub_.Reset();
+  at_comm_support_.reset();
+  serial_.reset();
+  serial_ = serial_port_creator_(serial_init);
+  at_comm_support_.emplace(action_context_, *serial_);
+  serial_read_sub_ = serial_->read_event().Subscribe(
+      [this](auto const& data) { OnSerialData(data); });
+}
 
-    pipeline->StatusEvent().Subscribe(ActionHandler{
-        OnResult{
-            [lora_gateway_operation]() { lora_gateway_operation->Notify(); }},
-        OnError{
-            [lora_gateway_operation]() { lora_gateway_operation->Failed(); }},
-        OnStop{
-            [lora_gateway_operation]() { lora_gateway_operation->Stop(); }}});
+Duration DxSmartLr02LoraGateway::FrameAirtime(std::size_t air_size) const {
+  // data may be sent before a queued configuration change is applied
+  return LoraAirtime::Calculate(applied_init().psp, air_size);
+}
 
-    return pipeline;
-  }));
+LoraGatewayInit const& DxSmartLr02LoraGateway::applied_init() const {
+  return applied_config_ ? *applied_config_ : lora_gateway_init_;
+}
 
-  return lora_gateway_operation;
+std::optional<LoraDeviceAddress> DxSmartLr02LoraGateway::FixedPointTarget(
+    ConnectionLoraGatewayIndex connect_index) const {
+  auto const& init = applied_init();
+  if (init.psp.lora_gateway_mode != kLoraGatewayMode::kFixedPointTransmission) {
+    return std::nullopt;
+  }
+  auto target = device_registry_.Find(
+      static_cast<LoraDeviceRegistry::DeviceId>(connect_index));
+  if (!target) {
+    AE_TELED_DEBUG("Device {} is not bound, broadcast",
+                   static_cast<int>(connect_index));
+    return LoraDeviceAddress{LoraDeviceAddress::kBroadcast,
+                             init.lora_gateway_channel};
+  }
+  return target;
 }
 
-ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
-DxSmartLr02LoraGateway::SetLoraGatewayChannel(std::uint8_t const& channel) {
-  if (channel > 0x1E) {
-    return {};
+std::size_t DxSmartLr02LoraGateway::WriteFrame(TxFrame const& tx_frame) {
+  auto const target = FixedPointTarget(tx_frame.connection);
+  if (!target) {
+    serial_->Write(tx_frame.frame);
+    return tx_frame.frame.size();
   }
+  // the module takes target address and channel from the first bytes
+  auto frame = DataBuffer{};
+  frame.reserve(tx_frame.frame.size() + 3);
+  frame.push_back(static_cast<std::uint8_t>(target->address >> 8));
+  frame.push_back(static_cast<std::uint8_t>(target->address & 0xFF));
+  frame.push_back(target->channel);
+  frame.insert(std::end(frame), std::begin(tx_frame.frame),
+               std::end(tx_frame.frame));
+  serial_->Write(frame);
+  return frame.size();
+}
 
-  auto lora_gateway_operation =
-      ActionPtr<LoraGatewayOperation>{action_context_};
+void DxSmartLr02LoraGateway::SetMetrics(gw::MetricsRegistry& metrics) {
+  auto const labels =
+      Format("port=\"{}\"", lora_gateway_init_.serial_init.port_name);
+  metrics_ = &metrics;
+  tx_queue_metric_ = metrics_->Register(
+      gw::MetricsRegistry::Type::kGauge, "lr02_tx_queue_depth",
+      "Frames waiting for transmission", labels);
+  at_retries_metric_ = metrics_->Register(
+      gw::MetricsRegistry::Type::kCounter, "lr02_at_retries_total",
+      "AT requests repeated after no answer", labels);
+  CountMetric(tx_queue_metric_, static_cast<std::int64_t>(tx_queue_.size()));
+}
 
-  operation_queue_->Push(Stage([this, lora_gateway_operation, channel]() {
-    auto pipeline = MakeActionPtr<Pipeline>(
-        action_context_,
-        // Enter AT command mode
-        Stage([this]() { return EnterAtMode(); }), Stage([this, channel]() {
-          return at_comm_support_.MakeRequest(
-              "AT+CHANNEL" + ChannelToString(channel), kWaitOk);
-        }),
-        // Exit AT command mode
-        Stage([this]() { return ExitAtMode(); }));
+void DxSmartLr02LoraGateway::CountMetric(gw::MetricsRegistry::MetricId metric,
+                                         std::int64_t value) {
+  if (metrics_ != nullptr) {
+    metrics_->Add(metric, value);
+  }
+}
 
-    pipeline->StatusEvent().Subscribe(ActionHandler{
-        OnResult{
-            [lora_gateway_operation]() { lora_gateway_operation->Notify(); }},
-        OnError{
-            [lora_gateway_operation]() { lora_gateway_operation->Failed(); }},
-        OnStop{
-            [lora_gateway_operation]() { lora_gateway_operation->Stop(); }}});
+std::deque<DxSmartLr02LoraGateway::TxFrame>::iterator
+DxSmartLr02LoraGateway::SelectTxFrame(TimePoint now, TimePoint& ready_at) {
+  // frames of a connection keep their order, the frame not fitting the budget
+  // blocks only its own connection and the rest of the budget is spent on
+  // frames of other connections
+  std::set<ConnectionLoraGatewayIndex> blocked;
+  for (auto it = std::begin(tx_queue_); it != std::end(tx_queue_);) {
+    if (blocked.count(it->connection) != 0) {
+      ++it;
+      continue;
+    }
+    auto const airtime = FrameAirtime(it->air_size);
+    auto const frame_ready_at =
+        duty_cycle_.ReadyAt(it->channel, airtime, now);
+    if (frame_ready_at == TimePoint::max()) {
+      // radio settings changed since the frame was queued
+      AE_TELED_ERROR("Frame size {} exceeds duty cycle budget",
+                     it->frame.size());
+      it->write_operation->Failed();
+      it = tx_queue_.erase(it);
+      CountMetric(tx_queue_metric_, -1);
+      continue;
+    }
+    if (frame_ready_at <= now) {
+      duty_cycle_.Consume(it->channel, airtime, now);
+      return it;
+    }
+    ready_at = std::min(ready_at, frame_ready_at);
+    blocked.insert(it->connection);
+    ++it;
+  }
+  return std::end(tx_queue_);
+}
 
-    return pipeline;
-  }));
+void DxSmartLr02LoraGateway::BindDevice(std::uint8_t device_id,
+                                        LoraDeviceAddress const& address) {
+  device_registry_.Bind(device_id, address);
+}
 
-  return lora_gateway_operation;
+DxSmartLr02LoraGateway::DataEvent::Subscriber
+DxSmartLr02LoraGateway::data_event() {
+  return EventSubscriber{data_event_};
 }
 
 ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
-DxSmartLr02LoraGateway::SetLoraGatewayCRCCheck(
-    kLoraGatewayCRCCheck const& crc_check) {
+DxSmartLr02LoraGateway::Configure(LoraGatewayInit const& lora_gateway_init) {
   auto lora_gateway_operation =
       ActionPtr<LoraGatewayOperation>{action_context_};
 
-  operation_queue_->Push(Stage([this, lora_gateway_operation, crc_check]() {
-    auto pipeline = MakeActionPtr<Pipeline>(
-        action_context_,
-        // Enter AT command mode
-        Stage([this]() { return EnterAtMode(); }), Stage([this, crc_check]() {
-          return at_comm_support_.MakeRequest(
-              "AT+CRC" + std::to_string(static_cast<int>(crc_check)), kWaitOk);
-        }),
-        // Exit AT command mode
-        Stage([this]() { return ExitAtMode(); }));
+  // the diff is made when the operation runs, so several changes requested
+  // meanwhile are applied by the first of them
+  // serial port settings are negotiated on init and kept as is
+  auto serial_init = lora_gateway_init_.serial_init;
+  lora_gateway_init_ = lora_gateway_init;
+  lora_gateway_init_.serial_init = std::move(serial_init);
+  operation_queue_->Push(
+      LoraOperationQueue::Lane::kMaintenance,
+      [this, lora_gateway_operation]() {
+        auto pipeline = ApplyConfig();
 
-    pipeline->StatusEvent().Subscribe(ActionHandler{
-        OnResult{
-            [lora_gateway_operation]() { lora_gateway_operation->Notify(); }},
-        OnError{
-            [lora_gateway_operation]() { lora_gateway_operation->Failed(); }},
-        OnStop{
-            [lora_gateway_operation]() { lora_gateway_operation->Stop(); }}});
+        pipeline->StatusEvent().Subscribe(ActionHandler{
+            OnResult{[lora_gateway_operation]() {
+              lora_gateway_operation->Notify();
+            }},
+            OnError{[this, lora_gateway_operation]() {
+              RestoreDataMode();
+              lora_gateway_operation->Failed();
+            }},
+            OnStop{[this, lora_gateway_operation]() {
+              RestoreDataMode();
+              lora_gateway_operation->Stop();
+            }}});
 
-    return pipeline;
-  }));
+        return pipeline;
+      });
 
   return lora_gateway_operation;
 }
 
 ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
-DxSmartLr02LoraGateway::SetLoraGatewayIQSignalInversion(
-    kLoraGatewayIQSignalInversion const& signal_inversion) {
-  auto lora_gateway_operation =
-      ActionPtr<LoraGatewayOperation>{action_context_};
+DxSmartLr02LoraGateway::SetPowerSaveParam(
+    LoraGatewayPowerSaveParam const& psp) {
+  auto lora_gateway_init = lora_gateway_init_;
+  lora_gateway_init.psp = psp;
+  return Configure(lora_gateway_init);
+}
 
-  operation_queue_->Push(
-      Stage([this, lora_gateway_operation, signal_inversion]() {
-        auto pipeline = MakeActionPtr<Pipeline>(
-            action_context_,
-            // Enter AT command mode
-            Stage([this]() { return EnterAtMode(); }),
-            Stage([this, signal_inversion]() {
-              return at_comm_support_.MakeRequest(
-                  "AT+IQ" + std::to_string(static_cast<int>(signal_inversion)),
-                  kWaitOk);
-            }),
-            // Exit AT command mode
-            Stage([this]() { return ExitAtMode(); }));
+ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
+DxSmartLr02LoraGateway::PowerOff() {
+  return {};
+}
 
-        pipeline->StatusEvent().Subscribe(
-            ActionHandler{OnResult{[lora_gateway_operation]() {
-                            lora_gateway_operation->Notify();
-                          }},
-                          OnError{[lora_gateway_operation]() {
-                            lora_gateway_operation->Failed();
-                          }},
-                          OnStop{[lora_gateway_operation]() {
-                            lora_gateway_operation->Stop();
-                          }}});
+ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
+DxSmartLr02LoraGateway::SetLoraGatewayAddress(std::uint16_t const& address) {
+  auto lora_gateway_init = lora_gateway_init_;
+  lora_gateway_init.lora_gateway_my_adress = address;
+  return Configure(lora_gateway_init);
+}
 
-        return pipeline;
-      }));
+ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
+DxSmartLr02LoraGateway::SetLoraGatewayChannel(std::uint8_t const& channel) {
+  auto lora_gateway_init = lora_gateway_init_;
+  lora_gateway_init.lora_gateway_channel = channel;
+  return Configure(lora_gateway_init);
+}
 
-  return lora_gateway_operation;
+ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
+DxSmartLr02LoraGateway::SetLoraGatewayCRCCheck(
+    kLoraGatewayCRCCheck const& crc_check) {
+  auto lora_gateway_init = lora_gateway_init_;
+  lora_gateway_init.lora_gateway_crc_check = crc_check;
+  return Configure(lora_gateway_init);
+}
+
+ActionPtr<DxSmartLr02LoraGateway::LoraGatewayOperation>
+DxSmartLr02LoraGateway::SetLoraGatewayIQSignalInversion(
+    kLoraGatewayIQSignalInversion const& signal_inversion) {
+  auto lora_gateway_init = lora_gateway_init_;
+  lora_gateway_init.lora_gateway_signal_inversion = signal_inversion;
+  return Configure(lora_gateway_init);
 }
 
 // =============================private members=========================== //
 void DxSmartLr02LoraGateway::Init() {
-  operation_queue_->Push(Stage([this]() {
+  // data is written only after the module is in transparent mode
+  operation_queue_->Hold(LoraOperationQueue::Lane::kData);
+  operation_queue_->Push(LoraOperationQueue::Lane::kControl, [this]() {
     auto init_pipeline = MakeActionPtr<Pipeline>(
         action_context_,
-        // Enter AT command mode
-        Stage([this]() { return EnterAtMode(); }),
-        Stage([this]() { return at_comm_support_.MakeRequest("AT", kWaitOk); }),
+        // Find the module baud rate and switch to the fastest one, the
+        // module is left in AT command mode
         Stage([this]() {
-          return SetupSerialPort(lora_gateway_init_.serial_init);
+          return ActionPtr<DxSmartLr02BaudRateAction>{action_context_, *this};
         }),
-        Stage([this]() { return SetPowerSaveParam(lora_gateway_init_.psp); }),
-        Stage([this]() { return SetupLoraNet(lora_gateway_init_); }),
+        // Apply all the settings in the same AT session
+        Stage([this]() { return ApplyConfig(); }),
         // Exit AT command mode
         Stage([this]() { return ExitAtMode(); }),
         Stage<GenAction>(action_context_, [this]() {
@@ -520,13 +1012,55 @@ void DxSmartLr02LoraGateway::Init() {
         }));
 
     init_pipeline->StatusEvent().Subscribe(ActionHandler{
-        OnResult{
-            []() { AE_TELED_INFO("DxSmartLr02LoraGateway init success"); }},
-        OnError{[]() { AE_TELED_ERROR("DxSmartLr02LoraGateway init failed"); }},
+        OnResult{[this]() {
+          AE_TELED_INFO("DxSmartLr02LoraGateway init success");
+          operation_queue_->Release(LoraOperationQueue::Lane::kData);
+        }},
+        OnError{[this]() {
+          AE_TELED_ERROR("DxSmartLr02LoraGateway init failed");
+          operation_queue_->Release(LoraOperationQueue::Lane::kData);
+          RestoreDataMode();
+        }},
     });
 
     return init_pipeline;
-  }));
+  });
+}
+
+ActionPtr<IPipeline> DxSmartLr02LoraGateway::ApplyConfig() {
+  auto commands = DxSmartLr02Config::Diff(applied_config_, lora_gateway_init_);
+  if (!commands) {
+    AE_TELED_ERROR("Unsupported DxSmartLr02LoraGateway configuration");
+    return MakeActionPtr<Pipeline>(
+        action_context_, Stage<GenAction>(action_context_, []() {
+          return UpdateStatus::Error();
+        }));
+  }
+  if (commands->empty()) {
+    return MakeActionPtr<Pipeline>(
+        action_context_, Stage<GenAction>(action_context_, []() {
+          return UpdateStatus::Result();
+        }));
+  }
+
+  AE_TELED_DEBUG("Apply {} settings", commands->size());
+  return MakeActionPtr<Pipeline>(
+      action_context_,
+      // Enter AT command mode
+      Stage([this]() { return EnterAtMode(); }),
+      Stage([this, commands{std::move(*commands)}]() {
+        // module state is unknown until all the commands succeed
+        applied_config_.reset();
+        return ActionPtr<DxSmartLr02ConfigAction>{action_context_, *this,
+                                                  commands};
+      }),
+      // Exit AT command mode
+      Stage([this]() { return ExitAtMode(); }),
+      Stage<GenAction>(action_context_,
+                       [this, lora_gateway_init{lora_gateway_init_}]() {
+                         applied_config_ = lora_gateway_init;
+                         return UpdateStatus::Result();
+                       }));
 }
 
 ActionPtr<IPipeline> DxSmartLr02LoraGateway::OpenTcpConnection(
@@ -575,66 +1109,32 @@ ActionPtr<IPipeline> DxSmartLr02LoraGateway::OpenUdpConnection(
       }));
 }
 
-void DxSmartLr02LoraGateway::SetupPoll() {
-  poll_listener_ = at_comm_support_.ListenForResponse(
-      "#XPOLL: ", [this](auto& at_buffer, auto pos) {
-        std::int32_t handle{};
-        std::string flags;
-        AtSupport::ParseResponse(*pos, "#XPOLL", handle, flags);
-        PollEvent(handle, flags);
-        return at_buffer.erase(pos);
-      });
-
-  // TODO: config for poll interval
-  poll_task_ = ActionPtr<RepeatableTask>{
-      action_context_,
-      [this]() {
-        if (connections_.empty()) {
-          return;
-        }
-        // add poll to operation queue
-        operation_queue_->Push(Stage([this]() { return Poll(); }));
-      },
-      std::chrono::milliseconds{100}};
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::Poll() {
-  return MakeActionPtr<Pipeline>(action_context_, Stage([this]() {
-                                   std::string handles;
-                                   for (auto ci : connections_) {
-                                     handles += "," + std::to_string(ci);
-                                   }
-                                   return at_comm_support_.MakeRequest(
-                                       "#XPOLL=0" + handles, kWaitOk);
-                                 }));
-}
-
-void DxSmartLr02LoraGateway::PollEvent(std::int32_t handle,
-                                       std::string_view flags) {
-  auto flags_val = FromChars<std::uint32_t>(flags);
-  if (!flags_val) {
+void DxSmartLr02LoraGateway::OnSerialData(DataBuffer const& data) {
+  // in AT mode serial data are responses for AtSupport
+  if (at_mode_) {
     return;
   }
-
-  // get connection index
-  auto it = connections_.find(static_cast<ConnectionLoraGatewayIndex>(handle));
-  if (it == std::end(connections_)) {
-    AE_TELED_ERROR("Poll unknown handle {}", handle);
-    return;
+  auto const crc_errors = frame_decoder_.crc_errors();
+  frame_decoder_.Push(data);
+  if (frame_decoder_.crc_errors() != crc_errors) {
+    AE_TELED_WARNING("Dropped {} frames with wrong crc",
+                     frame_decoder_.crc_errors() - crc_errors);
   }
+}
 
-  constexpr std::uint32_t kPollIn = 0x01;
-  if (*flags_val | kPollIn) {
-    operation_queue_->Push(
-        Stage([this, connection{*it}]() { return ReadPacket(connection); }));
-  }
+void DxSmartLr02LoraGateway::OnPacket(LoraGatewayPacket const& packet) {
+  AE_TELED_DEBUG("Received packet for connection {} size {}",
+                 static_cast<int>(packet.connection.connect_index),
+                 packet.data.size());
+  data_event_.Emit(packet.connection.connect_index, packet.data);
 }
 
 ActionPtr<IPipeline> DxSmartLr02LoraGateway::EnterAtMode() {
   if (at_mode_ == false) {
     at_mode_ = true;
+    frame_decoder_.Reset();
     return MakeActionPtr<Pipeline>(action_context_, Stage([this]() {
-                                     return at_comm_support_.MakeRequest(
+                                     return at_comm_support_->MakeRequest(
                                          "+++", kWaitEntryAt);
                                    }));
   }
@@ -646,7 +1146,7 @@ ActionPtr<IPipeline> DxSmartLr02LoraGateway::ExitAtMode() {
   if (at_mode_ == true) {
     at_mode_ = false;
     return MakeActionPtr<Pipeline>(action_context_, Stage([this]() {
-                                     return at_comm_support_.MakeRequest(
+                                     return at_comm_support_->MakeRequest(
                                          "+++", kWaitExitAt, kWaitPowerOn);
                                    }));
   }
@@ -654,172 +1154,29 @@ ActionPtr<IPipeline> DxSmartLr02LoraGateway::ExitAtMode() {
   return {};
 }
 
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetLoraGatewayMode(
-    kLoraGatewayMode const& mode) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, mode]() {
-        return at_comm_support_.MakeRequest(
-            "AT+MODE" + std::to_string(static_cast<int>(mode)), kWaitOk);
-      }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetLoraGatewayLevel(
-    kLoraGatewayLevel const& level) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, level]() {
-        return at_comm_support_.MakeRequest(
-            "AT+LEVEL" + std::to_string(static_cast<int>(level)), kWaitOk);
-      }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetLoraGatewayPower(
-    kLoraGatewayPower const& power) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, power]() {
-        return at_comm_support_.MakeRequest(
-            "AT+POWE" + std::to_string(static_cast<int>(power)), kWaitOk);
-      }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetLoraGatewayBandWidth(
-    kLoraGatewayBandWidth const& band_width) {
-  int bw{0};
-  if (band_width != kLoraGatewayBandWidth::kBandWidth125K) {
-    return {};
-  }
-
-  return MakeActionPtr<Pipeline>(action_context_, Stage([this, bw]() {
-                                   return at_comm_support_.MakeRequest(
-                                       "AT+BW" + std::to_string(bw), kWaitOk);
-                                 }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetLoraGatewayCodingRate(
-    kLoraGatewayCodingRate const& coding_rate) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, coding_rate]() {
-        return at_comm_support_.MakeRequest(
-            "AT+CR" + std::to_string(static_cast<int>(coding_rate)), kWaitOk);
-      }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetLoraGatewaySpreadingFactor(
-    kLoraGatewaySpreadingFactor const& spreading_factor) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, spreading_factor]() {
-        return at_comm_support_.MakeRequest(
-            "AT+SF" + std::to_string(static_cast<int>(spreading_factor)),
-            kWaitOk);
-      }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetupSerialPort(
-    SerialInit& serial_init) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, serial_init]() {
-        return SetBaudRate(serial_init.baud_rate);
-      }),
-      Stage([this, serial_init]() { return SetParity(serial_init.parity); }),
-      Stage([this, serial_init]() {
-        return SetStopBits(serial_init.stop_bits);
-      }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetBaudRate(kBaudRate baud_rate) {
-  auto it = baud_rate_commands_lr02.find(baud_rate);
-  if (it == baud_rate_commands_lr02.end()) {
-    return {};
-  }
-
-  return MakeActionPtr<Pipeline>(action_context_, Stage([this, it]() {
-                                   return at_comm_support_.MakeRequest(
-                                       it->second, kWaitOk);
-                                 }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetParity(kParity parity) {
-  std::string cmd{};
-
-  switch (parity) {
-    case kParity::kNoParity:
-      cmd = "AT+PARI0";  // Set no parity
-      break;
-    case kParity::kOddParity:
-      cmd = "AT+PARI1";  // Set odd parity
-      break;
-    case kParity::kEvenParity:
-      cmd = "AT+PARI2";  // Set even parity
-      break;
-    default:
-      return {};
-      break;
-  }
-
-  return MakeActionPtr<Pipeline>(action_context_, Stage([this, cmd]() {
-                                   return at_comm_support_.MakeRequest(cmd,
-                                                                       kWaitOk);
-                                 }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetStopBits(kStopBits stop_bits) {
-  std::string cmd{};
-
-  switch (stop_bits) {
-    case kStopBits::kOneStopBit:
-      cmd = "AT+STOP1";  // 0 stop bits
-      break;
-    case kStopBits::kTwoStopBit:
-      cmd = "AT+STOP2";  // 2 stop bits
-      break;
-    default:
-      return {};
-      break;
+void DxSmartLr02LoraGateway::RestoreDataMode() {
+  if (!at_mode_) {
+    return;
   }
-
-  return MakeActionPtr<Pipeline>(action_context_,
-
-                                 Stage([this, cmd]() {
-                                   return at_comm_support_.MakeRequest(cmd,
-                                                                       kWaitOk);
-                                 }));
-}
-
-ActionPtr<IPipeline> DxSmartLr02LoraGateway::SetupLoraNet(
-    LoraGatewayInit& lora_gateway_init) {
-  return MakeActionPtr<Pipeline>(
-      action_context_, Stage([this, lora_gateway_init]() {
-        return SetLoraGatewayAddress(lora_gateway_init.lora_gateway_my_adress);
-      }),
-      Stage([this, lora_gateway_init]() {
-        return SetLoraGatewayChannel(lora_gateway_init.lora_gateway_channel);
-      }),
-      Stage([this, lora_gateway_init]() {
-        return SetLoraGatewayCRCCheck(lora_gateway_init.lora_gateway_crc_check);
-      }),
-      Stage([this, lora_gateway_init]() {
-        return SetLoraGatewayIQSignalInversion(
-            lora_gateway_init.lora_gateway_signal_inversion);
-      }));
-}
-
-std::string DxSmartLr02LoraGateway::AdressToString(uint16_t value) {
-  uint8_t high = static_cast<uint8_t>((value >> 8));  // High byte
-  uint8_t low = static_cast<uint8_t>(value & 0xFF);   // Low byte
-  char buffer[7];                                     // Buffer for string
-
-  // Formatting hex string
-  std::snprintf(buffer, sizeof(buffer), "%02x,%02x", high, low);
-
-  return std::string(buffer);
-}
-
-std::string DxSmartLr02LoraGateway::ChannelToString(uint8_t value) {
-  char buffer[5];  // Buffer for string
-
-  // Formatting hex string
-  std::snprintf(buffer, sizeof(buffer), "%02x", value);
-
-  return std::string(buffer);
+  AE_TELED_WARNING("Exit AT mode after failed operation");
+  operation_queue_->Hold(LoraOperationQueue::Lane::kData);
+  operation_queue_->Push(LoraOperationQueue::Lane::kControl, [this]() {
+    auto pipeline = ExitAtMode();
+    if (!pipeline) {
+      operation_queue_->Release(LoraOperationQueue::Lane::kData);
+      return pipeline;
+    }
+    pipeline->StatusEvent().Subscribe(ActionHandler{
+        OnResult{[this]() {
+          operation_queue_->Release(LoraOperationQueue::Lane::kData);
+        }},
+        OnError{[this]() {
+          AE_TELED_ERROR("Unable to exit AT mode");
+          operation_queue_->Release(LoraOperationQueue::Lane::kData);
+        }},
+    });
+    return pipeline;
+  });
 }
 
 }  // namespace ae
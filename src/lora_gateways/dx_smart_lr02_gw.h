@@ -18,41 +18,68 @@
 #define LORA_GATEWAYS_DX_SMART_LR02_GW_H_
 
 #include <set>
+#include <deque>
 #include <memory>
+#include <functional>
+#include <string>
+#include <optional>
 
 #include "aether/poller/poller.h"
 #include "aether/actions/pipeline.h"
-#include "aether/actions/actions_queue.h"
-#include "aether/actions/repeatable_task.h"
 #include "aether/serial_ports/iserial_port.h"
 #include "aether/serial_ports/at_support/at_support.h"
 
+#include "gateway/deadline_action.h"
+#include "gateway/metrics_registry.h"
+
+#include "lora_gateways/lora_duty_cycle.h"
+#include "lora_gateways/lora_gateway_frame.h"
+#include "lora_gateways/lora_device_registry.h"
+#include "lora_gateways/lora_operation_queue.h"
 #include "lora_gateways/ilora_gateway_driver.h"
 
 namespace ae {
 class DxSmartLr02TcpOpenNetwork;
 class DxSmartLr02UdpOpenNetwork;
-
-static const std::map<kBaudRate, std::string> baud_rate_commands_lr02 = {
-    {kBaudRate::kBaudRate1200, "AT+BAUD1"},
-    {kBaudRate::kBaudRate2400, "AT+BAUD2"},
-    {kBaudRate::kBaudRate4800, "AT+BAUD3"},
-    {kBaudRate::kBaudRate9600, "AT+BAUD4"},
-    {kBaudRate::kBaudRate19200, "AT+BAUD5"},
-    {kBaudRate::kBaudRate38400, "AT+BAUD6"},
-    {kBaudRate::kBaudRate57600, "AT+BAUD7"},
-    {kBaudRate::kBaudRate115200, "AT+BAUD8"},
-    {kBaudRate::kBaudRate128000, "AT+BAUD9"}};
+class DxSmartLr02TransmitAction;
+class DxSmartLr02ConfigAction;
+class DxSmartLr02BaudRateAction;
 
 class DxSmartLr02LoraGateway final : public ILoraGatewayDriver {
   friend class DxSmartLr02TcpOpenNetwork;
   friend class DxSmartLr02UdpOpenNetwork;
+  friend class DxSmartLr02TransmitAction;
+  friend class DxSmartLr02ConfigAction;
+  friend class DxSmartLr02BaudRateAction;
   static constexpr std::uint16_t kLoraGatewayMTU{400};
+  // max frames written to serial port and not yet completed
+  static constexpr std::size_t kMaxInflightWrites{4};
+
+  struct TxFrame {
+    ConnectionLoraGatewayIndex connection;
+    // radio channel the frame is transmitted on
+    std::uint8_t channel;
+    // bytes transmitted over the air, without fixed-point target prefix
+    std::size_t air_size;
+    // encoded frame, the fixed-point prefix is added by WriteFrame
+    DataBuffer frame;
+    ActionPtr<WriteOperation> write_operation;
+  };
 
  public:
+  using SerialPortCreator = std::function<std::unique_ptr<ISerialPort>(
+      SerialInit const& serial_init)>;
+
   explicit DxSmartLr02LoraGateway(ActionContext action_context,
                                   IPoller::ptr const& poller,
                                   LoraGatewayInit lora_gateway_init);
+  /**
+   * \brief Driver over serial ports made by serial_port_creator.
+   * E.g. an emulated module for testing without hardware.
+   */
+  DxSmartLr02LoraGateway(ActionContext action_context,
+                         SerialPortCreator serial_port_creator,
+                         LoraGatewayInit lora_gateway_init);
   ~DxSmartLr02LoraGateway() override;
 
   ActionPtr<LoraGatewayOperation> Start() override;
@@ -68,6 +95,14 @@ class DxSmartLr02LoraGateway final : public ILoraGatewayDriver {
 
   DataEvent::Subscriber data_event() override;
 
+  /**
+   * \brief Apply the module settings in one AT session.
+   * Only parameters changed since the last applied configuration are sent to
+   * the module, nothing is sent if there are no changes.
+   */
+  ActionPtr<LoraGatewayOperation> Configure(
+      LoraGatewayInit const& lora_gateway_init) override;
+
   ActionPtr<LoraGatewayOperation> SetPowerSaveParam(
       LoraGatewayPowerSaveParam const& psp) override;
   ActionPtr<LoraGatewayOperation> PowerOff() override;
@@ -82,8 +117,30 @@ class DxSmartLr02LoraGateway final : public ILoraGatewayDriver {
       kLoraGatewayIQSignalInversion const&
           signal_inversion);  // Gateway signal inversion
 
+  /**
+   * \brief Packets to devices not bound are broadcast in fixed-point mode.
+   */
+  void BindDevice(std::uint8_t device_id,
+                  LoraDeviceAddress const& address) override;
+
+  /**
+   * \brief Wait time statistics of operations by queue lane.
+   * Data is written on the data lane, start, stop and network operations go
+   * on the control lane and configuration changes on the maintenance lane.
+   */
+  LoraOperationQueue::LaneStats const& queue_stats(
+      LoraOperationQueue::Lane lane) const;
+
+  /**
+   * \brief Report the transmit queue depth and AT request retries.
+   * Metrics are labeled by the serial port, so several modules may share the
+   * registry.
+   */
+  void SetMetrics(gw::MetricsRegistry& metrics);
+
  private:
   void Init();
+  ActionPtr<IPipeline> ApplyConfig();
 
   ActionPtr<IPipeline> OpenTcpConnection(
       ActionPtr<OpenNetworkOperation> open_network_operation,
@@ -95,50 +152,75 @@ class DxSmartLr02LoraGateway final : public ILoraGatewayDriver {
 
   ActionPtr<IPipeline> SendData(ConnectionLoraGatewayIndex connection,
                                 DataBuffer const& data);
-  ActionPtr<IPipeline> ReadPacket(ConnectionLoraGatewayIndex connection);
-
-  void SetupPoll();
-  ActionPtr<IPipeline> Poll();
-  void PollEvent(std::int32_t handle, std::string_view flags);
+  Duration SerialTransferTime(std::size_t size) const;
+  void SetHostBaudRate(kBaudRate baud_rate);
+  void QueueTransmit();
+  /**
+   * \brief Queue transmission at the time the next frame fits the duty cycle
+   * budget.
+   */
+  void WakeTransmitAt(TimePoint at);
+  TimePoint WakeTransmit(TimePoint now);
+  Duration FrameAirtime(std::size_t air_size) const;
+  /**
+   * \brief Settings the module works with, a queued change is not applied
+   * yet.
+   */
+  LoraGatewayInit const& applied_init() const;
+  /**
+   * \brief Target of the frame if the module is in fixed-point mode.
+   */
+  std::optional<LoraDeviceAddress> FixedPointTarget(
+      ConnectionLoraGatewayIndex connect_index) const;
+  /**
+   * \brief Write the frame to the serial port with the fixed-point prefix
+   * of the applied mode, returns the number of bytes written.
+   */
+  std::size_t WriteFrame(TxFrame const& tx_frame);
+  std::deque<TxFrame>::iterator SelectTxFrame(TimePoint now,
+                                              TimePoint& ready_at);
+
+  void CountMetric(gw::MetricsRegistry::MetricId metric, std::int64_t value);
+
+  void OnSerialData(DataBuffer const& data);
+  void OnPacket(LoraGatewayPacket const& packet);
 
   ActionContext action_context_;
+  SerialPortCreator serial_port_creator_;
   LoraGatewayInit lora_gateway_init_;
+  // settings known to be applied to the module
+  std::optional<LoraGatewayInit> applied_config_;
   std::unique_ptr<ISerialPort> serial_;
   std::set<ConnectionLoraGatewayIndex> connections_;
-  AtSupport at_comm_support_;
+  // recreated with serial port on baud rate change
+  std::optional<AtSupport> at_comm_support_;
   DataEvent data_event_;
-  ActionPtr<RepeatableTask> poll_task_;
-  std::unique_ptr<AtListener> poll_listener_;
-  OwnActionPtr<ActionsQueue> operation_queue_;
+  LoraGatewayFrameDecoder frame_decoder_;
+  Subscription serial_read_sub_;
+  Subscription packet_sub_;
+  OwnActionPtr<LoraOperationQueue> operation_queue_;
+  std::deque<TxFrame> tx_queue_;
+  LoraDutyCycle duty_cycle_;
+  OwnActionPtr<gw::DeadlineAction> tx_wake_action_;
+  TimePoint tx_ready_at_;
+  LoraDeviceRegistry device_registry_;
+  bool tx_active_{false};
+  // running transmit stage of tx_active_, null while it waits in the queue
+  DxSmartLr02TransmitAction* transmit_action_{};
   bool initiated_;
   bool started_;
   bool at_mode_{false};
+  gw::MetricsRegistry* metrics_{};
+  gw::MetricsRegistry::MetricId tx_queue_metric_{};
+  gw::MetricsRegistry::MetricId at_retries_metric_{};
 
   ActionPtr<IPipeline> EnterAtMode();
   ActionPtr<IPipeline> ExitAtMode();
-
-  ActionPtr<IPipeline> SetLoraGatewayMode(
-      kLoraGatewayMode const& mode);  // Gateway mode
-  ActionPtr<IPipeline> SetLoraGatewayLevel(
-      kLoraGatewayLevel const& level);  // Gateway level
-  ActionPtr<IPipeline> SetLoraGatewayPower(
-      kLoraGatewayPower const& power);  // Gateway power
-  ActionPtr<IPipeline> SetLoraGatewayBandWidth(
-      kLoraGatewayBandWidth const& band_width);  // Gateway BandWidth
-  ActionPtr<IPipeline> SetLoraGatewayCodingRate(
-      kLoraGatewayCodingRate const& coding_rate);  // Gateway CodingRate
-  ActionPtr<IPipeline> SetLoraGatewaySpreadingFactor(
-      kLoraGatewaySpreadingFactor const&
-          spreading_factor);  // Gateway spreading factor
-  ActionPtr<IPipeline> SetupSerialPort(SerialInit& serial_init);
-  ActionPtr<IPipeline> SetBaudRate(kBaudRate baud_rate);
-  ActionPtr<IPipeline> SetParity(kParity parity);
-  ActionPtr<IPipeline> SetStopBits(kStopBits stop_bits);
-
-  ActionPtr<IPipeline> SetupLoraNet(LoraGatewayInit& lora_gateway_init);
-
-  std::string AdressToString(uint16_t value);
-  std::string ChannelToString(uint8_t value);
+  /**
+   * \brief Leave AT mode after a failed pipeline skipped its ExitAtMode.
+   * Data lane is held until the module is back in transparent mode.
+   */
+  void RestoreDataMode();
 };
 
 } /* namespace ae */
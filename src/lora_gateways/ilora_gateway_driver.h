@@ -27,6 +27,7 @@
 #include "aether/actions/action_ptr.h"
 #include "aether/actions/notify_action.h"
 #include "aether/actions/promise_action.h"
+#include "lora_gateways/lora_device_registry.h"
 #include "lora_gateways/lora_gateway_driver_types.h"
 
 namespace ae {
@@ -51,9 +52,22 @@ class ILoraGatewayDriver {
       ConnectionLoraGatewayIndex connect_index, DataBuffer const& data) = 0;
   virtual DataEvent::Subscriber data_event() = 0;
 
+  /**
+   * \brief Apply the radio module settings of lora_gateway_init.
+   * Serial port settings are kept as they were on start.
+   */
+  virtual ActionPtr<LoraGatewayOperation> Configure(
+      LoraGatewayInit const& lora_gateway_init) = 0;
   virtual ActionPtr<LoraGatewayOperation> SetPowerSaveParam(
       LoraGatewayPowerSaveParam const& psp) = 0;
   virtual ActionPtr<LoraGatewayOperation> PowerOff() = 0;
+
+  /**
+   * \brief Address of the device module, used for unicast in fixed-point
+   * mode.
+   */
+  virtual void BindDevice(std::uint8_t device_id,
+                          LoraDeviceAddress const& address) = 0;
 };
 
 } /* namespace ae */
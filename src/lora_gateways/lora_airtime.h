@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_AIRTIME_H_
+#define LORA_GATEWAYS_LORA_AIRTIME_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "aether/clock.h"
+
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae {
+namespace lora_airtime_internal {
+static constexpr std::array<std::uint32_t, 10> kBandWidthHz{
+    7810, 10420, 15630, 20830, 31250, 41670, 62500, 125000, 250000, 500000};
+
+static constexpr std::size_t kMinSpreadingFactor = 5;
+static constexpr std::size_t kMaxSpreadingFactor = 12;
+
+using SymbolTable = std::array<std::array<std::uint64_t, kBandWidthHz.size()>,
+                               kMaxSpreadingFactor - kMinSpreadingFactor + 1>;
+
+constexpr SymbolTable MakeSymbolTable() {
+  SymbolTable table{};
+  for (std::size_t sf = kMinSpreadingFactor; sf <= kMaxSpreadingFactor; ++sf) {
+    for (std::size_t bw = 0; bw < kBandWidthHz.size(); ++bw) {
+      table[sf - kMinSpreadingFactor][bw] =
+          ((std::uint64_t{1} << sf) * 1000000000) / kBandWidthHz[bw];
+    }
+  }
+  return table;
+}
+
+// symbol time in nanoseconds by spreading factor and bandwidth
+static constexpr SymbolTable kSymbolTimeNs = MakeSymbolTable();
+}  // namespace lora_airtime_internal
+
+/**
+ * \brief LoRa time on air by the Semtech modem designer's guide formula.
+ * Symbol times for all spreading factors and bandwidths are a compile time
+ * table, so the calculation is a few integer operations.
+ */
+class LoraAirtime {
+ public:
+  static constexpr std::uint32_t kPreambleSymbols = 8;
+
+  static constexpr std::uint32_t BandWidthHz(kLoraGatewayBandWidth band_width) {
+    return lora_airtime_internal::kBandWidthHz[static_cast<std::size_t>(
+        band_width)];
+  }
+
+  static constexpr std::uint64_t SymbolTimeNs(
+      kLoraGatewaySpreadingFactor spreading_factor,
+      kLoraGatewayBandWidth band_width) {
+    return lora_airtime_internal::kSymbolTimeNs
+        [static_cast<std::size_t>(spreading_factor) -
+         lora_airtime_internal::kMinSpreadingFactor]
+        [static_cast<std::size_t>(band_width)];
+  }
+
+  /**
+   * \brief Time on air of the packet with explicit header and CRC on.
+   */
+  static constexpr Duration Calculate(
+      kLoraGatewaySpreadingFactor spreading_factor,
+      kLoraGatewayBandWidth band_width, kLoraGatewayCodingRate coding_rate,
+      std::size_t payload_size) {
+    auto const sf = static_cast<std::int64_t>(spreading_factor);
+    auto const cr = static_cast<std::int64_t>(coding_rate);
+    auto const symbol_time = SymbolTimeNs(spreading_factor, band_width);
+    // low data rate optimization is mandatory for symbols longer than 16ms
+    auto const low_data_rate = (symbol_time > 16000000) ? 1 : 0;
+
+    auto const bits = (8 * static_cast<std::int64_t>(payload_size)) -
+                      (4 * sf) + 28 + 16;
+    auto const bits_per_block = 4 * (sf - (2 * low_data_rate));
+    auto const blocks =
+        (bits > 0) ? ((bits + bits_per_block - 1) / bits_per_block) : 0;
+    auto const payload_symbols = 8 + (blocks * (cr + 4));
+
+    // preamble is 4.25 symbols longer than its length, count quarters
+    auto const quarter_symbols = static_cast<std::uint64_t>(
+        (4 * (kPreambleSymbols + payload_symbols)) + 17);
+    return std::chrono::duration_cast<Duration>(
+        std::chrono::nanoseconds{(quarter_symbols * symbol_time) / 4});
+  }
+
+  static constexpr Duration Calculate(LoraGatewayPowerSaveParam const& psp,
+                                      std::size_t payload_size) {
+    return Calculate(psp.lora_gateway_spreading_factor,
+                     psp.lora_gateway_band_width, psp.lora_gateway_coding_rate,
+                     payload_size);
+  }
+};
+
+// 50 bytes at SF12 125 kHz CR 4/5 take about 2.3 s
+static_assert(LoraAirtime::Calculate(kLoraGatewaySpreadingFactor::kSF12,
+                                     kLoraGatewayBandWidth::kBandWidth125K,
+                                     kLoraGatewayCodingRate::kCR4_5,
+                                     50) > std::chrono::milliseconds{2200});
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_AIRTIME_H_
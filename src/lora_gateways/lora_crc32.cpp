@@ -0,0 +1,219 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_crc32.h"
+
+#include <array>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define LORA_CRC32_PCLMUL 1
+#  include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#  define LORA_CRC32_ARM 1
+#  include <arm_acle.h>
+#endif
+
+namespace ae {
+namespace {
+constexpr std::uint32_t kPolynomial = 0xEDB88320;
+
+using Crc32Tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+constexpr Crc32Tables MakeTables() {
+  Crc32Tables tables{};
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    auto crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1U) != 0 ? kPolynomial : 0U);
+    }
+    tables[0][i] = crc;
+  }
+  // tables[k][i] is crc of byte i followed by k zero bytes
+  for (std::size_t k = 1; k < tables.size(); ++k) {
+    for (std::size_t i = 0; i < 256; ++i) {
+      auto const prev = tables[k - 1][i];
+      tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+  return tables;
+}
+
+constexpr Crc32Tables kTables = MakeTables();
+
+// crc is the inverted register state here and in the accelerated paths
+std::uint32_t SliceBy8(std::uint8_t const* data, std::size_t size,
+                       std::uint32_t crc) {
+  while (size >= 8) {
+    auto const low = crc ^ (static_cast<std::uint32_t>(data[0]) |
+                            (static_cast<std::uint32_t>(data[1]) << 8) |
+                            (static_cast<std::uint32_t>(data[2]) << 16) |
+                            (static_cast<std::uint32_t>(data[3]) << 24));
+    crc = kTables[7][low & 0xFF] ^ kTables[6][(low >> 8) & 0xFF] ^
+          kTables[5][(low >> 16) & 0xFF] ^ kTables[4][low >> 24] ^
+          kTables[3][data[4]] ^ kTables[2][data[5]] ^ kTables[1][data[6]] ^
+          kTables[0][data[7]];
+    data += 8;
+    size -= 8;
+  }
+  while (size-- != 0) {
+    crc = (crc >> 8) ^ kTables[0][(crc ^ *data++) & 0xFF];
+  }
+  return crc;
+}
+
+#if LORA_CRC32_PCLMUL
+// the fold needs at least 4 blocks of 16 bytes
+constexpr std::size_t kPclmulMinSize = 64;
+
+__attribute__((target("pclmul,sse4.1"))) inline __m128i Load(
+    std::uint8_t const* data) {
+  return _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+}
+
+// x * k folded with the next block y
+__attribute__((target("pclmul,sse4.1"))) inline __m128i Fold(__m128i x,
+                                                              __m128i k,
+                                                              __m128i y) {
+  auto const low = _mm_clmulepi64_si128(x, k, 0x00);
+  auto const high = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(high, low), y);
+}
+
+/**
+ * Folding by 4 and Barrett reduction from Intel's "Fast CRC Computation for
+ * Generic Polynomials Using PCLMULQDQ Instruction", bit-reflected constants.
+ * size is a multiple of 16 and not less than kPclmulMinSize.
+ */
+__attribute__((target("pclmul,sse4.1"))) std::uint32_t Pclmul(
+    std::uint8_t const* data, std::size_t size, std::uint32_t crc) {
+  alignas(16) static constexpr std::uint64_t kK1K2[] = {0x0154442bd4,
+                                                        0x01c6e41596};
+  alignas(16) static constexpr std::uint64_t kK3K4[] = {0x01751997d0,
+                                                        0x00ccaa009e};
+  alignas(16) static constexpr std::uint64_t kK5K0[] = {0x0163cd6124,
+                                                        0x0000000000};
+  alignas(16) static constexpr std::uint64_t kPoly[] = {0x01db710641,
+                                                        0x01f7011641};
+
+  auto x1 = Load(data);
+  auto x2 = Load(data + 16);
+  auto x3 = Load(data + 32);
+  auto x4 = Load(data + 48);
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  data += 64;
+  size -= 64;
+
+  // parallel fold of 64 byte blocks
+  auto k = _mm_load_si128(reinterpret_cast<__m128i const*>(kK1K2));
+  while (size >= 64) {
+    x1 = Fold(x1, k, Load(data));
+    x2 = Fold(x2, k, Load(data + 16));
+    x3 = Fold(x3, k, Load(data + 32));
+    x4 = Fold(x4, k, Load(data + 48));
+    data += 64;
+    size -= 64;
+  }
+
+  // fold into 128 bits
+  k = _mm_load_si128(reinterpret_cast<__m128i const*>(kK3K4));
+  x1 = Fold(x1, k, x2);
+  x1 = Fold(x1, k, x3);
+  x1 = Fold(x1, k, x4);
+  while (size >= 16) {
+    x1 = Fold(x1, k, Load(data));
+    data += 16;
+    size -= 16;
+  }
+
+  // fold 128 bits to 64 bits
+  auto const mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  k = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(kK5K0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  k = _mm_load_si128(reinterpret_cast<__m128i const*>(kPoly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+bool HasPclmul() {
+  static bool const has_pclmul = __builtin_cpu_supports("pclmul") &&
+                                 __builtin_cpu_supports("sse4.1");
+  return has_pclmul;
+}
+#endif
+
+#if LORA_CRC32_ARM
+std::uint32_t ArmCrc32(std::uint8_t const* data, std::size_t size,
+                       std::uint32_t crc) {
+  while (size >= 8) {
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+      word |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+    }
+    crc = __crc32d(crc, word);
+    data += 8;
+    size -= 8;
+  }
+  while (size-- != 0) {
+    crc = __crc32b(crc, *data++);
+  }
+  return crc;
+}
+#endif
+}  // namespace
+
+std::uint32_t LoraCrc32::Calculate(std::uint8_t const* data, std::size_t size,
+                                   std::uint32_t crc) {
+  crc = ~crc;
+#if LORA_CRC32_PCLMUL
+  if ((size >= kPclmulMinSize) && HasPclmul()) {
+    auto const folded = size & ~std::size_t{15};
+    crc = Pclmul(data, folded, crc);
+    data += folded;
+    size -= folded;
+  }
+  crc = SliceBy8(data, size, crc);
+#elif LORA_CRC32_ARM
+  crc = ArmCrc32(data, size, crc);
+#else
+  crc = SliceBy8(data, size, crc);
+#endif
+  return ~crc;
+}
+
+std::uint32_t LoraCrc32::CalculateSoftware(std::uint8_t const* data,
+                                           std::size_t size,
+                                           std::uint32_t crc) {
+  return ~SliceBy8(data, size, ~crc);
+}
+
+bool LoraCrc32::accelerated() {
+#if LORA_CRC32_PCLMUL
+  return HasPclmul();
+#elif LORA_CRC32_ARM
+  return true;
+#else
+  return false;
+#endif
+}
+}  // namespace ae
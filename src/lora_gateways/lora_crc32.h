@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_CRC32_H_
+#define LORA_GATEWAYS_LORA_CRC32_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ae {
+/**
+ * \brief CRC-32 (IEEE 802.3, reflected 0x04C11DB7) as in zlib.
+ * Uses carry-less multiply folding on x86-64 with PCLMULQDQ, CRC32
+ * instructions on ARMv8 and slice-by-8 tables otherwise.
+ */
+class LoraCrc32 {
+ public:
+  /**
+   * \brief CRC of data, continued from crc of the previous data.
+   */
+  static std::uint32_t Calculate(std::uint8_t const* data, std::size_t size,
+                                 std::uint32_t crc = 0);
+  /**
+   * \brief Portable slice-by-8 implementation.
+   */
+  static std::uint32_t CalculateSoftware(std::uint8_t const* data,
+                                         std::size_t size,
+                                         std::uint32_t crc = 0);
+  /**
+   * \brief Is a hardware accelerated path used by Calculate.
+   */
+  static bool accelerated();
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_CRC32_H_
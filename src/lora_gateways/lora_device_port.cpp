@@ -0,0 +1,181 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_device_port.h"
+
+#include <algorithm>
+
+#include "lora_gateways/lora_airtime.h"
+
+namespace ae {
+namespace {
+// packet size the link rate is estimated for
+constexpr std::size_t kRatePacketSize = 200;
+// at least one packet of the largest size fits the queues
+constexpr std::size_t kMinTxCapacity = 512;
+}  // namespace
+
+LoraDevicePort::LoraDevicePort(ILoraGatewayDriver& driver,
+                               gw::ILocalLink& local_link,
+                               gw::BufferPool& buffer_pool,
+                               LoraGatewayPowerSaveParam const& psp,
+                               Config const& config)
+    : driver_{&driver},
+      local_link_{&local_link},
+      buffer_pool_{&buffer_pool},
+      config_{config} {
+  SetPowerSaveParam(psp);
+  data_sub_ = driver_->data_event().Subscribe(
+      [this](auto connect_index, auto const& data) {
+        OnRadioData(connect_index, data);
+      });
+  output_sub_ = local_link_->output_event().Subscribe(
+      [this](auto device_id, auto const& data) {
+        OnLocalOutput(device_id, data);
+      });
+  pressure_sub_ =
+      buffer_pool_->pressure_event().Subscribe([this](auto under_pressure) {
+        if (under_pressure) {
+          TrimQueues();
+        }
+      });
+}
+
+LoraDevicePort::~LoraDevicePort() {
+  for (auto const& [device_id, queue] : tx_queues_) {
+    for (auto const& data : queue) {
+      buffer_pool_->Release(BufferOwner(device_id), data.size());
+    }
+  }
+  for (auto const& [_, owner] : buffer_owners_) {
+    buffer_pool_->Close(owner);
+  }
+}
+
+void LoraDevicePort::SetPowerSaveParam(LoraGatewayPowerSaveParam const& psp) {
+  auto const airtime = std::chrono::duration_cast<std::chrono::microseconds>(
+      LoraAirtime::Calculate(psp, kRatePacketSize));
+  auto const max_delay = std::chrono::duration_cast<std::chrono::microseconds>(
+      config_.tx_max_delay);
+  auto const packets = static_cast<std::size_t>(
+      max_delay.count() / std::max<std::int64_t>(airtime.count(), 1));
+  tx_capacity_ = std::max(kMinTxCapacity, packets * kRatePacketSize);
+  AE_TELED_DEBUG("LoRa device port tx capacity {} bytes", tx_capacity_);
+}
+
+std::size_t LoraDevicePort::tx_capacity() const { return tx_capacity_; }
+
+LoraDevicePort::Stats const& LoraDevicePort::stats() const { return stats_; }
+
+void LoraDevicePort::OnRadioData(ConnectionLoraGatewayIndex connect_index,
+                                 DataBuffer const& data) {
+  ++stats_.rx_packets;
+  local_link_->Input(static_cast<DeviceId>(connect_index), data);
+}
+
+void LoraDevicePort::OnLocalOutput(DeviceId device_id,
+                                   DataBuffer const& data) {
+  if (((tx_queued_bytes_ + data.size()) > tx_capacity_) ||
+      !buffer_pool_->Acquire(BufferOwner(device_id), data.size())) {
+    ++stats_.tx_dropped;
+    AE_TELED_WARNING("LoRa device {} queue is full, {} bytes dropped",
+                     static_cast<int>(device_id), data.size());
+    return;
+  }
+  tx_queued_bytes_ += data.size();
+  tx_queues_[device_id].push_back(data);
+  WriteNext();
+}
+
+void LoraDevicePort::WriteNext() {
+  while ((tx_inflight_ < config_.tx_inflight) && !tx_queues_.empty()) {
+    // round robin over devices with queued packets
+    auto it = tx_queues_.upper_bound(tx_last_device_);
+    if (it == std::end(tx_queues_)) {
+      it = std::begin(tx_queues_);
+    }
+    auto const device_id = it->first;
+    auto data = std::move(it->second.front());
+    it->second.pop_front();
+    if (it->second.empty()) {
+      tx_queues_.erase(it);
+    }
+    tx_queued_bytes_ -= data.size();
+    buffer_pool_->Release(BufferOwner(device_id), data.size());
+    tx_last_device_ = device_id;
+
+    auto write_operation = driver_->WritePacket(
+        static_cast<ConnectionLoraGatewayIndex>(device_id), data);
+    if (!write_operation) {
+      ++stats_.tx_failed;
+      continue;
+    }
+    ++tx_inflight_;
+    ++stats_.tx_packets;
+    write_subs_.Push(write_operation->StatusEvent().Subscribe(ActionHandler{
+        OnResult{[this]() {
+          --tx_inflight_;
+          WriteNext();
+        }},
+        OnError{[this]() {
+          ++stats_.tx_failed;
+          --tx_inflight_;
+          WriteNext();
+        }},
+        OnStop{[this]() {
+          --tx_inflight_;
+          WriteNext();
+        }},
+    }));
+  }
+}
+
+void LoraDevicePort::TrimQueues() {
+  auto const fair_share = buffer_pool_->fair_share();
+  for (auto it = std::begin(tx_queues_); it != std::end(tx_queues_);) {
+    auto const device_id = it->first;
+    auto& queue = it->second;
+    auto const owner = BufferOwner(device_id);
+    std::size_t dropped = 0;
+    // the oldest packets are the most stale
+    while (!queue.empty() && (buffer_pool_->used(owner) > fair_share)) {
+      auto const size = queue.front().size();
+      queue.pop_front();
+      tx_queued_bytes_ -= size;
+      buffer_pool_->Release(owner, size);
+      ++stats_.tx_dropped;
+      ++dropped;
+    }
+    if (dropped != 0) {
+      AE_TELED_WARNING("Buffer pool pressure, {} packets to device {} dropped",
+                       dropped, static_cast<int>(device_id));
+    }
+    if (queue.empty()) {
+      it = tx_queues_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+gw::BufferPool::OwnerId LoraDevicePort::BufferOwner(DeviceId device_id) {
+  auto it = buffer_owners_.find(device_id);
+  if (it == std::end(buffer_owners_)) {
+    it = buffer_owners_.emplace(device_id, buffer_pool_->Open()).first;
+  }
+  return it->second;
+}
+}  // namespace ae
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_DEVICE_PORT_H_
+#define LORA_GATEWAYS_LORA_DEVICE_PORT_H_
+
+#include <map>
+#include <deque>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "gateway/local_link.h"
+#include "gateway/buffer_pool.h"
+
+#include "lora_gateways/ilora_gateway_driver.h"
+
+namespace ae {
+/**
+ * \brief Relays traffic between a LoRa gateway driver and the local link.
+ * Device id of the local link is the connection index of the driver.
+ * Received packets are delivered to the local link as they arrive, the link
+ * has no batch input to amortize a delay over. Packets to devices are queued
+ * per device and written to the driver round robin with a limited number of
+ * writes in progress. The queues hold at most what the link transmits in
+ * tx_max_delay, newer packets are dropped if they are full. Queued packets
+ * are charged to the gateway buffer pool, each device is an owner there.
+ * When the pool comes under pressure the queues are trimmed to the fair share
+ * by dropping their oldest packets.
+ */
+class LoraDevicePort {
+ public:
+  struct Config {
+    // writes in progress in the driver
+    std::size_t tx_inflight;
+    Duration tx_max_delay;
+  };
+
+  static constexpr Config kDefaultConfig{
+      4,
+      std::chrono::seconds{10},
+  };
+
+  struct Stats {
+    std::size_t rx_packets;
+    std::size_t tx_packets;
+    std::size_t tx_dropped;
+    std::size_t tx_failed;
+  };
+
+  LoraDevicePort(ILoraGatewayDriver& driver, gw::ILocalLink& local_link,
+                 gw::BufferPool& buffer_pool,
+                 LoraGatewayPowerSaveParam const& psp,
+                 Config const& config = kDefaultConfig);
+  ~LoraDevicePort();
+
+  /**
+   * \brief Resize the device queues to the link rate of the radio settings.
+   */
+  void SetPowerSaveParam(LoraGatewayPowerSaveParam const& psp);
+
+  std::size_t tx_capacity() const;
+  Stats const& stats() const;
+
+ private:
+  using DeviceId = std::uint8_t;
+
+  void OnRadioData(ConnectionLoraGatewayIndex connect_index,
+                   DataBuffer const& data);
+  void OnLocalOutput(DeviceId device_id, DataBuffer const& data);
+  void WriteNext();
+  void TrimQueues();
+  gw::BufferPool::OwnerId BufferOwner(DeviceId device_id);
+
+  ILoraGatewayDriver* driver_;
+  gw::ILocalLink* local_link_;
+  gw::BufferPool* buffer_pool_;
+  Config config_;
+  std::size_t tx_capacity_{};
+
+  std::map<DeviceId, std::deque<DataBuffer>> tx_queues_;
+  std::map<DeviceId, gw::BufferPool::OwnerId> buffer_owners_;
+  std::size_t tx_queued_bytes_{};
+  std::size_t tx_inflight_{};
+  // the last device written to, for round robin
+  DeviceId tx_last_device_{};
+  Stats stats_{};
+
+  Subscription data_sub_;
+  Subscription output_sub_;
+  Subscription pressure_sub_;
+  MultiSubscription write_subs_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_DEVICE_PORT_H_
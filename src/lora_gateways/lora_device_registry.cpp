@@ -0,0 +1,38 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_device_registry.h"
+
+namespace ae {
+void LoraDeviceRegistry::Bind(DeviceId device_id, LoraDeviceAddress address) {
+  devices_[device_id] = address;
+}
+
+void LoraDeviceRegistry::Unbind(DeviceId device_id) {
+  devices_.erase(device_id);
+}
+
+std::optional<LoraDeviceAddress> LoraDeviceRegistry::Find(
+    DeviceId device_id) const {
+  auto it = devices_.find(device_id);
+  if (it == std::end(devices_)) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+std::size_t LoraDeviceRegistry::size() const { return devices_.size(); }
+}  // namespace ae
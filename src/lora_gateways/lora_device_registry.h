@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_DEVICE_REGISTRY_H_
+#define LORA_GATEWAYS_LORA_DEVICE_REGISTRY_H_
+
+#include <map>
+#include <cstdint>
+#include <optional>
+
+#include "aether/reflect/reflect.h"
+
+namespace ae {
+/**
+ * \brief LoRa module address and channel of a device.
+ */
+struct LoraDeviceAddress {
+  AE_REFLECT_MEMBERS(address, channel)
+
+  static constexpr std::uint16_t kBroadcast = 0xFFFF;
+
+  bool operator==(LoraDeviceAddress const& other) const {
+    return (address == other.address) && (channel == other.channel);
+  }
+  bool operator!=(LoraDeviceAddress const& other) const {
+    return !(*this == other);
+  }
+
+  std::uint16_t address{kBroadcast};
+  std::uint8_t channel{0};
+};
+
+/**
+ * \brief Binds gateway device ids to LoRa addresses of device modules.
+ * Device id is the LocalPort device id, it is carried as the connection index
+ * of LoraGatewayFrame. Bound devices are sent to in fixed-point mode as
+ * unicast, so other devices' modules do not receive and decode the packet.
+ */
+class LoraDeviceRegistry {
+ public:
+  using DeviceId = std::uint8_t;
+
+  void Bind(DeviceId device_id, LoraDeviceAddress address);
+  void Unbind(DeviceId device_id);
+  std::optional<LoraDeviceAddress> Find(DeviceId device_id) const;
+  std::size_t size() const;
+
+ private:
+  std::map<DeviceId, LoraDeviceAddress> devices_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_DEVICE_REGISTRY_H_
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_duty_cycle.h"
+
+#include <array>
+#include <chrono>
+#include <algorithm>
+
+namespace ae {
+namespace {
+struct RegionChannels {
+  kLoraModuleFreqRange freq_range;
+  // frequency of channel 0
+  std::uint32_t base_khz;
+  std::uint32_t step_khz;
+};
+
+struct RegionSubBand {
+  kLoraModuleFreqRange freq_range;
+  LoraDutyCycle::SubBand sub_band;
+};
+
+// channel plans of the module variants
+constexpr std::array kRegionChannels{
+    RegionChannels{kLoraModuleFreqRange::kFREU433, 410125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFRCH470, 470125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFREU868, 850125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFRIN865, 850125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFRAU915, 900125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFRSA923, 900125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFRUS915, 900125, 1000},
+    RegionChannels{kLoraModuleFreqRange::kFRAS923, 900125, 1000},
+};
+
+// ERC recommendation 70-03 sub-bands, AS923 takes the strictest national
+// limit, other regions have no duty cycle limits
+constexpr std::array kRegionSubBands{
+    RegionSubBand{kLoraModuleFreqRange::kFREU433, {433050, 434790, 1000}},
+    RegionSubBand{kLoraModuleFreqRange::kFREU868, {863000, 868000, 100}},
+    RegionSubBand{kLoraModuleFreqRange::kFREU868, {868000, 868600, 100}},
+    RegionSubBand{kLoraModuleFreqRange::kFREU868, {868700, 869200, 10}},
+    RegionSubBand{kLoraModuleFreqRange::kFREU868, {869400, 869650, 1000}},
+    RegionSubBand{kLoraModuleFreqRange::kFREU868, {869700, 870000, 100}},
+    RegionSubBand{kLoraModuleFreqRange::kFRAS923, {915000, 928000, 100}},
+};
+
+constexpr std::uint32_t kDutyCycleScale = 10000;
+constexpr auto kObservationPeriod = std::chrono::hours{1};
+
+Duration Capacity(LoraDutyCycle::SubBand const& sub_band) {
+  return std::chrono::duration_cast<Duration>(kObservationPeriod) *
+         sub_band.duty_cycle / kDutyCycleScale;
+}
+}  // namespace
+
+LoraDutyCycle::LoraDutyCycle(kLoraModuleFreqRange freq_range)
+    : freq_range_{freq_range} {}
+
+std::uint32_t LoraDutyCycle::ChannelFrequencyKhz(
+    kLoraModuleFreqRange freq_range, std::uint8_t channel) {
+  auto it = std::find_if(
+      std::begin(kRegionChannels), std::end(kRegionChannels),
+      [&](auto const& region) { return region.freq_range == freq_range; });
+  if (it == std::end(kRegionChannels)) {
+    return 0;
+  }
+  return it->base_khz + (it->step_khz * channel);
+}
+
+std::optional<LoraDutyCycle::SubBand> LoraDutyCycle::ChannelSubBand(
+    std::uint8_t channel) const {
+  auto const frequency = ChannelFrequencyKhz(freq_range_, channel);
+
+  std::optional<SubBand> strictest;
+  for (auto const& [freq_range, sub_band] : kRegionSubBands) {
+    if (freq_range != freq_range_) {
+      continue;
+    }
+    if ((frequency >= sub_band.from_khz) && (frequency < sub_band.to_khz)) {
+      return sub_band;
+    }
+    if (!strictest || (sub_band.duty_cycle < strictest->duty_cycle)) {
+      strictest = sub_band;
+    }
+  }
+  if (strictest) {
+    // out of the listed sub-bands of the limited region, all of them share
+    // the strictest limit
+    return SubBand{0, 0, strictest->duty_cycle};
+  }
+  return std::nullopt;
+}
+
+TimePoint LoraDutyCycle::ReadyAt(std::uint8_t channel, Duration airtime,
+                                 TimePoint now) {
+  auto sub_band = ChannelSubBand(channel);
+  if (!sub_band) {
+    return now;
+  }
+  if (airtime > Capacity(*sub_band)) {
+    return TimePoint::max();
+  }
+  auto& bucket = Refill(*sub_band, now);
+  if (bucket.tokens >= airtime) {
+    return now;
+  }
+  auto const wait = (airtime - bucket.tokens) * kDutyCycleScale /
+                    sub_band->duty_cycle;
+  return now + wait;
+}
+
+bool LoraDutyCycle::Consume(std::uint8_t channel, Duration airtime,
+                            TimePoint now) {
+  auto sub_band = ChannelSubBand(channel);
+  if (!sub_band) {
+    return true;
+  }
+  auto& bucket = Refill(*sub_band, now);
+  if (bucket.tokens < airtime) {
+    return false;
+  }
+  bucket.tokens -= airtime;
+  return true;
+}
+
+LoraDutyCycle::Bucket& LoraDutyCycle::Refill(SubBand const& sub_band,
+                                             TimePoint now) {
+  auto const capacity = Capacity(sub_band);
+  // the budget is full at start
+  auto [it, inserted] =
+      buckets_.try_emplace(sub_band.from_khz, Bucket{capacity, now});
+  auto& bucket = it->second;
+  if (!inserted && (now > bucket.updated)) {
+    auto const elapsed =
+        std::chrono::duration_cast<Duration>(now - bucket.updated);
+    bucket.tokens = std::min(
+        capacity, bucket.tokens + (elapsed * sub_band.duty_cycle /
+                                   kDutyCycleScale));
+    bucket.updated = now;
+  }
+  return bucket;
+}
+}  // namespace ae
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_DUTY_CYCLE_H_
+#define LORA_GATEWAYS_LORA_DUTY_CYCLE_H_
+
+#include <map>
+#include <cstdint>
+#include <optional>
+
+#include "aether/clock.h"
+
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae {
+/**
+ * \brief Regulatory duty cycle budget of the gateway transmissions.
+ * Each sub-band of the region has a token bucket of airtime refilled at its
+ * duty cycle rate and holding up to one hour budget, the duty cycle
+ * observation period. Regions without duty cycle limits are not limited.
+ */
+class LoraDutyCycle {
+ public:
+  struct SubBand {
+    std::uint32_t from_khz;
+    std::uint32_t to_khz;
+    // allowed transmission time in 1/10000 of time
+    std::uint32_t duty_cycle;
+  };
+
+  explicit LoraDutyCycle(kLoraModuleFreqRange freq_range);
+
+  /**
+   * \brief Carrier frequency of the module channel.
+   */
+  static std::uint32_t ChannelFrequencyKhz(kLoraModuleFreqRange freq_range,
+                                           std::uint8_t channel);
+
+  /**
+   * \brief Sub-band of the channel, nullopt if it's not limited.
+   */
+  std::optional<SubBand> ChannelSubBand(std::uint8_t channel) const;
+
+  /**
+   * \brief Time point when airtime is available on the channel.
+   * TimePoint::max() if airtime never fits the budget.
+   */
+  TimePoint ReadyAt(std::uint8_t channel, Duration airtime, TimePoint now);
+  /**
+   * \brief Take airtime from the channel budget if it is available now.
+   */
+  bool Consume(std::uint8_t channel, Duration airtime, TimePoint now);
+
+ private:
+  struct Bucket {
+    Duration tokens;
+    TimePoint updated;
+  };
+
+  Bucket& Refill(SubBand const& sub_band, TimePoint now);
+
+  kLoraModuleFreqRange freq_range_;
+  // by sub-band start frequency
+  std::map<std::uint32_t, Bucket> buckets_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_DUTY_CYCLE_H_
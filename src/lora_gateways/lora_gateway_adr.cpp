@@ -0,0 +1,241 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_gateway_adr.h"
+
+#include <cmath>
+#include <bitset>
+#include <algorithm>
+
+#include "aether/tele/tele.h"
+
+namespace ae {
+namespace {
+// about one data rate or power step, dB
+constexpr float kSnrStep = 3.0F;
+constexpr int kPowerStep = 3;
+constexpr std::size_t kMaxProbeHold = 64;
+}  // namespace
+
+LoraGatewayAdr::LoraGatewayAdr(Config config,
+                               LoraGatewayPowerSaveParam const& psp)
+    : config_{config}, psp_{psp}, data_rate_{FindDataRate(psp)} {
+  config_.window = std::clamp<std::size_t>(config_.window, 1, 64);
+  config_.min_samples =
+      std::clamp<std::size_t>(config_.min_samples, 1, config_.window);
+}
+
+void LoraGatewayAdr::Attach(ILoraGatewayDriver& driver) {
+  driver_sub_ = EventSubscriber{param_changed_event_}.Subscribe(
+      [&driver](auto const& psp) { driver.SetPowerSaveParam(psp); });
+}
+
+void LoraGatewayAdr::Delivered(LinkId link, std::optional<float> snr) {
+  Report(link, true, snr);
+}
+
+void LoraGatewayAdr::Lost(LinkId link) { Report(link, false, std::nullopt); }
+
+void LoraGatewayAdr::RemoveLink(LinkId link) { links_.erase(link); }
+
+void LoraGatewayAdr::Reset(LoraGatewayPowerSaveParam const& psp) {
+  psp_ = psp;
+  data_rate_ = FindDataRate(psp);
+  for (auto& [_, stats] : links_) {
+    stats = LinkStats{};
+  }
+  probe_hold_ = 1;
+  clean_rounds_ = 0;
+  probing_ = false;
+}
+
+LoraGatewayPowerSaveParam const& LoraGatewayAdr::psp() const { return psp_; }
+
+std::size_t LoraGatewayAdr::data_rate() const { return data_rate_; }
+
+LoraGatewayAdr::ParamChangedEvent::Subscriber
+LoraGatewayAdr::param_changed_event() {
+  return EventSubscriber{param_changed_event_};
+}
+
+void LoraGatewayAdr::Report(LinkId link, bool delivered,
+                            std::optional<float> snr) {
+  auto& stats = links_[link];
+  auto const window_mask = (config_.window == 64)
+                               ? ~std::uint64_t{}
+                               : ((std::uint64_t{1} << config_.window) - 1);
+  // history bit set for the lost packet
+  stats.history = ((stats.history << 1) | (delivered ? 0 : 1)) & window_mask;
+  stats.count = std::min(stats.count + 1, config_.window);
+  if (snr) {
+    stats.max_snr = std::max(stats.max_snr.value_or(*snr), *snr);
+  }
+  Evaluate();
+}
+
+void LoraGatewayAdr::Evaluate() {
+  bool all_ready = true;
+  bool snr_known = true;
+  float worst_loss = 0.0F;
+  float min_snr = 0.0F;
+  bool first = true;
+  for (auto const& [_, stats] : links_) {
+    if (stats.count < config_.min_samples) {
+      all_ready = false;
+      continue;
+    }
+    worst_loss = std::max(worst_loss, static_cast<float>(LostCount(stats)) /
+                                          static_cast<float>(stats.count));
+    if (!stats.max_snr) {
+      snr_known = false;
+    } else {
+      min_snr = first ? *stats.max_snr : std::min(min_snr, *stats.max_snr);
+      first = false;
+    }
+  }
+
+  if (worst_loss > config_.target_loss) {
+    if (probing_) {
+      // faster data rate failed, probe it less often
+      probe_hold_ = std::min(probe_hold_ * 2, kMaxProbeHold);
+      probing_ = false;
+    }
+    StepDown();
+    return;
+  }
+  if (!all_ready || links_.empty()) {
+    return;
+  }
+
+  if (snr_known) {
+    auto const margin = min_snr - kDataRates[data_rate_].required_snr -
+                        config_.snr_margin;
+    auto const steps = static_cast<int>(std::floor(margin / kSnrStep));
+    if (steps != 0) {
+      StepUp(steps);
+    }
+    return;
+  }
+
+  // no SNR, probe faster data rate after clean rounds of delivery
+  if (probing_) {
+    probe_hold_ = std::max<std::size_t>(probe_hold_ / 2, 1);
+    probing_ = false;
+  }
+  if (worst_loss > 0.0F) {
+    return;
+  }
+  if (++clean_rounds_ < probe_hold_) {
+    // collect the next round
+    for (auto& [_, stats] : links_) {
+      stats = LinkStats{};
+    }
+    return;
+  }
+  if (data_rate_ + 1 < kDataRates.size()) {
+    probing_ = true;
+  }
+  StepUp(1);
+}
+
+void LoraGatewayAdr::StepUp(int steps) {
+  auto data_rate = data_rate_;
+  auto power = static_cast<int>(psp_.lora_gateway_power);
+  auto const min_power = static_cast<int>(config_.min_power);
+  auto const max_power = static_cast<int>(config_.max_power);
+
+  // faster data rate first, then lower power
+  while ((steps > 0) && (data_rate + 1 < kDataRates.size())) {
+    ++data_rate;
+    --steps;
+  }
+  if (steps > 0) {
+    power = std::max(power - (steps * kPowerStep), min_power);
+  }
+  // not enough margin, raise power first, then slower data rate
+  while ((steps < 0) && (power < max_power)) {
+    power = std::min(power + kPowerStep, max_power);
+    ++steps;
+  }
+  while ((steps < 0) && (data_rate > 0)) {
+    --data_rate;
+    ++steps;
+  }
+
+  if ((data_rate == data_rate_) &&
+      (power == static_cast<int>(psp_.lora_gateway_power))) {
+    return;
+  }
+  data_rate_ = data_rate;
+  psp_.lora_gateway_power = static_cast<kLoraGatewayPower>(power);
+  Apply();
+}
+
+void LoraGatewayAdr::StepDown() {
+  auto const power = static_cast<int>(psp_.lora_gateway_power);
+  auto const max_power = static_cast<int>(config_.max_power);
+  if (power < max_power) {
+    // full power is cheaper than slower data rate
+    psp_.lora_gateway_power = config_.max_power;
+  } else if (data_rate_ > 0) {
+    --data_rate_;
+  } else {
+    return;
+  }
+  Apply();
+}
+
+void LoraGatewayAdr::Apply() {
+  auto const& rate = kDataRates[data_rate_];
+  psp_.lora_gateway_spreading_factor = rate.spreading_factor;
+  psp_.lora_gateway_band_width = rate.band_width;
+  psp_.lora_gateway_coding_rate = rate.coding_rate;
+
+  // results of the previous settings are not relevant anymore
+  for (auto& [_, stats] : links_) {
+    stats = LinkStats{};
+  }
+  clean_rounds_ = 0;
+
+  AE_TELED_DEBUG("ADR data rate {} power {}", data_rate_,
+                 static_cast<int>(psp_.lora_gateway_power));
+  param_changed_event_.Emit(psp_);
+}
+
+std::size_t LoraGatewayAdr::FindDataRate(LoraGatewayPowerSaveParam const& psp) {
+  auto same = [&](DataRate const& rate) {
+    return (rate.spreading_factor == psp.lora_gateway_spreading_factor) &&
+           (rate.band_width == psp.lora_gateway_band_width);
+  };
+  auto exact = std::find_if(
+      std::begin(kDataRates), std::end(kDataRates), [&](auto const& rate) {
+        return same(rate) && (rate.coding_rate == psp.lora_gateway_coding_rate);
+      });
+  if (exact != std::end(kDataRates)) {
+    return static_cast<std::size_t>(exact - std::begin(kDataRates));
+  }
+  auto similar =
+      std::find_if(std::begin(kDataRates), std::end(kDataRates), same);
+  if (similar != std::end(kDataRates)) {
+    return static_cast<std::size_t>(similar - std::begin(kDataRates));
+  }
+  return 0;
+}
+
+std::size_t LoraGatewayAdr::LostCount(LinkStats const& stats) const {
+  return std::bitset<64>{stats.history}.count();
+}
+}  // namespace ae
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_GATEWAY_ADR_H_
+#define LORA_GATEWAYS_LORA_GATEWAY_ADR_H_
+
+#include <map>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "aether/events/events.h"
+
+#include "lora_gateways/ilora_gateway_driver.h"
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae {
+/**
+ * \brief Adaptive data rate of the gateway radio.
+ * Tracks delivery and SNR of each link and steps the radio settings through
+ * the data rate ladder to the fastest one keeping the loss of the worst link
+ * under the target. Power is raised before the data rate is lowered and is
+ * lowered once the fastest data rate is reached.
+ * If no SNR is reported, faster data rates are probed after clean rounds of
+ * delivery, failed probes double the number of rounds before the next one.
+ */
+class LoraGatewayAdr {
+ public:
+  using LinkId = std::uint16_t;
+  using ParamChangedEvent = Event<void(LoraGatewayPowerSaveParam const& psp)>;
+
+  struct Config {
+    // allowed loss ratio of the worst link
+    float target_loss{0.1F};
+    // SNR reserved above the demodulation floor, dB
+    float snr_margin{10.0F};
+    // delivery results kept for each link, up to 64
+    std::size_t window{32};
+    // results required on each link to make a decision
+    std::size_t min_samples{16};
+    kLoraGatewayPower min_power{kLoraGatewayPower::kPower2};
+    kLoraGatewayPower max_power{kLoraGatewayPower::kPower22};
+  };
+
+  struct DataRate {
+    kLoraGatewaySpreadingFactor spreading_factor;
+    kLoraGatewayBandWidth band_width;
+    kLoraGatewayCodingRate coding_rate;
+    // demodulation floor, dB
+    float required_snr;
+  };
+
+  // from the slowest to the fastest
+  static constexpr std::array kDataRates{
+      DataRate{kLoraGatewaySpreadingFactor::kSF12,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_8, -20.0F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF12,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_6, -20.0F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF11,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_5, -17.5F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF10,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_5, -15.0F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF9,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_5, -12.5F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF8,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_5, -10.0F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF7,
+               kLoraGatewayBandWidth::kBandWidth125K,
+               kLoraGatewayCodingRate::kCR4_5, -7.5F},
+      // SNR is measured in the channel bandwidth, twice wider channel takes
+      // twice more noise
+      DataRate{kLoraGatewaySpreadingFactor::kSF7,
+               kLoraGatewayBandWidth::kBandWidth250K,
+               kLoraGatewayCodingRate::kCR4_5, -4.5F},
+      DataRate{kLoraGatewaySpreadingFactor::kSF7,
+               kLoraGatewayBandWidth::kBandWidth500K,
+               kLoraGatewayCodingRate::kCR4_5, -1.5F},
+  };
+
+  LoraGatewayAdr(Config config, LoraGatewayPowerSaveParam const& psp);
+
+  /**
+   * \brief Apply each change to the driver with SetPowerSaveParam.
+   */
+  void Attach(ILoraGatewayDriver& driver);
+
+  /**
+   * \brief Packet on link is delivered, snr is reported by the radio if any.
+   */
+  void Delivered(LinkId link, std::optional<float> snr = std::nullopt);
+  /**
+   * \brief Packet on link is lost.
+   */
+  void Lost(LinkId link);
+  void RemoveLink(LinkId link);
+  /**
+   * \brief Start over from psp set by the operator, e.g. on config reload.
+   * The change is not emitted, the driver is configured with psp already.
+   */
+  void Reset(LoraGatewayPowerSaveParam const& psp);
+
+  LoraGatewayPowerSaveParam const& psp() const;
+  std::size_t data_rate() const;
+
+  ParamChangedEvent::Subscriber param_changed_event();
+
+ private:
+  struct LinkStats {
+    // bit set for each lost packet, the newest is the lowest bit
+    std::uint64_t history{};
+    std::size_t count{};
+    std::optional<float> max_snr;
+  };
+
+  void Report(LinkId link, bool delivered, std::optional<float> snr);
+  void Evaluate();
+  /**
+   * \brief Move by steps of SNR margin, negative steps if it's not enough.
+   */
+  void StepUp(int steps);
+  void StepDown();
+  void Apply();
+
+  static std::size_t FindDataRate(LoraGatewayPowerSaveParam const& psp);
+  std::size_t LostCount(LinkStats const& stats) const;
+
+  Config config_;
+  LoraGatewayPowerSaveParam psp_;
+  std::size_t data_rate_;
+  std::map<LinkId, LinkStats> links_;
+  // clean rounds required before probing faster data rate without SNR
+  std::size_t probe_hold_{1};
+  std::size_t clean_rounds_{};
+  bool probing_{};
+  ParamChangedEvent param_changed_event_;
+  Subscription driver_sub_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_GATEWAY_ADR_H_
@@ -17,16 +17,42 @@
 #include "lora_gateways/lora_gateway_factory.h"
 
 #include "lora_gateways/dx_smart_lr02_gw.h"
+#include "lora_gateways/multi_lora_gateway.h"
 
 namespace ae {
 
 std::unique_ptr<ILoraGatewayDriver> LoraGatewayDriverFactory::CreateLoraGateway(
     ActionContext action_context, IPoller::ptr const& poller,
-    LoraGatewayInit lora_gateway_init) {
+    LoraGatewayInit lora_gateway_init, gw::MetricsRegistry* metrics) {
 #if AE_LORA_GATEWAY_DXSMART_LR02_ENABLED == 1
-  return std::make_unique<DxSmartLr02LoraGateway>(action_context, poller,
-                                                  std::move(lora_gateway_init));
+  auto driver = std::make_unique<DxSmartLr02LoraGateway>(
+      action_context, poller, std::move(lora_gateway_init));
+  if (metrics != nullptr) {
+    driver->SetMetrics(*metrics);
+  }
+  return driver;
 #endif
 }
 
+std::unique_ptr<ILoraGatewayDriver> LoraGatewayDriverFactory::CreateLoraGateway(
+    ActionContext action_context, IPoller::ptr const& poller,
+    std::vector<LoraGatewayInit> lora_gateway_inits,
+    gw::MetricsRegistry* metrics) {
+  if (lora_gateway_inits.size() == 1) {
+    return CreateLoraGateway(action_context, poller,
+                             std::move(lora_gateway_inits.front()), metrics);
+  }
+
+  std::vector<MultiLoraGateway::RadioInit> radios;
+  radios.reserve(lora_gateway_inits.size());
+  for (auto& lora_gateway_init : lora_gateway_inits) {
+    auto const channel = lora_gateway_init.lora_gateway_channel;
+    radios.push_back(MultiLoraGateway::RadioInit{
+        CreateLoraGateway(action_context, poller, std::move(lora_gateway_init),
+                          metrics),
+        channel});
+  }
+  return std::make_unique<MultiLoraGateway>(action_context, std::move(radios));
+}
+
 }  // namespace ae
@@ -18,11 +18,14 @@
 #define LORA_GATEWAYS_LORA_GATEWAY_FACTORY_H_
 
 #include <memory>
+#include <vector>
 
 #include "aether/poller/poller.h"
 #include "aether/actions/action_context.h"
 #include "lora_gateways/ilora_gateway_driver.h"
 
+#include "gateway/metrics_registry.h"
+
 #define AE_LORA_GATEWAY_DXSMART_LR02_ENABLED 1
 
 // check if any mode is enabled
@@ -32,9 +35,20 @@
 namespace ae {
 class LoraGatewayDriverFactory {
  public:
+  /**
+   * \brief Driver of the radio module, reporting to metrics if provided.
+   */
+  static std::unique_ptr<ILoraGatewayDriver> CreateLoraGateway(
+      ActionContext action_context, IPoller::ptr const& poller,
+      LoraGatewayInit lora_gateway_init,
+      gw::MetricsRegistry* metrics = nullptr);
+  /**
+   * \brief Gateway over several radio modules, one for each init.
+   */
   static std::unique_ptr<ILoraGatewayDriver> CreateLoraGateway(
       ActionContext action_context, IPoller::ptr const& poller,
-      LoraGatewayInit lora_gateway_init);
+      std::vector<LoraGatewayInit> lora_gateway_inits,
+      gw::MetricsRegistry* metrics = nullptr);
 };
 }  // namespace ae
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_gateway_frame.h"
+
+#include <algorithm>
+
+#include "lora_gateways/lora_crc32.h"
+
+namespace ae {
+DataBuffer LoraGatewayFrame::Encode(LoraGatewayPacket const& packet) {
+  auto const length = static_cast<std::uint16_t>(packet.data.size());
+
+  auto frame = DataBuffer{};
+  frame.reserve(kHeaderSize + packet.data.size() + kCrcSize);
+  frame.push_back(kSync0);
+  frame.push_back(kSync1);
+  frame.push_back(static_cast<std::uint8_t>(packet.connection.connect_index));
+  frame.push_back(static_cast<std::uint8_t>(length & 0xFF));
+  frame.push_back(static_cast<std::uint8_t>(length >> 8));
+  frame.push_back(HeaderCheck(frame.data()));
+  frame.insert(std::end(frame), std::begin(packet.data),
+               std::end(packet.data));
+  auto const crc =
+      Crc(frame.data(), frame.data() + kHeaderSize, packet.data.size());
+  for (std::size_t i = 0; i < kCrcSize; ++i) {
+    frame.push_back(static_cast<std::uint8_t>(crc >> (8 * i)));
+  }
+  return frame;
+}
+
+std::uint8_t LoraGatewayFrame::HeaderCheck(std::uint8_t const* header) {
+  return static_cast<std::uint8_t>(~(header[2] ^ header[3] ^ header[4]));
+}
+
+std::uint32_t LoraGatewayFrame::Crc(std::uint8_t const* header,
+                                    std::uint8_t const* data,
+                                    std::size_t size) {
+  // connection and length bytes, then data
+  auto const crc = LoraCrc32::Calculate(header + 2, 3);
+  return LoraCrc32::Calculate(data, size, crc);
+}
+
+LoraGatewayFrameDecoder::LoraGatewayFrameDecoder(std::size_t max_data_size)
+    : max_data_size_{max_data_size} {}
+
+void LoraGatewayFrameDecoder::Push(DataBuffer const& data) {
+  buffer_.insert(std::end(buffer_), std::begin(data), std::end(data));
+
+  auto res = DecodeOne();
+  while (res != DecodeResult::kNeedMore) {
+    res = DecodeOne();
+  }
+
+  // compact consumed bytes
+  if (pos_ == buffer_.size()) {
+    buffer_.clear();
+    pos_ = 0;
+  } else if (pos_ > (buffer_.size() / 2)) {
+    buffer_.erase(std::begin(buffer_),
+                  std::begin(buffer_) + static_cast<std::ptrdiff_t>(pos_));
+    pos_ = 0;
+  }
+}
+
+void LoraGatewayFrameDecoder::Reset() {
+  buffer_.clear();
+  pos_ = 0;
+}
+
+LoraGatewayFrameDecoder::PacketEvent::Subscriber
+LoraGatewayFrameDecoder::packet_event() {
+  return EventSubscriber{packet_event_};
+}
+
+std::size_t LoraGatewayFrameDecoder::crc_errors() const { return crc_errors_; }
+
+LoraGatewayFrameDecoder::DecodeResult LoraGatewayFrameDecoder::DecodeOne() {
+  auto const begin = std::begin(buffer_) + static_cast<std::ptrdiff_t>(pos_);
+  // search for the sync word
+  auto sync = std::find(begin, std::end(buffer_), LoraGatewayFrame::kSync0);
+  pos_ = static_cast<std::size_t>(sync - std::begin(buffer_));
+
+  auto const available = buffer_.size() - pos_;
+  if (available < LoraGatewayFrame::kHeaderSize) {
+    return DecodeResult::kNeedMore;
+  }
+
+  auto const* header = buffer_.data() + pos_;
+  auto const length = static_cast<std::size_t>(header[3]) |
+                      (static_cast<std::size_t>(header[4]) << 8);
+  if ((header[1] != LoraGatewayFrame::kSync1) ||
+      (header[5] != LoraGatewayFrame::HeaderCheck(header)) ||
+      (length > max_data_size_)) {
+    // not a frame start, resync from the next byte
+    ++pos_;
+    return DecodeResult::kSkip;
+  }
+
+  auto const frame_size =
+      LoraGatewayFrame::kHeaderSize + length + LoraGatewayFrame::kCrcSize;
+  if (available < frame_size) {
+    return DecodeResult::kNeedMore;
+  }
+
+  auto const* data = header + LoraGatewayFrame::kHeaderSize;
+  auto const* crc_bytes = data + length;
+  std::uint32_t crc = 0;
+  for (std::size_t i = 0; i < LoraGatewayFrame::kCrcSize; ++i) {
+    crc |= static_cast<std::uint32_t>(crc_bytes[i]) << (8 * i);
+  }
+  if (crc != LoraGatewayFrame::Crc(header, data, length)) {
+    // corrupted frame or a false sync, resync from the next byte
+    ++crc_errors_;
+    ++pos_;
+    return DecodeResult::kSkip;
+  }
+
+  LoraGatewayPacket packet{};
+  packet.connection.connect_index =
+      static_cast<ConnectionLoraGatewayIndex>(header[2]);
+  packet.length = length;
+  packet.data = DataBuffer{data, data + length};
+  packet.crc = crc;
+  pos_ += frame_size;
+
+  packet_event_.Emit(packet);
+  return DecodeResult::kFrame;
+}
+}  // namespace ae
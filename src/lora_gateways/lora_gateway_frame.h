@@ -0,0 +1,87 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_GATEWAY_FRAME_H_
+#define LORA_GATEWAYS_LORA_GATEWAY_FRAME_H_
+
+#include <cstdint>
+
+#include "aether/events/events.h"
+#include "aether/types/data_buffer.h"
+
+#include "lora_gateways/lora_gateway_driver_types.h"
+
+namespace ae {
+/**
+ * \brief Serial frame of LoraGatewayPacket for transparent transmission.
+ * 0xA5 0x5A connection length_low length_high header_check data crc32
+ * header_check is inverted xor of connection and length bytes.
+ * crc32 is little endian LoraCrc32 of connection, length and data bytes.
+ */
+class LoraGatewayFrame {
+ public:
+  static constexpr std::uint8_t kSync0 = 0xA5;
+  static constexpr std::uint8_t kSync1 = 0x5A;
+  static constexpr std::size_t kHeaderSize = 6;
+  static constexpr std::size_t kCrcSize = 4;
+
+  static DataBuffer Encode(LoraGatewayPacket const& packet);
+  static std::uint8_t HeaderCheck(std::uint8_t const* header);
+  static std::uint32_t Crc(std::uint8_t const* header,
+                           std::uint8_t const* data, std::size_t size);
+};
+
+/**
+ * \brief Incremental decoder of LoraGatewayFrame from the serial byte stream.
+ * Garbage and broken frames are skipped by searching for the next sync word.
+ * Frames with a wrong crc are dropped and counted.
+ */
+class LoraGatewayFrameDecoder {
+ public:
+  using PacketEvent = Event<void(LoraGatewayPacket const& packet)>;
+
+  explicit LoraGatewayFrameDecoder(std::size_t max_data_size);
+
+  /**
+   * \brief Push received bytes, packet_event is emitted for each whole frame.
+   */
+  void Push(DataBuffer const& data);
+  /**
+   * \brief Drop partially received frame.
+   */
+  void Reset();
+
+  PacketEvent::Subscriber packet_event();
+  std::size_t crc_errors() const;
+
+ private:
+  enum class DecodeResult : std::uint8_t {
+    kFrame,
+    kSkip,
+    kNeedMore,
+  };
+
+  DecodeResult DecodeOne();
+
+  std::size_t max_data_size_;
+  DataBuffer buffer_;
+  std::size_t pos_{};
+  std::size_t crc_errors_{};
+  PacketEvent packet_event_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_GATEWAY_FRAME_H_
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/lora_operation_queue.h"
+
+#include <algorithm>
+
+namespace ae {
+namespace {
+// a lower priority operation is run first after waiting so long
+constexpr std::array<Duration, LoraOperationQueue::kLanes> kMaxWait{
+    std::chrono::seconds{1},
+    std::chrono::seconds{2},
+    std::chrono::seconds{10},
+};
+
+// a running operation keeps the queue so long before yielding
+constexpr Duration kTimeSlice = std::chrono::milliseconds{500};
+
+constexpr std::size_t Index(LoraOperationQueue::Lane lane) {
+  return static_cast<std::size_t>(lane);
+}
+}  // namespace
+
+LoraOperationQueue::LoraOperationQueue(ActionContext action_context)
+    : Action{action_context} {}
+
+UpdateStatus LoraOperationQueue::Update() {
+  auto const now = Now();
+  if (running_done_) {
+    running_done_ = false;
+    // a long operation gives its turn to other lanes
+    turn_passed_ = ((now - started_at_) >= kTimeSlice)
+                       ? running_
+                       : std::optional<Lane>{};
+    running_sub_.Reset();
+    running_entry_.reset();
+    running_.reset();
+  }
+
+  while (!running_) {
+    auto lane = Select(now);
+    if (!lane) {
+      break;
+    }
+    auto& queue = lanes_[Index(*lane)];
+    running_entry_.emplace(std::move(queue.front()));
+    queue.pop_front();
+    CountWait(*lane, std::chrono::duration_cast<Duration>(
+                         now - running_entry_->pushed_at));
+
+    running_ = lane;
+    started_at_ = now;
+    turn_passed_.reset();
+    running_sub_ = running_entry_->start([this]() {
+      running_done_ = true;
+      Action::Trigger();
+    });
+    // nothing to run for the operation
+    if (running_done_) {
+      running_done_ = false;
+      running_sub_.Reset();
+      running_entry_.reset();
+      running_.reset();
+    }
+  }
+  return {};
+}
+
+void LoraOperationQueue::Hold(Lane lane) { held_[Index(lane)] = true; }
+
+void LoraOperationQueue::Release(Lane lane) {
+  held_[Index(lane)] = false;
+  Action::Trigger();
+}
+
+bool LoraOperationQueue::ShouldYield() const {
+  if (!running_) {
+    return false;
+  }
+  auto const now = Now();
+  if ((now - started_at_) < kTimeSlice) {
+    return false;
+  }
+  for (std::size_t i = 0; i < kLanes; ++i) {
+    if ((i != Index(*running_)) && !held_[i] && !lanes_[i].empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+LoraOperationQueue::LaneStats const& LoraOperationQueue::stats(
+    Lane lane) const {
+  return stats_[Index(lane)];
+}
+
+void LoraOperationQueue::PushEntry(Lane lane, Start start) {
+  lanes_[Index(lane)].push_back(Entry{std::move(start), Now()});
+  Action::Trigger();
+}
+
+std::optional<LoraOperationQueue::Lane> LoraOperationQueue::Select(
+    TimePoint now) const {
+  std::optional<Lane> selected;
+  // the longest overdue operation, then the highest priority one
+  auto overdue = Duration::zero();
+  for (std::size_t i = 0; i < kLanes; ++i) {
+    if (held_[i] || lanes_[i].empty()) {
+      continue;
+    }
+    auto const wait = std::chrono::duration_cast<Duration>(
+        now - lanes_[i].front().pushed_at);
+    if ((wait - kMaxWait[i]) > overdue) {
+      overdue = wait - kMaxWait[i];
+      selected = static_cast<Lane>(i);
+    }
+  }
+  if (selected) {
+    return selected;
+  }
+  for (std::size_t i = 0; i < kLanes; ++i) {
+    if (!held_[i] && !lanes_[i].empty() &&
+        (!turn_passed_ || (Index(*turn_passed_) != i))) {
+      return static_cast<Lane>(i);
+    }
+  }
+  if (turn_passed_ && !held_[Index(*turn_passed_)] &&
+      !lanes_[Index(*turn_passed_)].empty()) {
+    return turn_passed_;
+  }
+  return std::nullopt;
+}
+
+void LoraOperationQueue::CountWait(Lane lane, Duration wait) {
+  auto& stats = stats_[Index(lane)];
+  ++stats.operations;
+  stats.max_wait = std::max(stats.max_wait, wait);
+
+  auto const ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(wait).count();
+  std::size_t bucket = 0;
+  while ((bucket < (kWaitBuckets - 1)) && (ms >= (std::int64_t{1} << bucket))) {
+    ++bucket;
+  }
+  ++stats.wait_histogram[bucket];
+}
+}  // namespace ae
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_LORA_OPERATION_QUEUE_H_
+#define LORA_GATEWAYS_LORA_OPERATION_QUEUE_H_
+
+#include <array>
+#include <deque>
+#include <utility>
+#include <optional>
+#include <functional>
+
+#include "aether/all.h"
+
+namespace ae {
+/**
+ * \brief Queue of radio operations with priority lanes.
+ * Operations run one at a time, the next one is selected from the highest
+ * priority lane when the running one is finished, so a waiting operation
+ * never runs behind the lower priority ones queued before it. An operation
+ * waiting longer than its lane max wait is run first to avoid starvation.
+ * Long running operations check ShouldYield at their preemption points, the
+ * lane of an operation running longer than the time slice is served after
+ * the other lanes next time.
+ */
+class LoraOperationQueue final : public Action<LoraOperationQueue> {
+ public:
+  // in priority order
+  enum class Lane : std::uint8_t {
+    kData,
+    kControl,
+    kMaintenance,
+  };
+  static constexpr std::size_t kLanes = 3;
+  static constexpr std::size_t kWaitBuckets = 16;
+
+  struct LaneStats {
+    std::size_t operations{};
+    Duration max_wait{};
+    // bucket i counts waits shorter than 2^i ms, the last one counts the rest
+    std::array<std::size_t, kWaitBuckets> wait_histogram{};
+  };
+
+  explicit LoraOperationQueue(ActionContext action_context);
+
+  /**
+   * \brief Push operation made by factory when it's time to run.
+   * Factory returns the action of the operation or an empty ActionPtr if
+   * there is nothing to run.
+   */
+  template <typename TFactory>
+  void Push(Lane lane, TFactory&& factory) {
+    PushEntry(lane, [factory{std::forward<TFactory>(factory)},
+                     action = decltype(factory()){}](Done done) mutable {
+      action = factory();
+      if (!action) {
+        done();
+        return Subscription{};
+      }
+      return Subscription{action->StatusEvent().Subscribe(ActionHandler{
+          OnResult{[done]() { done(); }},
+          OnError{[done]() { done(); }},
+          OnStop{[done]() { done(); }},
+      })};
+    });
+  }
+
+  UpdateStatus Update();
+
+  /**
+   * \brief Don't run operations of the lane until it's released.
+   */
+  void Hold(Lane lane);
+  void Release(Lane lane);
+
+  /**
+   * \brief The running operation should finish at its next preemption point.
+   * True if an operation of another lane waits longer than the time slice.
+   */
+  bool ShouldYield() const;
+
+  LaneStats const& stats(Lane lane) const;
+
+ private:
+  using Done = std::function<void()>;
+  using Start = std::function<Subscription(Done done)>;
+
+  struct Entry {
+    Start start;
+    TimePoint pushed_at;
+  };
+
+  void PushEntry(Lane lane, Start start);
+  std::optional<Lane> Select(TimePoint now) const;
+  void CountWait(Lane lane, Duration wait);
+
+  std::array<std::deque<Entry>, kLanes> lanes_;
+  std::array<bool, kLanes> held_{};
+  std::array<LaneStats, kLanes> stats_{};
+  std::optional<Lane> running_;
+  // keeps the running operation alive
+  std::optional<Entry> running_entry_;
+  Subscription running_sub_;
+  TimePoint started_at_;
+  bool running_done_{};
+  // lane of the previous operation if it ran longer than the time slice
+  std::optional<Lane> turn_passed_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_LORA_OPERATION_QUEUE_H_
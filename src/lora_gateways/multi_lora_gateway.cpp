@@ -0,0 +1,298 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lora_gateways/multi_lora_gateway.h"
+
+#include <tuple>
+#include <utility>
+
+#include "aether/lora_modules/lora_modules_tele.h"
+
+namespace ae {
+MultiLoraGateway::MultiLoraGateway(ActionContext action_context,
+                                   std::vector<RadioInit> radios)
+    : action_context_{action_context} {
+  radios_.reserve(radios.size());
+  for (auto& radio : radios) {
+    radios_.push_back(Radio{std::move(radio.driver), radio.channel, 0, {}});
+  }
+  for (std::size_t i = 0; i < radios_.size(); ++i) {
+    radios_[i].data_sub = radios_[i].driver->data_event().Subscribe(
+        [this, i](auto connect_index, auto const& data) {
+          // the device is heard by this radio
+          auto& route = routes_[RouteKey{i, connect_index}];
+          route.updated_at = Now();
+          route.heard = true;
+          data_event_.Emit(connect_index, data);
+        });
+  }
+}
+
+MultiLoraGateway::~MultiLoraGateway() = default;
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation> MultiLoraGateway::Start() {
+  return ForAll([](auto& driver) { return driver.Start(); });
+}
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation> MultiLoraGateway::Stop() {
+  return ForAll([](auto& driver) { return driver.Stop(); });
+}
+
+ActionPtr<MultiLoraGateway::OpenNetworkOperation>
+MultiLoraGateway::OpenNetwork(Protocol protocol, std::string const& host,
+                              std::uint16_t port) {
+  auto open_network_operation =
+      ActionPtr<OpenNetworkOperation>{action_context_};
+  if (radios_.empty()) {
+    open_network_operation->Reject();
+    return open_network_operation;
+  }
+
+  auto const radio = LeastLoaded(std::nullopt);
+  auto radio_operation =
+      radios_[radio].driver->OpenNetwork(protocol, host, port);
+  if (!radio_operation) {
+    open_network_operation->Reject();
+    return open_network_operation;
+  }
+  radio_operation->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, radio, open_network_operation](auto const& action) {
+        auto& route = routes_[RouteKey{radio, action.value()}];
+        route.updated_at = Now();
+        route.opened = true;
+        open_network_operation->SetValue(action.value());
+      }},
+      OnError{[open_network_operation]() { open_network_operation->Reject(); }},
+      OnStop{[open_network_operation]() { open_network_operation->Reject(); }},
+  });
+  return open_network_operation;
+}
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation>
+MultiLoraGateway::CloseNetwork(ConnectionLoraGatewayIndex connect_index) {
+  std::optional<std::size_t> opened_radio;
+  for (auto it = std::begin(routes_); it != std::end(routes_);) {
+    if (it->first.second != connect_index) {
+      ++it;
+      continue;
+    }
+    if (it->second.opened) {
+      opened_radio = it->first.first;
+    }
+    it = routes_.erase(it);
+  }
+  if (!opened_radio) {
+    return {};
+  }
+  return radios_[*opened_radio].driver->CloseNetwork(connect_index);
+}
+
+ActionPtr<MultiLoraGateway::WriteOperation> MultiLoraGateway::WritePacket(
+    ConnectionLoraGatewayIndex connect_index, DataBuffer const& data) {
+  if (radios_.empty()) {
+    auto write_operation = ActionPtr<WriteOperation>{action_context_};
+    write_operation->Failed();
+    return write_operation;
+  }
+
+  auto const radio = SelectRoute(connect_index);
+  auto write_operation =
+      radios_[radio].driver->WritePacket(connect_index, data);
+  if (!write_operation) {
+    return write_operation;
+  }
+
+  radios_[radio].load++;
+  auto done = [this, radio]() { radios_[radio].load--; };
+  write_operation->StatusEvent().Subscribe(
+      ActionHandler{OnResult{done}, OnError{done}, OnStop{done}});
+  return write_operation;
+}
+
+MultiLoraGateway::DataEvent::Subscriber MultiLoraGateway::data_event() {
+  return EventSubscriber{data_event_};
+}
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation> MultiLoraGateway::Configure(
+    LoraGatewayInit const& lora_gateway_init) {
+  auto operations = std::vector<ActionPtr<LoraGatewayOperation>>{};
+  operations.reserve(radios_.size());
+  for (auto& radio : radios_) {
+    auto radio_init = lora_gateway_init;
+    radio_init.lora_gateway_channel = radio.channel;
+    operations.push_back(radio.driver->Configure(radio_init));
+  }
+  return AllOf(std::move(operations));
+}
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation>
+MultiLoraGateway::SetPowerSaveParam(LoraGatewayPowerSaveParam const& psp) {
+  return ForAll([&](auto& driver) { return driver.SetPowerSaveParam(psp); });
+}
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation> MultiLoraGateway::PowerOff() {
+  return ForAll([](auto& driver) { return driver.PowerOff(); });
+}
+
+void MultiLoraGateway::BindDevice(std::uint8_t device_id,
+                                  LoraDeviceAddress const& address) {
+  device_channels_[device_id] = address.channel;
+  bool bound = false;
+  for (auto& radio : radios_) {
+    if (radio.channel == address.channel) {
+      radio.driver->BindDevice(device_id, address);
+      bound = true;
+    }
+  }
+  if (!bound) {
+    AE_TELED_WARNING("No radio on channel {} of device {}",
+                     static_cast<int>(address.channel),
+                     static_cast<int>(device_id));
+    for (auto& radio : radios_) {
+      radio.driver->BindDevice(device_id, address);
+    }
+  }
+}
+
+std::size_t MultiLoraGateway::radio_count() const { return radios_.size(); }
+
+std::size_t MultiLoraGateway::SelectRoute(
+    ConnectionLoraGatewayIndex connect_index) {
+  auto const now = Now();
+  ExpireRoutes(now);
+
+  // opened route first, then the radio heard the connection last
+  auto best = std::end(routes_);
+  auto const rank = [](Route const& route) {
+    return std::tuple{route.opened, route.heard, route.updated_at};
+  };
+  for (auto it = std::begin(routes_); it != std::end(routes_); ++it) {
+    if (it->first.second != connect_index) {
+      continue;
+    }
+    if ((best == std::end(routes_)) ||
+        (rank(best->second) < rank(it->second))) {
+      best = it;
+    }
+  }
+  if (best != std::end(routes_)) {
+    return best->first.first;
+  }
+
+  // the device is heard by no radio yet, use the idle one on its channel
+  std::optional<std::uint8_t> channel;
+  auto device_it =
+      device_channels_.find(static_cast<std::uint8_t>(connect_index));
+  if (device_it != std::end(device_channels_)) {
+    channel = device_it->second;
+  }
+  auto const radio = LeastLoaded(channel);
+  routes_.emplace(RouteKey{radio, connect_index}, Route{now, false, false});
+  AE_TELED_DEBUG("Route connection {} to radio {}",
+                 static_cast<int>(connect_index), radio);
+  return radio;
+}
+
+void MultiLoraGateway::ExpireRoutes(TimePoint now) {
+  for (auto it = std::begin(routes_); it != std::end(routes_);) {
+    auto const expired = (it->second.updated_at + kRouteTimeout) <= now;
+    if (!it->second.opened && expired) {
+      it = routes_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::size_t MultiLoraGateway::LeastLoaded(
+    std::optional<std::uint8_t> channel) {
+  auto const on_channel = [&](std::size_t i) {
+    return !channel || (radios_[i].channel == *channel);
+  };
+  // round robin among equally loaded radios
+  std::optional<std::size_t> best;
+  for (std::size_t n = 0; n < radios_.size(); ++n) {
+    auto const i = (next_radio_ + n) % radios_.size();
+    if (!on_channel(i)) {
+      continue;
+    }
+    if (!best || (radios_[i].load < radios_[*best].load)) {
+      best = i;
+    }
+  }
+  if (!best && channel) {
+    // no radio on the channel, the device may still hear the others
+    return LeastLoaded(std::nullopt);
+  }
+  next_radio_ = best.value_or(0) + 1;
+  return best.value_or(0);
+}
+
+template <typename Func>
+ActionPtr<MultiLoraGateway::LoraGatewayOperation> MultiLoraGateway::ForAll(
+    Func&& func) {
+  std::vector<ActionPtr<LoraGatewayOperation>> operations;
+  operations.reserve(radios_.size());
+  for (auto& radio : radios_) {
+    operations.emplace_back(func(*radio.driver));
+  }
+  return AllOf(std::move(operations));
+}
+
+ActionPtr<MultiLoraGateway::LoraGatewayOperation> MultiLoraGateway::AllOf(
+    std::vector<ActionPtr<LoraGatewayOperation>> operations) {
+  struct State {
+    std::size_t pending;
+    bool failed;
+    bool stopped;
+  };
+
+  auto all_operation = ActionPtr<LoraGatewayOperation>{action_context_};
+  auto state = std::make_shared<State>(State{operations.size() + 1, {}, {}});
+  auto done = [state, all_operation]() {
+    if (--state->pending != 0) {
+      return;
+    }
+    if (state->failed) {
+      all_operation->Failed();
+    } else if (state->stopped) {
+      all_operation->Stop();
+    } else {
+      all_operation->Notify();
+    }
+  };
+
+  for (auto& operation : operations) {
+    // radio has nothing to do
+    if (!operation) {
+      done();
+      continue;
+    }
+    operation->StatusEvent().Subscribe(ActionHandler{
+        OnResult{done}, OnError{[state, done]() {
+          state->failed = true;
+          done();
+        }},
+        OnStop{[state, done]() {
+          state->stopped = true;
+          done();
+        }}});
+  }
+  // all the operations are subscribed
+  done();
+  return all_operation;
+}
+}  // namespace ae
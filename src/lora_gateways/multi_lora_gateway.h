@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LORA_GATEWAYS_MULTI_LORA_GATEWAY_H_
+#define LORA_GATEWAYS_MULTI_LORA_GATEWAY_H_
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <optional>
+
+#include "aether/clock.h"
+#include "aether/actions/action_context.h"
+
+#include "lora_gateways/ilora_gateway_driver.h"
+
+namespace ae {
+/**
+ * \brief Gateway driver over several radio modules working concurrently.
+ * Each module has its own serial port and channel. Routes are kept for each
+ * radio and connection, a connection is written through the radio it was
+ * opened on or last heard by. A connection not heard yet goes to the least
+ * loaded radio on the channel of its bound device, or on any channel if the
+ * device is not bound. Routes not opened by OpenNetwork expire after
+ * kRouteTimeout without data. Data events of all modules are aggregated.
+ */
+class MultiLoraGateway final : public ILoraGatewayDriver {
+ public:
+  static constexpr Duration kRouteTimeout = std::chrono::minutes{10};
+
+  struct RadioInit {
+    std::unique_ptr<ILoraGatewayDriver> driver;
+    // channel the module is configured to
+    std::uint8_t channel;
+  };
+
+  MultiLoraGateway(ActionContext action_context,
+                   std::vector<RadioInit> radios);
+  ~MultiLoraGateway() override;
+
+  ActionPtr<LoraGatewayOperation> Start() override;
+  ActionPtr<LoraGatewayOperation> Stop() override;
+  ActionPtr<OpenNetworkOperation> OpenNetwork(Protocol protocol,
+                                              std::string const& host,
+                                              std::uint16_t port) override;
+  ActionPtr<LoraGatewayOperation> CloseNetwork(
+      ConnectionLoraGatewayIndex connect_index) override;
+  ActionPtr<WriteOperation> WritePacket(
+      ConnectionLoraGatewayIndex connect_index,
+      DataBuffer const& data) override;
+
+  DataEvent::Subscriber data_event() override;
+
+  /**
+   * \brief Each radio keeps its own channel, the other settings are common.
+   */
+  ActionPtr<LoraGatewayOperation> Configure(
+      LoraGatewayInit const& lora_gateway_init) override;
+  ActionPtr<LoraGatewayOperation> SetPowerSaveParam(
+      LoraGatewayPowerSaveParam const& psp) override;
+  ActionPtr<LoraGatewayOperation> PowerOff() override;
+  /**
+   * \brief The device is bound on the radios on its channel, on all the
+   * radios if there is none.
+   */
+  void BindDevice(std::uint8_t device_id,
+                  LoraDeviceAddress const& address) override;
+
+  std::size_t radio_count() const;
+
+ private:
+  struct Radio {
+    std::unique_ptr<ILoraGatewayDriver> driver;
+    std::uint8_t channel;
+    // writes in progress
+    std::size_t load;
+    Subscription data_sub;
+  };
+
+  struct Route {
+    // last time the connection was heard by the radio or routed to it
+    TimePoint updated_at;
+    bool heard;
+    // opened on the radio by OpenNetwork, kept until CloseNetwork
+    bool opened;
+  };
+  using RouteKey = std::pair<std::size_t, ConnectionLoraGatewayIndex>;
+
+  std::size_t SelectRoute(ConnectionLoraGatewayIndex connect_index);
+  void ExpireRoutes(TimePoint now);
+  std::size_t LeastLoaded(std::optional<std::uint8_t> channel);
+
+  template <typename Func>
+  ActionPtr<LoraGatewayOperation> ForAll(Func&& func);
+  ActionPtr<LoraGatewayOperation> AllOf(
+      std::vector<ActionPtr<LoraGatewayOperation>> operations);
+
+  ActionContext action_context_;
+  std::vector<Radio> radios_;
+  std::map<RouteKey, Route> routes_;
+  // channel of each bound device
+  std::map<std::uint8_t, std::uint8_t> device_channels_;
+  std::size_t next_radio_{};
+  DataEvent data_event_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_MULTI_LORA_GATEWAY_H_
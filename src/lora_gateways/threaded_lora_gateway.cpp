@@ -0,0 +1,314 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "lora_gateways/threaded_lora_gateway.h"
+
+#include <utility>
+
+#include "aether/tele/tele.h"
+
+namespace ae {
+ThreadedLoraGateway::ThreadedLoraGateway(ActionContext action_context,
+                                         ActionTrigger& gateway_trigger,
+                                         DriverFactory factory)
+    : action_context_{action_context},
+      gateway_trigger_{&gateway_trigger},
+      radio_thread_{[this, factory{std::move(factory)}]() {
+        RadioLoop(factory);
+      }} {}
+
+ThreadedLoraGateway::~ThreadedLoraGateway() {
+  stop_.store(true, std::memory_order_release);
+  radio_processor_.get_trigger().Trigger();
+  radio_thread_.join();
+  // the radio thread is gone, nobody completes them
+  for (auto& [id, operation] : operations_) {
+    operation->Stop();
+  }
+  for (auto& [id, operation] : open_operations_) {
+    operation->Reject();
+  }
+}
+
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::Start() {
+  return Forward([](auto& driver) { return driver.Start(); });
+}
+
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::Stop() {
+  return Forward([](auto& driver) { return driver.Stop(); });
+}
+
+ActionPtr<ThreadedLoraGateway::OpenNetworkOperation>
+ThreadedLoraGateway::OpenNetwork(Protocol protocol, std::string const& host,
+                                 std::uint16_t port) {
+  auto open_network_operation =
+      ActionPtr<OpenNetworkOperation>{action_context_};
+  auto const id = next_id_++;
+  auto pushed = PushCommand([this, id, protocol, host, port](auto& driver) {
+    WatchOpen(id, driver.OpenNetwork(protocol, host, port));
+  });
+  if (!pushed) {
+    open_network_operation->Reject();
+    return open_network_operation;
+  }
+  open_operations_.emplace(id, open_network_operation);
+  return open_network_operation;
+}
+
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::CloseNetwork(ConnectionLoraGatewayIndex connect_index) {
+  return Forward([connect_index](auto& driver) {
+    return driver.CloseNetwork(connect_index);
+  });
+}
+
+ActionPtr<ThreadedLoraGateway::WriteOperation> ThreadedLoraGateway::WritePacket(
+    ConnectionLoraGatewayIndex connect_index, DataBuffer const& data) {
+  auto write_operation = ActionPtr<WriteOperation>{action_context_};
+  auto const id = next_id_++;
+  if (!tx_frames_.Push(Frame{id, connect_index, data})) {
+    AE_TELED_ERROR("Radio thread is behind, drop frame to {}",
+                   static_cast<int>(connect_index));
+    ++tx_rejected_;
+    write_operation->Failed();
+    return write_operation;
+  }
+  operations_.emplace(id, write_operation);
+  WakeRadio();
+  return write_operation;
+}
+
+ThreadedLoraGateway::DataEvent::Subscriber ThreadedLoraGateway::data_event() {
+  return EventSubscriber{data_event_};
+}
+
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::Configure(LoraGatewayInit const& lora_gateway_init) {
+  return Forward([lora_gateway_init](auto& driver) {
+    return driver.Configure(lora_gateway_init);
+  });
+}
+
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::SetPowerSaveParam(LoraGatewayPowerSaveParam const& psp) {
+  return Forward(
+      [psp](auto& driver) { return driver.SetPowerSaveParam(psp); });
+}
+
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::PowerOff() {
+  return Forward([](auto& driver) { return driver.PowerOff(); });
+}
+
+void ThreadedLoraGateway::BindDevice(std::uint8_t device_id,
+                                     LoraDeviceAddress const& address) {
+  auto pushed = PushCommand([device_id, address](auto& driver) {
+    driver.BindDevice(device_id, address);
+  });
+  if (!pushed) {
+    AE_TELED_ERROR("Radio thread is behind, device {} is not bound",
+                   static_cast<int>(device_id));
+  }
+}
+
+void ThreadedLoraGateway::Poll() {
+  // nothing is pushed since the previous poll
+  if (!gateway_wake_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  while (auto completion = completions_.Pop()) {
+    Complete(*completion);
+  }
+  while (auto frame = rx_frames_.Pop()) {
+    data_event_.Emit(frame->connect_index, frame->data);
+  }
+  // there is room for the completions waiting on the radio thread
+  if (completion_backlog_pending_.load(std::memory_order_acquire)) {
+    WakeRadio();
+  }
+}
+
+ThreadedLoraGateway::Stats ThreadedLoraGateway::stats() const {
+  return Stats{rx_overruns_.load(std::memory_order_relaxed), tx_rejected_};
+}
+
+template <typename Func>
+ActionPtr<ThreadedLoraGateway::LoraGatewayOperation>
+ThreadedLoraGateway::Forward(Func&& func) {
+  auto operation = ActionPtr<LoraGatewayOperation>{action_context_};
+  auto const id = next_id_++;
+  auto pushed = PushCommand(
+      [this, id, func{std::forward<Func>(func)}](auto& driver) {
+        Watch(id, func(driver));
+      });
+  if (!pushed) {
+    operation->Failed();
+    return operation;
+  }
+  operations_.emplace(id, operation);
+  return operation;
+}
+
+bool ThreadedLoraGateway::PushCommand(Command command) {
+  if (!commands_.Push(std::move(command))) {
+    ++tx_rejected_;
+    return false;
+  }
+  WakeRadio();
+  return true;
+}
+
+void ThreadedLoraGateway::WakeRadio() {
+  // the radio thread has not woken up for the previous push yet
+  if (radio_wake_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  radio_processor_.get_trigger().Trigger();
+}
+
+void ThreadedLoraGateway::Complete(Completion const& completion) {
+  if (auto it = operations_.find(completion.id);
+      it != std::end(operations_)) {
+    auto operation = std::move(it->second);
+    operations_.erase(it);
+    switch (completion.status) {
+      case Status::kResult:
+        operation->Notify();
+        break;
+      case Status::kError:
+        operation->Failed();
+        break;
+      case Status::kStop:
+        operation->Stop();
+        break;
+    }
+    return;
+  }
+  if (auto it = open_operations_.find(completion.id);
+      it != std::end(open_operations_)) {
+    auto operation = std::move(it->second);
+    open_operations_.erase(it);
+    if (completion.status == Status::kResult) {
+      operation->SetValue(completion.connect_index);
+    } else {
+      operation->Reject();
+    }
+  }
+}
+
+void ThreadedLoraGateway::RadioLoop(DriverFactory const& factory) {
+  driver_ = factory(ActionContext{radio_processor_});
+  data_sub_ = driver_->data_event().Subscribe(
+      [this](auto connect_index, auto const& data) {
+        if (!rx_frames_.Push(Frame{{}, connect_index, data})) {
+          rx_overruns_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        WakeGateway();
+      });
+
+  while (!stop_.load(std::memory_order_acquire)) {
+    ServeGateway();
+    auto next_time = radio_processor_.Update(Now());
+    FlushCompletions();
+    radio_processor_.get_trigger().WaitUntil(next_time);
+  }
+
+  data_sub_.Reset();
+  driver_.reset();
+}
+
+void ThreadedLoraGateway::ServeGateway() {
+  radio_wake_.store(false, std::memory_order_release);
+  while (auto command = commands_.Pop()) {
+    (*command)(*driver_);
+  }
+  while (auto frame = tx_frames_.Pop()) {
+    Watch(frame->id, driver_->WritePacket(frame->connect_index, frame->data));
+  }
+}
+
+void ThreadedLoraGateway::Watch(OperationId id,
+                                ActionPtr<LoraGatewayOperation> operation) {
+  // driver has nothing to do
+  if (!operation) {
+    PushCompletion(Completion{id, Status::kResult, {}});
+    return;
+  }
+  operation->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, id]() {
+        PushCompletion(Completion{id, Status::kResult, {}});
+      }},
+      OnError{
+          [this, id]() { PushCompletion(Completion{id, Status::kError, {}}); }},
+      OnStop{
+          [this, id]() { PushCompletion(Completion{id, Status::kStop, {}}); }},
+  });
+}
+
+void ThreadedLoraGateway::WatchOpen(
+    OperationId id, ActionPtr<OpenNetworkOperation> operation) {
+  if (!operation) {
+    PushCompletion(Completion{id, Status::kError, {}});
+    return;
+  }
+  operation->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, id](auto const& action) {
+        PushCompletion(Completion{id, Status::kResult, action.value()});
+      }},
+      OnError{
+          [this, id]() { PushCompletion(Completion{id, Status::kError, {}}); }},
+      OnStop{
+          [this, id]() { PushCompletion(Completion{id, Status::kStop, {}}); }},
+  });
+}
+
+void ThreadedLoraGateway::PushCompletion(Completion const& completion) {
+  // keep the order of completions
+  if (!completion_backlog_.empty() ||
+      !completions_.Push(Completion{completion})) {
+    completion_backlog_.push_back(completion);
+    completion_backlog_pending_.store(true, std::memory_order_release);
+    return;
+  }
+  WakeGateway();
+}
+
+void ThreadedLoraGateway::FlushCompletions() {
+  auto pushed = false;
+  while (!completion_backlog_.empty() &&
+         completions_.Push(Completion{completion_backlog_.front()})) {
+    completion_backlog_.pop_front();
+    pushed = true;
+  }
+  completion_backlog_pending_.store(!completion_backlog_.empty(),
+                                    std::memory_order_release);
+  if (pushed) {
+    WakeGateway();
+  }
+}
+
+void ThreadedLoraGateway::WakeGateway() {
+  if (gateway_wake_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  // the gateway loop polls on wake up, only the trigger is thread safe
+  gateway_trigger_->Trigger();
+}
+}  // namespace ae
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LORA_GATEWAYS_THREADED_LORA_GATEWAY_H_
+#define LORA_GATEWAYS_THREADED_LORA_GATEWAY_H_
+
+#include <map>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "gateway/spsc_ring.h"
+
+#include "lora_gateways/ilora_gateway_driver.h"
+
+namespace ae {
+/**
+ * \brief Runs a gateway driver on its own radio thread.
+ * The driver and its serial port live on an action processor of the radio
+ * thread, so a burst of work on the gateway loop does not delay the serial
+ * port. Frames and operations are passed between the threads through bounded
+ * lock-free single producer single consumer rings, the receiving side is
+ * woken with the trigger of its action processor. The radio thread does not
+ * touch the actions of the gateway loop, the gateway loop calls Poll on each
+ * update to take the frames and the completions. Operations of this driver
+ * complete on the gateway loop.
+ */
+class ThreadedLoraGateway final : public ILoraGatewayDriver {
+ public:
+  using DriverFactory =
+      std::function<std::unique_ptr<ILoraGatewayDriver>(ActionContext)>;
+
+  static constexpr std::size_t kFrameRingSize = 64;
+  static constexpr std::size_t kCommandRingSize = 32;
+  static constexpr std::size_t kCompletionRingSize = 128;
+
+  struct Stats {
+    // received frames dropped because the gateway loop is behind
+    std::size_t rx_overruns;
+    // frames and operations rejected because the radio thread is behind
+    std::size_t tx_rejected;
+  };
+
+  /**
+   * \brief The driver is created by factory on the radio thread.
+   * gateway_trigger is the trigger of the action processor of action_context.
+   */
+  ThreadedLoraGateway(ActionContext action_context,
+                      ActionTrigger& gateway_trigger, DriverFactory factory);
+  ~ThreadedLoraGateway() override;
+
+  ActionPtr<LoraGatewayOperation> Start() override;
+  ActionPtr<LoraGatewayOperation> Stop() override;
+  ActionPtr<OpenNetworkOperation> OpenNetwork(Protocol protocol,
+                                              std::string const& host,
+                                              std::uint16_t port) override;
+  ActionPtr<LoraGatewayOperation> CloseNetwork(
+      ConnectionLoraGatewayIndex connect_index) override;
+  ActionPtr<WriteOperation> WritePacket(
+      ConnectionLoraGatewayIndex connect_index,
+      DataBuffer const& data) override;
+
+  DataEvent::Subscriber data_event() override;
+
+  ActionPtr<LoraGatewayOperation> Configure(
+      LoraGatewayInit const& lora_gateway_init) override;
+  ActionPtr<LoraGatewayOperation> SetPowerSaveParam(
+      LoraGatewayPowerSaveParam const& psp) override;
+  ActionPtr<LoraGatewayOperation> PowerOff() override;
+  void BindDevice(std::uint8_t device_id,
+                  LoraDeviceAddress const& address) override;
+
+  /**
+   * \brief Emit the received frames and complete the operations finished on
+   * the radio thread, call it on the gateway loop before each update.
+   */
+  void Poll();
+
+  Stats stats() const;
+
+ private:
+  using OperationId = std::uint32_t;
+  using Command = std::function<void(ILoraGatewayDriver& driver)>;
+
+  enum class Status : std::uint8_t {
+    kResult,
+    kError,
+    kStop,
+  };
+
+  struct Frame {
+    OperationId id;
+    ConnectionLoraGatewayIndex connect_index;
+    DataBuffer data;
+  };
+
+  struct Completion {
+    OperationId id;
+    Status status;
+    ConnectionLoraGatewayIndex connect_index;
+  };
+
+  // gateway thread
+  template <typename Func>
+  ActionPtr<LoraGatewayOperation> Forward(Func&& func);
+  bool PushCommand(Command command);
+  void WakeRadio();
+  void Complete(Completion const& completion);
+
+  // radio thread
+  void RadioLoop(DriverFactory const& factory);
+  void ServeGateway();
+  void Watch(OperationId id, ActionPtr<LoraGatewayOperation> operation);
+  void WatchOpen(OperationId id, ActionPtr<OpenNetworkOperation> operation);
+  void PushCompletion(Completion const& completion);
+  void FlushCompletions();
+  void WakeGateway();
+
+  ActionContext action_context_;
+  ActionTrigger* gateway_trigger_;
+  DataEvent data_event_;
+  OperationId next_id_{};
+  std::map<OperationId, ActionPtr<LoraGatewayOperation>> operations_;
+  std::map<OperationId, ActionPtr<OpenNetworkOperation>> open_operations_;
+  std::size_t tx_rejected_{};
+
+  // gateway to radio
+  gw::SpscRing<Command, kCommandRingSize> commands_;
+  gw::SpscRing<Frame, kFrameRingSize> tx_frames_;
+  // radio to gateway
+  gw::SpscRing<Frame, kFrameRingSize> rx_frames_;
+  gw::SpscRing<Completion, kCompletionRingSize> completions_;
+  // set by the producer before the trigger, cleared by the woken consumer
+  std::atomic_bool radio_wake_{};
+  std::atomic_bool gateway_wake_{};
+  std::atomic_bool completion_backlog_pending_{};
+  std::atomic_bool stop_{};
+  std::atomic<std::size_t> rx_overruns_{};
+
+  // owned by the radio thread
+  ActionProcessor radio_processor_;
+  std::unique_ptr<ILoraGatewayDriver> driver_;
+  Subscription data_sub_;
+  // completions not fitted into the ring
+  std::deque<Completion> completion_backlog_;
+
+  std::thread radio_thread_;
+};
+}  // namespace ae
+
+#endif  // LORA_GATEWAYS_THREADED_LORA_GATEWAY_H_